@@ -0,0 +1,150 @@
+#include "Corpus.h"
+#include "UltraUtilities/Random.h"
+
+using namespace UU;
+
+const char* GetCorpusKindName(CorpusKind kind)
+{
+	switch (kind)
+	{
+	case CorpusKind::TEXT:
+		return "text";
+	case CorpusKind::BINARY:
+		return "binary";
+	case CorpusKind::REPETITIVE:
+		return "repetitive";
+	case CorpusKind::RANDOM:
+		return "random";
+	default:
+		return "unknown";
+	}
+}
+
+static void GenerateText(XorShiftRandom& random, unsigned int size, DArray<char>& data)
+{
+	// Make up a vocabulary out of syllables.  Words early in the list get used far more often than those late in it.
+	static const char* syllableArray[] = { "ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "an", "el", "or", "um", "th", "st", "re", "in" };
+	const unsigned int numSyllables = sizeof(syllableArray) / sizeof(syllableArray[0]);
+
+	DArray<DArray<char>> vocabulary;
+	for (unsigned int i = 0; i < 500; i++)
+	{
+		DArray<char> word;
+		unsigned int numWordSyllables = random.GetRandomInteger(1, 4);
+		for (unsigned int j = 0; j < numWordSyllables; j++)
+			for (const char* syllable = syllableArray[random.GetRandomInteger(0, numSyllables - 1)]; *syllable; syllable++)
+				word.Push(*syllable);
+
+		vocabulary.Push(word);
+	}
+
+	bool startOfSentence = true;
+	while (data.GetSize() < size)
+	{
+		const DArray<char>& word = vocabulary[random.GetRandomInteger(0, random.GetRandomInteger(0, vocabulary.GetSize() - 1))];
+		for (unsigned int i = 0; i < word.GetSize(); i++)
+			data.Push((i == 0 && startOfSentence) ? word[i] - 'a' + 'A' : word[i]);
+
+		startOfSentence = random.GetRandomInteger(0, 11) == 0;
+		if (startOfSentence)
+			data.Push('.');
+		else if (random.GetRandomInteger(0, 15) == 0)
+			data.Push(',');
+
+		data.Push((startOfSentence && random.GetRandomInteger(0, 7) == 0) ? '\n' : ' ');
+	}
+}
+
+static void GenerateBinary(XorShiftRandom& random, unsigned int size, DArray<char>& data)
+{
+	// These are like rows of a table of 32-byte records: an ID, a time stamp, a reading, a type and a name.
+	static const char* nameArray[] = { "pump-01\0", "pump-02\0", "valve-a\0", "valve-b\0", "sensor9\0" };
+
+	unsigned int id = 1000;
+	unsigned int timeStamp = 1700000000;
+	float reading = 20.0f;
+
+	while (data.GetSize() < size)
+	{
+		char record[32];
+		UU_MEMSET(record, 0, sizeof(record));
+
+		timeStamp += random.GetRandomInteger(1, 5);
+		reading += float(random.GetRandomInteger(0, 200)) / 100.0f - 1.0f;
+		unsigned short type = (unsigned short)random.GetRandomInteger(0, 3);
+
+		UU_MEMCPY(record, &id, 4);
+		UU_MEMCPY(record + 4, &timeStamp, 4);
+		UU_MEMCPY(record + 8, &reading, 4);
+		UU_MEMCPY(record + 12, &type, 2);
+		UU_MEMCPY(record + 24, nameArray[random.GetRandomInteger(0, 4)], 8);
+		id++;
+
+		for (unsigned int i = 0; i < sizeof(record); i++)
+			data.Push(record[i]);
+	}
+}
+
+static void GenerateRepetitive(XorShiftRandom& random, unsigned int size, DArray<char>& data)
+{
+	static const char* phraseArray[] =
+	{
+		"<entry key=\"alpha\" value=\"1\"/>\n",
+		"<entry key=\"beta\" value=\"2\"/>\n",
+		"<entry key=\"gamma\" value=\"3\"/>\n",
+		"<!-- generated -->\n",
+		"<group>\n",
+		"</group>\n"
+	};
+
+	while (data.GetSize() < size)
+	{
+		if (random.GetRandomInteger(0, 9) == 0)
+		{
+			char byte = (char)random.GetRandomInteger(0, 255);
+			unsigned int runLength = random.GetRandomInteger(10, 200);
+			for (unsigned int i = 0; i < runLength; i++)
+				data.Push(byte);
+		}
+		else
+		{
+			for (const char* phrase = phraseArray[random.GetRandomInteger(0, 5)]; *phrase; phrase++)
+				data.Push(*phrase);
+		}
+	}
+}
+
+static void GenerateRandom(XorShiftRandom& random, unsigned int size, DArray<char>& data)
+{
+	while (data.GetSize() < size)
+		data.Push((char)random.GetRandomInteger(0, 255));
+}
+
+void GenerateCorpus(CorpusKind kind, unsigned int size, DArray<char>& data)
+{
+	XorShiftRandom random;
+	random.SetSeed(0x2545F491 + (unsigned int)kind);
+
+	data.SetSize(0);
+	data.SetCapacity(size + 1024);
+
+	switch (kind)
+	{
+	case CorpusKind::TEXT:
+		GenerateText(random, size, data);
+		break;
+	case CorpusKind::BINARY:
+		GenerateBinary(random, size, data);
+		break;
+	case CorpusKind::REPETITIVE:
+		GenerateRepetitive(random, size, data);
+		break;
+	case CorpusKind::RANDOM:
+		GenerateRandom(random, size, data);
+		break;
+	default:
+		break;
+	}
+
+	data.SetSize(size);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "UltraUtilities/Containers/DArray.hpp"
+
+/**
+ * These are the kinds of data the benchmarks are run over.  Together they cover
+ * the range from very compressible to not compressible at all.
+ */
+enum class CorpusKind
+{
+	TEXT,			///< Sentences of words drawn from a small, skewed vocabulary.
+	BINARY,			///< Fixed-size records with slowly changing numeric fields.
+	REPETITIVE,		///< A handful of phrases repeated over and over, with runs of one byte.
+	RANDOM,			///< Uniformly random bytes.
+
+	NUM_KINDS
+};
+
+/**
+ * Return the name of the given kind of corpus, as it appears in the results.
+ */
+const char* GetCorpusKindName(CorpusKind kind);
+
+/**
+ * Fill the given array with the given number of bytes of the given kind of data.
+ * The same kind and size always make the same data, so results can be compared
+ * from one run to the next.
+ */
+void GenerateCorpus(CorpusKind kind, unsigned int size, UU::DArray<char>& data);
\ No newline at end of file
@@ -0,0 +1,296 @@
+#include "Corpus.h"
+#include "MemoryTracker.h"
+#include "UltraUtilities/Compression/DeflateCompression.h"
+#include "UltraUtilities/Compression/HuffmanCompression.h"
+#include "UltraUtilities/Compression/LZ77Compression.h"
+#include "UltraUtilities/Compression/ParallelCompression.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined _WIN32
+#	include <time.h>
+#endif
+
+using namespace UU;
+
+// Each measurement is repeated until it has taken at least this long, and the fastest time is kept.
+#define UU_BENCHMARK_DEFAULT_MIN_SECONDS		0.5
+
+#define UU_BENCHMARK_MAX_SIZES					16
+
+enum class OutputFormat
+{
+	TEXT,
+	CSV,
+	JSON
+};
+
+struct Codec
+{
+	const char* name;
+	Compression* compression;
+};
+
+struct Result
+{
+	const char* codecName;
+	const char* corpusName;
+	unsigned int originalSize;
+	unsigned int compressedSize;
+	double compressSeconds;
+	double decompressSeconds;
+	unsigned long long peakHeapBytes;
+};
+
+static double GetTimeSeconds()
+{
+#if defined _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return double(counter.QuadPart) / double(frequency.QuadPart);
+#else
+	timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return double(time.tv_sec) + double(time.tv_nsec) * 1e-9;
+#endif
+}
+
+static double CalcMegabytesPerSecond(unsigned int size, double seconds)
+{
+	return (seconds > 0.0) ? double(size) / (1024.0 * 1024.0) / seconds : 0.0;
+}
+
+static void PrintUsage()
+{
+	fprintf(stderr,
+		"Usage: Benchmark [options]\n"
+		"  --format text|csv|json   How to print the results.  The default is text.\n"
+		"  --sizes N,N,...          Corpus sizes in bytes.  The default is 65536,1048576,8388608.\n"
+		"  --codec NAME             Only run codecs whose names contain NAME.\n"
+		"  --corpus NAME            Only run over corpora whose names contain NAME.\n"
+		"  --min-time SECONDS       Repeat each measurement for at least this long.  The default is 0.5.\n");
+}
+
+// Compress and decompress the given data as many times as it takes to get a steady time, and make sure it comes back the same.
+static bool RunBenchmark(Compression* compression, const DArray<char>& originalData, double minSeconds, Result& result)
+{
+	DArray<char> compressedData(originalData.GetSize() * 2 + 64 * 1024);
+	DArray<char> decompressedData(originalData.GetSize() + 1);
+
+	unsigned long long heapBytesBefore = GetHeapBytesInUse();
+	ResetPeakHeapBytes();
+
+	result.originalSize = originalData.GetSize();
+	result.compressedSize = 0;
+	result.compressSeconds = 0.0;
+	result.decompressSeconds = 0.0;
+
+	double totalSeconds = 0.0;
+	while (totalSeconds < minSeconds || result.compressSeconds == 0.0)
+	{
+		MemoryBufferStream inputStream((char*)originalData.GetBuffer(), originalData.GetSize(), true);
+		MemoryBufferStream outputStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+
+		double startSeconds = GetTimeSeconds();
+		if (!compression->Compress(&inputStream, &outputStream))
+			return false;
+		double seconds = GetTimeSeconds() - startSeconds;
+
+		totalSeconds += seconds;
+		if (result.compressSeconds == 0.0 || seconds < result.compressSeconds)
+			result.compressSeconds = seconds;
+
+		result.compressedSize = outputStream.GetSize();
+	}
+
+	totalSeconds = 0.0;
+	while (totalSeconds < minSeconds || result.decompressSeconds == 0.0)
+	{
+		MemoryBufferStream inputStream(compressedData.GetBuffer(), result.compressedSize, true);
+		MemoryBufferStream outputStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+
+		double startSeconds = GetTimeSeconds();
+		if (!compression->Decompress(&inputStream, &outputStream))
+			return false;
+		double seconds = GetTimeSeconds() - startSeconds;
+
+		totalSeconds += seconds;
+		if (result.decompressSeconds == 0.0 || seconds < result.decompressSeconds)
+			result.decompressSeconds = seconds;
+
+		if (outputStream.GetSize() != originalData.GetSize())
+			return false;
+	}
+
+	if (::memcmp(originalData.GetBuffer(), decompressedData.GetBuffer(), originalData.GetSize()) != 0)
+		return false;
+
+	result.peakHeapBytes = GetPeakHeapBytes() - heapBytesBefore;
+	return true;
+}
+
+static void PrintHeader(OutputFormat format)
+{
+	switch (format)
+	{
+	case OutputFormat::TEXT:
+		printf("%-16s %-12s %12s %12s %8s %14s %16s %14s\n", "codec", "corpus", "size", "compressed", "ratio", "compress MB/s", "decompress MB/s", "peak heap KB");
+		break;
+	case OutputFormat::CSV:
+		printf("codec,corpus,size,compressed_size,ratio,compress_mb_per_s,decompress_mb_per_s,peak_heap_bytes\n");
+		break;
+	case OutputFormat::JSON:
+		printf("[");
+		break;
+	}
+}
+
+static void PrintResult(OutputFormat format, const Result& result, bool first)
+{
+	double ratio = (result.compressedSize > 0) ? double(result.originalSize) / double(result.compressedSize) : 0.0;
+	double compressSpeed = CalcMegabytesPerSecond(result.originalSize, result.compressSeconds);
+	double decompressSpeed = CalcMegabytesPerSecond(result.originalSize, result.decompressSeconds);
+
+	switch (format)
+	{
+	case OutputFormat::TEXT:
+		printf("%-16s %-12s %12u %12u %8.3f %14.1f %16.1f %14llu\n", result.codecName, result.corpusName, result.originalSize, result.compressedSize, ratio, compressSpeed, decompressSpeed, result.peakHeapBytes / 1024);
+		break;
+	case OutputFormat::CSV:
+		printf("%s,%s,%u,%u,%.4f,%.2f,%.2f,%llu\n", result.codecName, result.corpusName, result.originalSize, result.compressedSize, ratio, compressSpeed, decompressSpeed, result.peakHeapBytes);
+		break;
+	case OutputFormat::JSON:
+		printf("%s\n  {\"codec\": \"%s\", \"corpus\": \"%s\", \"size\": %u, \"compressed_size\": %u, \"ratio\": %.4f, \"compress_mb_per_s\": %.2f, \"decompress_mb_per_s\": %.2f, \"peak_heap_bytes\": %llu}",
+			first ? "" : ",", result.codecName, result.corpusName, result.originalSize, result.compressedSize, ratio, compressSpeed, decompressSpeed, result.peakHeapBytes);
+		break;
+	}
+
+	fflush(stdout);
+}
+
+static void PrintFooter(OutputFormat format)
+{
+	if (format == OutputFormat::JSON)
+		printf("\n]\n");
+}
+
+int main(int argc, char** argv)
+{
+	OutputFormat format = OutputFormat::TEXT;
+	unsigned int sizeArray[UU_BENCHMARK_MAX_SIZES] = { 64 * 1024, 1024 * 1024, 8 * 1024 * 1024 };
+	unsigned int numSizes = 3;
+	const char* codecFilter = "";
+	const char* corpusFilter = "";
+	double minSeconds = UU_BENCHMARK_DEFAULT_MIN_SECONDS;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+
+		if (::strcmp(arg, "--format") == 0 && value)
+		{
+			if (::strcmp(value, "text") == 0)
+				format = OutputFormat::TEXT;
+			else if (::strcmp(value, "csv") == 0)
+				format = OutputFormat::CSV;
+			else if (::strcmp(value, "json") == 0)
+				format = OutputFormat::JSON;
+			else
+			{
+				PrintUsage();
+				return 2;
+			}
+		}
+		else if (::strcmp(arg, "--sizes") == 0 && value)
+		{
+			numSizes = 0;
+			for (const char* size = value; *size && numSizes < UU_BENCHMARK_MAX_SIZES;)
+			{
+				char* sizeEnd = nullptr;
+				sizeArray[numSizes] = (unsigned int)::strtoul(size, &sizeEnd, 10);
+				if (sizeEnd == size || sizeArray[numSizes] == 0)
+				{
+					PrintUsage();
+					return 2;
+				}
+
+				numSizes++;
+				size = (*sizeEnd == ',') ? sizeEnd + 1 : sizeEnd;
+			}
+		}
+		else if (::strcmp(arg, "--codec") == 0 && value)
+			codecFilter = value;
+		else if (::strcmp(arg, "--corpus") == 0 && value)
+			corpusFilter = value;
+		else if (::strcmp(arg, "--min-time") == 0 && value)
+			minSeconds = ::atof(value);
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+
+		i++;
+	}
+
+	HuffmanCompression huffmanCompression;
+	LZ77Compression lz77Compression(32 * 1024);
+	DeflateCompression deflateCompression1(1);
+	DeflateCompression deflateCompression6(6);
+	DeflateCompression deflateCompression9(9);
+	ParallelCompression parallelDeflateCompression(&deflateCompression6);
+
+	Codec codecArray[] =
+	{
+		{ "huffman", &huffmanCompression },
+		{ "lz77", &lz77Compression },
+		{ "deflate-1", &deflateCompression1 },
+		{ "deflate-6", &deflateCompression6 },
+		{ "deflate-9", &deflateCompression9 },
+		{ "parallel-deflate", &parallelDeflateCompression }
+	};
+
+	PrintHeader(format);
+
+	bool first = true;
+	bool failed = false;
+	DArray<char> originalData;
+
+	for (unsigned int i = 0; i < (unsigned int)CorpusKind::NUM_KINDS; i++)
+	{
+		CorpusKind kind = (CorpusKind)i;
+		const char* corpusName = GetCorpusKindName(kind);
+		if (!::strstr(corpusName, corpusFilter))
+			continue;
+
+		for (unsigned int j = 0; j < numSizes; j++)
+		{
+			GenerateCorpus(kind, sizeArray[j], originalData);
+
+			for (const Codec& codec : codecArray)
+			{
+				if (!::strstr(codec.name, codecFilter))
+					continue;
+
+				Result result;
+				result.codecName = codec.name;
+				result.corpusName = corpusName;
+				if (!RunBenchmark(codec.compression, originalData, minSeconds, result))
+				{
+					fprintf(stderr, "%s failed to round-trip %u bytes of %s data.\n", codec.name, sizeArray[j], corpusName);
+					failed = true;
+					continue;
+				}
+
+				PrintResult(format, result, first);
+				first = false;
+			}
+		}
+	}
+
+	PrintFooter(format);
+
+	return failed ? 1 : 0;
+}
\ No newline at end of file
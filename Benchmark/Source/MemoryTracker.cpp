@@ -0,0 +1,84 @@
+#include "MemoryTracker.h"
+#include "UltraUtilities/Threading/Atomic.h"
+#include <new>
+#include <stdlib.h>
+
+using namespace UU;
+
+// Each allocation is preceded by its size.  This keeps the memory after it as aligned as malloc's.
+#define UU_MEMORY_TRACKER_HEADER_SIZE		16
+
+static Atomic<unsigned long long> heapBytesInUse(0);
+static Atomic<unsigned long long> peakHeapBytes(0);
+
+static void* TrackedAllocate(size_t size)
+{
+	char* memory = (char*)::malloc(size + UU_MEMORY_TRACKER_HEADER_SIZE);
+	if (!memory)
+		throw std::bad_alloc();
+
+	*(size_t*)memory = size;
+
+	unsigned long long inUse = heapBytesInUse.FetchAdd(size, MemoryOrder::RELAXED) + size;
+	unsigned long long peak = peakHeapBytes.Load(MemoryOrder::RELAXED);
+	while (inUse > peak && !peakHeapBytes.CompareExchange(peak, inUse, MemoryOrder::RELAXED))
+	{
+	}
+
+	return memory + UU_MEMORY_TRACKER_HEADER_SIZE;
+}
+
+static void TrackedFree(void* pointer)
+{
+	if (!pointer)
+		return;
+
+	char* memory = (char*)pointer - UU_MEMORY_TRACKER_HEADER_SIZE;
+	heapBytesInUse.FetchAdd(0 - (unsigned long long)*(size_t*)memory, MemoryOrder::RELAXED);
+	::free(memory);
+}
+
+void* operator new(size_t size)
+{
+	return TrackedAllocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return TrackedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	TrackedFree(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+	TrackedFree(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+	TrackedFree(pointer);
+}
+
+unsigned long long GetHeapBytesInUse()
+{
+	return heapBytesInUse.Load(MemoryOrder::RELAXED);
+}
+
+unsigned long long GetPeakHeapBytes()
+{
+	return peakHeapBytes.Load(MemoryOrder::RELAXED);
+}
+
+void ResetPeakHeapBytes()
+{
+	peakHeapBytes.Store(heapBytesInUse.Load(MemoryOrder::RELAXED), MemoryOrder::RELAXED);
+}
\ No newline at end of file
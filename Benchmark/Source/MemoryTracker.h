@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * The benchmark program replaces the global operator new and operator delete
+ * with versions that keep count of how much heap memory is in use, and of the
+ * most that has been in use at once.  Everything in the library that allocates
+ * goes through them, from any thread.
+ */
+
+/**
+ * Return the number of bytes currently allocated.
+ */
+unsigned long long GetHeapBytesInUse();
+
+/**
+ * Return the most bytes that have been allocated at once since the last call to @ref ResetPeakHeapBytes.
+ */
+unsigned long long GetPeakHeapBytes();
+
+/**
+ * Start tracking the peak over again from the amount currently in use.
+ */
+void ResetPeakHeapBytes();
\ No newline at end of file
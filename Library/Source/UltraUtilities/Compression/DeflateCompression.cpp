@@ -0,0 +1,361 @@
+#include "UltraUtilities/Compression/DeflateCompression.h"
+#include "UltraUtilities/Compression/HuffmanCode.h"
+#include "UltraUtilities/Compression/HuffmanDecodeTable.h"
+#include "UltraUtilities/Compression/LZ77MatchFinder.h"
+
+using namespace UU;
+
+// Match lengths and distances are coded as a range followed by extra bits for the offset into the range.
+static const unsigned short deflateLengthBase[29] =
+{
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const unsigned char deflateLengthExtraBits[29] =
+{
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const unsigned short deflateDistanceBase[30] =
+{
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+
+static const unsigned char deflateDistanceExtraBits[30] =
+{
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+// Literals and lengths share a code.  Lengths come after the literals and the unused end-of-block symbol.
+#define UU_DEFLATE_FIRST_LENGTH_SYMBOL		257
+
+// Matches are stored as tokens with this bit set, the length in the bits above 16 and the distance below.
+#define UU_DEFLATE_MATCH_TOKEN				0x80000000
+
+// These map lengths and distances to their ranges without searching.
+class DeflateRangeTables
+{
+public:
+	DeflateRangeTables()
+	{
+		for (unsigned int i = 0; i < 29; i++)
+			for (unsigned int length = deflateLengthBase[i]; length < deflateLengthBase[i] + (1U << deflateLengthExtraBits[i]) && length <= UU_DEFLATE_MAX_MATCH_LENGTH; length++)
+				this->lengthRangeArray[length - 3] = (unsigned char)i;
+
+		// Small distances are looked up directly, and large ones by their top bits, since their ranges are at least 128 wide.
+		for (unsigned int i = 0; i < 30; i++)
+		{
+			for (unsigned int distance = deflateDistanceBase[i]; distance < deflateDistanceBase[i] + (1U << deflateDistanceExtraBits[i]); distance++)
+			{
+				if (distance - 1 < 256)
+					this->distanceRangeArray[distance - 1] = (unsigned char)i;
+				else
+					this->distanceRangeArray[256 + ((distance - 1) >> 7)] = (unsigned char)i;
+			}
+		}
+	}
+
+	unsigned int GetLengthRange(unsigned int length) const
+	{
+		return this->lengthRangeArray[length - 3];
+	}
+
+	unsigned int GetDistanceRange(unsigned int distance) const
+	{
+		return (distance - 1 < 256) ? this->distanceRangeArray[distance - 1] : this->distanceRangeArray[256 + ((distance - 1) >> 7)];
+	}
+
+	static const DeflateRangeTables& Get()
+	{
+		static DeflateRangeTables tables;
+		return tables;
+	}
+
+private:
+	unsigned char lengthRangeArray[256];
+	unsigned char distanceRangeArray[512];
+};
+
+//----------------------------- DeflateCompression -----------------------------
+
+DeflateCompression::DeflateCompression(unsigned int level /*= UU_DEFLATE_DEFAULT_LEVEL*/, unsigned int blockSize /*= UU_DEFLATE_BLOCK_SIZE*/)
+{
+	this->level = level;
+	this->blockSize = (blockSize == 0) ? UU_DEFLATE_BLOCK_SIZE : blockSize;
+}
+
+/*virtual*/ DeflateCompression::~DeflateCompression()
+{
+}
+
+/*virtual*/ bool DeflateCompression::Compress(ByteStream* inputStream, ByteStream* outputStream)
+{
+	if (inputStream == outputStream)
+		return false;
+
+	// The buffer holds the end of the previous block, for matches to refer back to, followed by the current block.
+	DArray<unsigned char> buffer(UU_DEFLATE_WINDOW_SIZE + this->blockSize);
+	unsigned int historySize = 0;
+
+	const LZ77LevelConfig& config = GetLZ77LevelConfig(this->level);
+	LZ77MatchFinder matchFinder(UU_DEFLATE_WINDOW_SIZE, config.maxChainLength, config.niceLength);
+
+	DArray<unsigned int> tokenArray;
+	BitStream outputBitStream(outputStream);
+
+	while (true)
+	{
+		unsigned int blockSize = 0;
+		while (blockSize < this->blockSize)
+		{
+			unsigned int numBytesRead = inputStream->ReadBytes((char*)buffer.GetBuffer() + historySize + blockSize, this->blockSize - blockSize);
+			if (numBytesRead == 0)
+				break;
+
+			blockSize += numBytesRead;
+		}
+
+		if (!outputBitStream.WriteAllBits(blockSize))
+			return false;
+
+		if (blockSize == 0)
+			break;
+
+		matchFinder.Reset(buffer.GetBuffer(), historySize + blockSize);
+		if (!this->CompressBlock(&matchFinder, config.lazy, historySize, blockSize, tokenArray, &outputBitStream))
+			return false;
+
+		if (!outputBitStream.Flush())
+			return false;
+
+		unsigned int totalSize = historySize + blockSize;
+		historySize = UU_MIN(totalSize, UU_DEFLATE_WINDOW_SIZE);
+		UU_MEMMOVE(buffer.GetBuffer(), buffer.GetBuffer() + totalSize - historySize, historySize);
+	}
+
+	if (!outputBitStream.Flush())
+		return false;
+
+	return true;
+}
+
+bool DeflateCompression::CompressBlock(LZ77MatchFinder* matchFinder, bool lazy, unsigned int historySize, unsigned int blockSize, DArray<unsigned int>& tokenArray, BitStream* outputBitStream)
+{
+	const DeflateRangeTables& rangeTables = DeflateRangeTables::Get();
+
+	unsigned int literalLengthFrequencyArray[UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS];
+	unsigned int distanceFrequencyArray[UU_DEFLATE_NUM_DISTANCE_SYMBOLS];
+	UU_MEMSET(literalLengthFrequencyArray, 0, sizeof(literalLengthFrequencyArray));
+	UU_MEMSET(distanceFrequencyArray, 0, sizeof(distanceFrequencyArray));
+
+	// The whole block has to be parsed before its codes can be made, so the tokens are held onto until then.
+	tokenArray.SetSize(0);
+	if (tokenArray.GetCapacity() < blockSize)
+		tokenArray.SetCapacity(blockSize);
+
+	matchFinder->Parse(historySize, historySize + blockSize, UU_DEFLATE_MAX_MATCH_LENGTH, lazy,
+		[&](unsigned char literal) -> bool
+		{
+			tokenArray.Push(literal);
+			literalLengthFrequencyArray[literal]++;
+			return true;
+		},
+		[&](unsigned int distance, unsigned int length) -> bool
+		{
+			tokenArray.Push(UU_DEFLATE_MATCH_TOKEN | (length << 16) | distance);
+			literalLengthFrequencyArray[UU_DEFLATE_FIRST_LENGTH_SYMBOL + rangeTables.GetLengthRange(length)]++;
+			distanceFrequencyArray[rangeTables.GetDistanceRange(distance)]++;
+			return true;
+		});
+
+	unsigned char literalLengthCodeLengthArray[UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS];
+	if (!CalcHuffmanCodeLengths(literalLengthFrequencyArray, UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS, UU_HUFFMAN_MAX_CODE_LENGTH, literalLengthCodeLengthArray))
+		return false;
+
+	unsigned char distanceCodeLengthArray[UU_DEFLATE_NUM_DISTANCE_SYMBOLS];
+	if (!CalcHuffmanCodeLengths(distanceFrequencyArray, UU_DEFLATE_NUM_DISTANCE_SYMBOLS, UU_HUFFMAN_MAX_CODE_LENGTH, distanceCodeLengthArray))
+		return false;
+
+	unsigned int literalLengthCodeArray[UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS];
+	if (!CalcCanonicalHuffmanCodes(literalLengthCodeLengthArray, UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS, literalLengthCodeArray))
+		return false;
+
+	unsigned int distanceCodeArray[UU_DEFLATE_NUM_DISTANCE_SYMBOLS];
+	if (!CalcCanonicalHuffmanCodes(distanceCodeLengthArray, UU_DEFLATE_NUM_DISTANCE_SYMBOLS, distanceCodeArray))
+		return false;
+
+	for (unsigned int i = 0; i < UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS; i++)
+		if (!outputBitStream->WriteBitsFast(literalLengthCodeLengthArray[i], 4))
+			return false;
+
+	for (unsigned int i = 0; i < UU_DEFLATE_NUM_DISTANCE_SYMBOLS; i++)
+		if (!outputBitStream->WriteBitsFast(distanceCodeLengthArray[i], 4))
+			return false;
+
+	for (unsigned int i = 0; i < tokenArray.GetSize(); i++)
+	{
+		unsigned int token = tokenArray[i];
+		if ((token & UU_DEFLATE_MATCH_TOKEN) == 0)
+		{
+			unsigned int code = literalLengthCodeArray[token];
+			if (!outputBitStream->WriteBitsFast(code & 0xFFFF, code >> 16))
+				return false;
+
+			continue;
+		}
+
+		// Each of these makes at most 20 or 28 bits, so each goes out in a single write.
+		unsigned int length = (token >> 16) & 0x1FF;
+		unsigned int lengthRange = rangeTables.GetLengthRange(length);
+		unsigned int code = literalLengthCodeArray[UU_DEFLATE_FIRST_LENGTH_SYMBOL + lengthRange];
+		unsigned int codeLength = code >> 16;
+		unsigned long long bits = (code & 0xFFFF) | ((unsigned long long)(length - deflateLengthBase[lengthRange]) << codeLength);
+		if (!outputBitStream->WriteBitsFast(bits, codeLength + deflateLengthExtraBits[lengthRange]))
+			return false;
+
+		unsigned int distance = token & 0xFFFF;
+		unsigned int distanceRange = rangeTables.GetDistanceRange(distance);
+		code = distanceCodeArray[distanceRange];
+		codeLength = code >> 16;
+		bits = (code & 0xFFFF) | ((unsigned long long)(distance - deflateDistanceBase[distanceRange]) << codeLength);
+		if (!outputBitStream->WriteBitsFast(bits, codeLength + deflateDistanceExtraBits[distanceRange]))
+			return false;
+	}
+
+	return true;
+}
+
+/*virtual*/ bool DeflateCompression::Decompress(ByteStream* inputStream, ByteStream* outputStream)
+{
+	if (inputStream == outputStream)
+		return false;
+
+	BitStream inputBitStream(inputStream);
+
+	// As when compressing, the buffer holds the end of the previous block followed by the current one.
+	DArray<unsigned char> buffer;
+	unsigned int historySize = 0;
+
+	while (true)
+	{
+		unsigned int blockSize = 0;
+		if (!inputBitStream.ReadAllBits(blockSize))
+			return false;
+
+		if (blockSize == 0)
+			break;
+
+		// Blocks may be bigger than ours, since it's the compressor that decides.
+		unsigned int requiredSize = historySize + blockSize + UU_LZ77_COPY_SLACK;
+		if (requiredSize < blockSize)
+			return false;
+
+		if (buffer.GetSize() < requiredSize)
+			buffer.SetSize(requiredSize);
+
+		if (!this->DecompressBlock(&inputBitStream, buffer.GetBuffer(), historySize, blockSize))
+			return false;
+
+		if (outputStream->WriteBytes((const char*)buffer.GetBuffer() + historySize, blockSize) != blockSize)
+			return false;
+
+		unsigned int totalSize = historySize + blockSize;
+		historySize = UU_MIN(totalSize, UU_DEFLATE_WINDOW_SIZE);
+		UU_MEMMOVE(buffer.GetBuffer(), buffer.GetBuffer() + totalSize - historySize, historySize);
+
+		inputBitStream.SkipToByteBoundary();
+	}
+
+	return true;
+}
+
+bool DeflateCompression::DecompressBlock(BitStream* inputBitStream, unsigned char* buffer, unsigned int historySize, unsigned int blockSize)
+{
+	unsigned char literalLengthCodeLengthArray[UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS];
+	for (unsigned int i = 0; i < UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS; i++)
+		if (!inputBitStream->ReadBits(literalLengthCodeLengthArray[i], 4))
+			return false;
+
+	unsigned char distanceCodeLengthArray[UU_DEFLATE_NUM_DISTANCE_SYMBOLS];
+	bool hasDistanceCode = false;
+	for (unsigned int i = 0; i < UU_DEFLATE_NUM_DISTANCE_SYMBOLS; i++)
+	{
+		if (!inputBitStream->ReadBits(distanceCodeLengthArray[i], 4))
+			return false;
+
+		if (distanceCodeLengthArray[i] > 0)
+			hasDistanceCode = true;
+	}
+
+	HuffmanDecodeTable literalLengthDecodeTable;
+	if (!literalLengthDecodeTable.Build(literalLengthCodeLengthArray, UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS))
+		return false;
+
+	// A block with no matches has no distance code.
+	HuffmanDecodeTable distanceDecodeTable;
+	if (hasDistanceCode && !distanceDecodeTable.Build(distanceCodeLengthArray, UU_DEFLATE_NUM_DISTANCE_SYMBOLS))
+		return false;
+
+	unsigned char* output = buffer + historySize;
+	unsigned char* outputEnd = output + blockSize;
+
+	while (output < outputEnd)
+	{
+		unsigned long long bits = 0;
+		unsigned int numBits = inputBitStream->PeekBits(bits);
+		unsigned int numBitsUsed = 0;
+
+		// A match takes at most 48 bits, so we can decode at least one token, and usually several, before going
+		// back to the bit stream.  Whenever the bits run short, we stop and get more.  If we still can't decode
+		// a token with a full set of bits, or with what's left at the end of the stream, the data is malformed.
+		while (output < outputEnd)
+		{
+			unsigned int symbol = 0;
+			unsigned int codeLength = literalLengthDecodeTable.Decode(bits, symbol);
+			if (codeLength == 0 || numBitsUsed + codeLength > numBits)
+				break;
+
+			if (symbol < 256)
+			{
+				*output++ = (unsigned char)symbol;
+				bits >>= codeLength;
+				numBitsUsed += codeLength;
+				continue;
+			}
+
+			if (symbol < UU_DEFLATE_FIRST_LENGTH_SYMBOL || !hasDistanceCode)
+				break;
+
+			unsigned int lengthRange = symbol - UU_DEFLATE_FIRST_LENGTH_SYMBOL;
+			unsigned int lengthExtraBits = deflateLengthExtraBits[lengthRange];
+			unsigned int length = deflateLengthBase[lengthRange] + (unsigned int)((bits >> codeLength) & ((1 << lengthExtraBits) - 1));
+			unsigned int lengthBits = codeLength + lengthExtraBits;
+
+			unsigned int distanceRange = 0;
+			codeLength = distanceDecodeTable.Decode(bits >> lengthBits, distanceRange);
+			if (codeLength == 0)
+				break;
+
+			unsigned int distanceExtraBits = deflateDistanceExtraBits[distanceRange];
+			unsigned int distance = deflateDistanceBase[distanceRange] + (unsigned int)((bits >> (lengthBits + codeLength)) & ((1 << distanceExtraBits) - 1));
+			unsigned int tokenBits = lengthBits + codeLength + distanceExtraBits;
+			if (numBitsUsed + tokenBits > numBits)
+				break;
+
+			if (distance > (unsigned int)(output - buffer) || length > (unsigned int)(outputEnd - output))
+				return false;
+
+			LZ77CopyMatch(output, distance, length);
+			output += length;
+			bits >>= tokenBits;
+			numBitsUsed += tokenBits;
+		}
+
+		if (numBitsUsed == 0)
+			return false;
+
+		inputBitStream->SkipBits(numBitsUsed);
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "UltraUtilities/Compression/Compression.h"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Memory/BitStream.hpp"
+
+// This is the compression level used when none is given.  See @ref GetLZ77LevelConfig.
+#define UU_DEFLATE_DEFAULT_LEVEL				6
+
+// This is the default amount of input that is compressed with each pair of code tables.
+#define UU_DEFLATE_BLOCK_SIZE					(128 * 1024)
+
+// Matches reach back at most this far, into the previous block if need be.
+#define UU_DEFLATE_WINDOW_SIZE					32768
+
+#define UU_DEFLATE_MAX_MATCH_LENGTH				258
+#define UU_DEFLATE_NUM_LITERAL_LENGTH_SYMBOLS	286
+#define UU_DEFLATE_NUM_DISTANCE_SYMBOLS			30
+
+namespace UU
+{
+	class LZ77MatchFinder;
+
+	/**
+	 * This class combines LZ77 and Huffman coding in the manner of DEFLATE.  The input is
+	 * broken into literals and matches by a @ref LZ77MatchFinder, and then literals and match
+	 * lengths are Huffman coded with one code, and match distances with another.  Lengths and
+	 * distances are coded as one of a few ranges followed by a handful of extra bits giving
+	 * the offset within the range, using the same ranges as DEFLATE, so that each code stays
+	 * small while common values stay short.
+	 *
+	 * As with @ref HuffmanCompression, the input is read a block at a time from any kind of
+	 * stream, and each block has its own codes, stored as 4-bit code lengths.  Each block is
+	 * framed by its size, and a block of size zero marks the end.  Matches may reach back into
+	 * the previous block.  This is not DEFLATE's bit format, only its design.
+	 */
+	class UU_API DeflateCompression : public Compression
+	{
+	public:
+		DeflateCompression(unsigned int level = UU_DEFLATE_DEFAULT_LEVEL, unsigned int blockSize = UU_DEFLATE_BLOCK_SIZE);
+		virtual ~DeflateCompression();
+
+		virtual bool Compress(ByteStream* inputStream, ByteStream* outputStream) override;
+		virtual bool Decompress(ByteStream* inputStream, ByteStream* outputStream) override;
+
+	private:
+		bool CompressBlock(LZ77MatchFinder* matchFinder, bool lazy, unsigned int historySize, unsigned int blockSize, DArray<unsigned int>& tokenArray, BitStream* outputBitStream);
+		bool DecompressBlock(BitStream* inputBitStream, unsigned char* buffer, unsigned int historySize, unsigned int blockSize);
+
+		unsigned int level;
+		unsigned int blockSize;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "UltraUtilities/Compression/HuffmanCode.h"
+#include "UltraUtilities/Containers/DArray.hpp"
+
+namespace UU
+{
+	bool CalcHuffmanCodeLengths(const unsigned int* frequencyArray, unsigned int numSymbols, unsigned int maxCodeLength, unsigned char* codeLengthArray)
+	{
+		DArray<unsigned int> symbolArray;
+		for (unsigned int i = 0; i < numSymbols; i++)
+		{
+			codeLengthArray[i] = 0;
+			if (frequencyArray[i] > 0)
+				symbolArray.Push(i);
+		}
+
+		unsigned int numLeaves = symbolArray.GetSize();
+		if (numLeaves == 0)
+			return true;
+
+		if (numLeaves == 1)
+		{
+			codeLengthArray[symbolArray[0]] = 1;
+			return true;
+		}
+
+		if (maxCodeLength > 31 || numLeaves > (1U << maxCodeLength))
+			return false;
+
+		symbolArray.StableSort([frequencyArray](unsigned int symbolA, unsigned int symbolB) -> int
+			{
+				return frequencyArray[symbolA] > frequencyArray[symbolB] ? 1 : 0;
+			});
+
+		// With the leaves sorted, the internal nodes are made in order of weight too, so the
+		// two lightest nodes are always at the front of one queue or the other.  Leaves come
+		// first in these arrays and internal nodes after them, each after its children.
+		unsigned int numNodes = 2 * numLeaves - 1;
+		DArray<unsigned long long> weightArray(numNodes);
+		DArray<unsigned int> parentArray(numNodes);
+		for (unsigned int i = 0; i < numLeaves; i++)
+			weightArray[i] = frequencyArray[symbolArray[i]];
+
+		unsigned int leafIndex = 0;
+		unsigned int nodeIndex = numLeaves;
+		for (unsigned int newIndex = numLeaves; newIndex < numNodes; newIndex++)
+		{
+			unsigned int childIndex[2];
+			for (unsigned int j = 0; j < 2; j++)
+			{
+				if (leafIndex < numLeaves && (nodeIndex == newIndex || weightArray[leafIndex] <= weightArray[nodeIndex]))
+					childIndex[j] = leafIndex++;
+				else
+					childIndex[j] = nodeIndex++;
+			}
+
+			weightArray[newIndex] = weightArray[childIndex[0]] + weightArray[childIndex[1]];
+			parentArray[childIndex[0]] = newIndex;
+			parentArray[childIndex[1]] = newIndex;
+		}
+
+		// Walk back down from the root, reusing the weights as depths.  Overlong codes are
+		// counted at the maximum length for now.
+		unsigned int lengthCountArray[32];
+		UU_MEMSET(lengthCountArray, 0, sizeof(lengthCountArray));
+
+		weightArray[numNodes - 1] = 0;
+		for (unsigned int i = numNodes - 1; i-- > 0;)
+		{
+			weightArray[i] = weightArray[parentArray[i]] + 1;
+			if (i < numLeaves)
+				lengthCountArray[UU_MIN(weightArray[i], maxCodeLength)]++;
+		}
+
+		// Each code at the maximum length takes 1 unit of the code space, which has 2^maxCodeLength units
+		// in all.  Squeezing the overlong codes in may have overfilled it.  Taking away a code at the
+		// maximum length while splitting a shorter one into two longer ones frees a unit each time.
+		unsigned long long totalUnits = 0;
+		for (unsigned int i = 1; i <= maxCodeLength; i++)
+			totalUnits += (unsigned long long)lengthCountArray[i] << (maxCodeLength - i);
+
+		while (totalUnits > (1ULL << maxCodeLength))
+		{
+			lengthCountArray[maxCodeLength]--;
+			for (unsigned int i = maxCodeLength - 1; i > 0; i--)
+			{
+				if (lengthCountArray[i] > 0)
+				{
+					lengthCountArray[i]--;
+					lengthCountArray[i + 1] += 2;
+					break;
+				}
+			}
+
+			totalUnits--;
+		}
+
+		// Hand out the lengths, longest to the rarest symbols.
+		unsigned int symbolIndex = 0;
+		for (unsigned int length = maxCodeLength; length > 0; length--)
+			for (unsigned int j = 0; j < lengthCountArray[length]; j++)
+				codeLengthArray[symbolArray[symbolIndex++]] = (unsigned char)length;
+
+		return true;
+	}
+
+	bool CalcCanonicalHuffmanCodes(const unsigned char* codeLengthArray, unsigned int numSymbols, unsigned int* codeArray)
+	{
+		unsigned int lengthCountArray[UU_HUFFMAN_MAX_CODE_LENGTH + 1];
+		UU_MEMSET(lengthCountArray, 0, sizeof(lengthCountArray));
+
+		for (unsigned int i = 0; i < numSymbols; i++)
+		{
+			if (codeLengthArray[i] > UU_HUFFMAN_MAX_CODE_LENGTH)
+				return false;
+
+			lengthCountArray[codeLengthArray[i]]++;
+		}
+
+		// Codes of each length follow on from the last code of the length before, in order of symbol.
+		unsigned int nextCodeArray[UU_HUFFMAN_MAX_CODE_LENGTH + 1];
+		unsigned int code = 0;
+		lengthCountArray[0] = 0;
+		for (unsigned int length = 1; length <= UU_HUFFMAN_MAX_CODE_LENGTH; length++)
+		{
+			code = (code + lengthCountArray[length - 1]) << 1;
+			nextCodeArray[length] = code;
+			if (code + lengthCountArray[length] > (1U << length))
+				return false;
+		}
+
+		for (unsigned int i = 0; i < numSymbols; i++)
+		{
+			unsigned int length = codeLengthArray[i];
+			if (length == 0)
+			{
+				codeArray[i] = 0;
+				continue;
+			}
+
+			// The code is built MSB-first, but the first bit must be written first, so reverse it.
+			unsigned int canonicalCode = nextCodeArray[length]++;
+			unsigned int reversedCode = 0;
+			for (unsigned int j = 0; j < length; j++)
+				reversedCode |= ((canonicalCode >> j) & 1) << (length - 1 - j);
+
+			codeArray[i] = reversedCode | (length << 16);
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
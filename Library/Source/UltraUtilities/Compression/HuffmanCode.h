@@ -0,0 +1,38 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+// Code lengths are limited to this so that a code and its length pack into 32 bits
+// and so that decoding never needs more than one secondary table lookup.
+#define UU_HUFFMAN_MAX_CODE_LENGTH		15
+
+namespace UU
+{
+	/**
+	 * Calculate the lengths of the Huffman codes for the given symbol frequencies,
+	 * without letting any length exceed the given maximum.  When the optimal code is
+	 * too deep, the overlong codes are shortened to the maximum and the codes just
+	 * shorter than the maximum are lengthened to make room, which costs very little
+	 * since they belong to the rarest symbols.  A lone symbol gets a length of one.
+	 *
+	 * @param[in] frequencyArray This holds the number of occurrences of each symbol.
+	 * @param[in] numSymbols This is the size of the given arrays.
+	 * @param[in] maxCodeLength No code will be longer than this.
+	 * @param[out] codeLengthArray The length of each symbol's code is put here, or zero if the symbol doesn't occur.
+	 * @return False is returned if there are too many symbols to fit codes of the given maximum length.
+	 */
+	UU_API bool CalcHuffmanCodeLengths(const unsigned int* frequencyArray, unsigned int numSymbols, unsigned int maxCodeLength, unsigned char* codeLengthArray);
+
+	/**
+	 * Assign canonical Huffman codes for the given code lengths.  Canonical codes are
+	 * determined by their lengths alone, which is why only the lengths need to be stored.
+	 * Codes are given with their first bit in the LSB, which is how @ref BitStream writes them,
+	 * and are packed with the code in the low 16 bits and the length in the bits above that.
+	 *
+	 * @param[in] codeLengthArray This holds the length of each symbol's code, which must not exceed UU_HUFFMAN_MAX_CODE_LENGTH.
+	 * @param[in] numSymbols This is the size of the given arrays.
+	 * @param[out] codeArray The packed code of each symbol is put here.
+	 * @return False is returned if the lengths are too short for there to be a prefix code with them.
+	 */
+	UU_API bool CalcCanonicalHuffmanCodes(const unsigned char* codeLengthArray, unsigned int numSymbols, unsigned int* codeArray);
+}
\ No newline at end of file
@@ -1,14 +1,48 @@
 #include "UltraUtilities/Compression/HuffmanCompression.h"
-#include "UltraUtilities/Containers/RBMap.hpp"
-#include "UltraUtilities/Containers/PriorityQueue.hpp"
-#include "UltraUtilities/Memory/Pointer.hpp"
+#include "UltraUtilities/Compression/HuffmanCode.h"
+#include "UltraUtilities/Compression/HuffmanDecodeTable.h"
+#include "UltraUtilities/Containers/DArray.hpp"
 
 using namespace UU;
 
+// Decode the given number of symbols into the given buffer.
+static bool HuffmanDecodeSymbols(BitStream* inputBitStream, const HuffmanDecodeTable& decodeTable, unsigned char* output, unsigned int numSymbols)
+{
+	unsigned char* outputEnd = output + numSymbols;
+
+	while (output < outputEnd)
+	{
+		unsigned long long bits = 0;
+		unsigned int numBits = inputBitStream->PeekBits(bits);
+		unsigned int numBitsUsed = 0;
+
+		// Decode as many codes as we have bits for before going back to the bit stream.
+		while (output < outputEnd)
+		{
+			unsigned int symbol = 0;
+			unsigned int codeLength = decodeTable.Decode(bits, symbol);
+			if (codeLength == 0 || numBitsUsed + codeLength > numBits)
+				break;
+
+			bits >>= codeLength;
+			numBitsUsed += codeLength;
+			*output++ = (unsigned char)symbol;
+		}
+
+		if (numBitsUsed == 0)
+			return false;
+
+		inputBitStream->SkipBits(numBitsUsed);
+	}
+
+	return true;
+}
+
 //----------------------------- HuffmanCompression -----------------------------
 
-HuffmanCompression::HuffmanCompression()
+HuffmanCompression::HuffmanCompression(unsigned int blockSize /*= UU_HUFFMAN_BLOCK_SIZE*/)
 {
+	this->blockSize = (blockSize == 0) ? UU_HUFFMAN_BLOCK_SIZE : blockSize;
 }
 
 /*virtual*/ HuffmanCompression::~HuffmanCompression()
@@ -20,83 +54,49 @@ HuffmanCompression::HuffmanCompression()
 	if (inputStream == outputStream)
 		return false;
 
-	const char* inputBuffer = inputStream->GetBuffer();
-	if (!inputBuffer)
-		return false;
-
-	RBMap<char, Node*> alphabetMap;
+	DArray<unsigned char> blockBuffer;
+	BitStream outputBitStream(outputStream);
 
-	for (unsigned int i = 0; i < inputStream->GetSize(); i++)
+	while (true)
 	{
-		char character = inputBuffer[i];
-
-		Node* node = nullptr;
-		if (alphabetMap.Find(character, &node))
-			node->frequency++;
+		// Compress the input where it is if we can.  Otherwise, copy it out a block at a time.
+		unsigned int blockSize = 0;
+		const unsigned char* block = (const unsigned char*)inputStream->Peek(blockSize);
+		bool peeked = (block != nullptr);
+		if (peeked)
+			blockSize = UU_MIN(blockSize, this->blockSize);
 		else
 		{
-			node = new Node();
-			node->character = character;
-			node->type = Node::Type::LEAF;
-			node->frequency = 1;
-			alphabetMap.Insert(character, node);
+			blockBuffer.SetSize(this->blockSize);
+			block = blockBuffer.GetBuffer();
+
+			// The input stream may give us less than we ask for, so keep asking until it has nothing more.
+			blockSize = 0;
+			while (blockSize < this->blockSize)
+			{
+				unsigned int numBytesRead = inputStream->ReadBytes((char*)blockBuffer.GetBuffer() + blockSize, this->blockSize - blockSize);
+				if (numBytesRead == 0)
+					break;
+
+				blockSize += numBytesRead;
+			}
 		}
-	}
-
-	if (alphabetMap.GetNumPairs() == 0)
-		return false;
-
-	StaticPriorityQueue<Node*> nodeQueue;
-	for (auto pair : alphabetMap)
-		nodeQueue.InsertKey(pair.value);
-
-	while (nodeQueue.GetSize() >= 2)
-	{
-		Node* nodeA = nullptr;
-		nodeQueue.RemoveHighestPriorityKey(nodeA);
 
-		Node* nodeB = nullptr;
-		nodeQueue.RemoveHighestPriorityKey(nodeB);
-
-		Node* nodeC = new Node();
-		nodeC->type = Node::Type::INTERNAL;
-		nodeC->frequency = nodeA->frequency + nodeB->frequency;
-		nodeC->node[0] = nodeA;
-		nodeC->node[1] = nodeB;
-
-		nodeQueue.InsertKey(nodeC);
-	}
-
-	Node* rootNode = nullptr;
-	nodeQueue.RemoveHighestPriorityKey(rootNode);
-	
-	UniquePtr<Node> nodeTree(rootNode);
-
-	BitStream outputBitStream(outputStream);
-
-	unsigned int inputBufferSize = inputStream->GetSize();
-	if (!outputBitStream.WriteAllBits(inputBufferSize))
-		return false;
+		if (!outputBitStream.WriteAllBits(blockSize))
+			return false;
 
-	if (!rootNode->Serialize(&outputBitStream))
-		return false;
+		if (blockSize == 0)
+			break;
 
-	HashMap<char, DArray<char>> codeMap;
-	DArray<char> treePath;
-	rootNode->PopulateCodeMap(codeMap, treePath);
+		if (!this->CompressBlock(block, blockSize, &outputBitStream))
+			return false;
 
-	for (int i = 0; i < inputStream->GetSize(); i++)
-	{
-		char character = inputBuffer[i];
-		DArray<char>* charTreePath = nullptr;
-		codeMap.FindPtr(character, charTreePath);
+		if (peeked && !inputStream->Consume(blockSize))
+			return false;
 
-		for (int j = 0; j < charTreePath->GetSize(); j++)
-		{
-			char pathBit = (*charTreePath)[j];
-			if (!outputBitStream.WriteBits(pathBit, 1))
-				return false;
-		}
+		// Pass the block along now, rather than holding onto it until the next one is done.
+		if (!outputBitStream.Flush())
+			return false;
 	}
 
 	if (!outputBitStream.Flush())
@@ -105,151 +105,96 @@ HuffmanCompression::HuffmanCompression()
 	return true;
 }
 
-/*virtual*/ bool HuffmanCompression::Decompress(ByteStream* inputStream, ByteStream* outputStream)
+bool HuffmanCompression::CompressBlock(const unsigned char* blockBuffer, unsigned int blockSize, BitStream* outputBitStream)
 {
-	if (inputStream == outputStream)
-		return false;
+	unsigned int frequencyArray[256];
+	UU_MEMSET(frequencyArray, 0, sizeof(frequencyArray));
+	for (unsigned int i = 0; i < blockSize; i++)
+		frequencyArray[blockBuffer[i]]++;
 
-	BitStream inputBitStream(inputStream);
-
-	unsigned int originalSize = 0;
-	if (!inputBitStream.ReadAllBits(originalSize))
+	unsigned char codeLengthArray[256];
+	if (!CalcHuffmanCodeLengths(frequencyArray, 256, UU_HUFFMAN_MAX_CODE_LENGTH, codeLengthArray))
 		return false;
 
-	UniquePtr<Node> rootNode(Node::Deserialize(&inputBitStream));
-	if (!rootNode.Get())
+	unsigned int codeArray[256];
+	if (!CalcCanonicalHuffmanCodes(codeLengthArray, 256, codeArray))
 		return false;
 
-	Node* node = rootNode;
+	for (unsigned int i = 0; i < 256; i++)
+		if (!outputBitStream->WriteBitsFast(codeLengthArray[i], 4))
+			return false;
 
-	while (true)
+	for (unsigned int i = 0; i < blockSize; i++)
 	{
-		if (node->type == Node::Type::LEAF)
-		{
-			if (outputStream->WriteBytes(&node->character, 1) != 1)
-				return false;
-
-			if (outputStream->GetSize() == originalSize)
-				break;
-
-			node = rootNode;
-		}
-		else if (node->type == Node::Type::INTERNAL)
-		{
-			char pathBit = 0;
-			if (!inputBitStream.ReadBits(pathBit, 1))
-				return false;
-
-			node = node->node[pathBit];
-		}
-		else
-		{
+		unsigned int code = codeArray[blockBuffer[i]];
+		if (!outputBitStream->WriteBitsFast(code & 0xFFFF, code >> 16))
 			return false;
-		}
 	}
 
 	return true;
 }
 
-//----------------------------- HuffmanCompression::Node -----------------------------
-
-HuffmanCompression::Node::Node()
-{
-	this->frequency = 0;
-	this->type = Type::LEAF;
-	this->character = '\0';
-}
-
-/*virtual*/ HuffmanCompression::Node::~Node()
+/*virtual*/ bool HuffmanCompression::Decompress(ByteStream* inputStream, ByteStream* outputStream)
 {
-	if (this->type == Type::INTERNAL)
-	{
-		delete this->node[0];
-		delete this->node[1];
-	}
-}
+	if (inputStream == outputStream)
+		return false;
 
-bool HuffmanCompression::Node::Serialize(BitStream* bitStream) const
-{
-	bitStream->WriteBits(this->type, 1);
+	BitStream inputBitStream(inputStream);
 
-	switch (this->type)
+	while (true)
 	{
-		case Type::INTERNAL:
-		{
-			if (!this->node[0]->Serialize(bitStream))
-				return false;
-
-			if (!this->node[1]->Serialize(bitStream))
-				return false;
+		unsigned int blockSize = 0;
+		if (!inputBitStream.ReadAllBits(blockSize))
+			return false;
 
+		if (blockSize == 0)
 			break;
-		}
-		case Type::LEAF:
-		{
-			if (!bitStream->WriteAllBits(this->character))
-				return false;
 
-			break;
-		}
+		if (!this->DecompressBlock(&inputBitStream, outputStream, blockSize))
+			return false;
+
+		inputBitStream.SkipToByteBoundary();
 	}
 
 	return true;
 }
 
-/*static*/ HuffmanCompression::Node* HuffmanCompression::Node::Deserialize(BitStream* bitStream)
+bool HuffmanCompression::DecompressBlock(BitStream* inputBitStream, ByteStream* outputStream, unsigned int blockSize)
 {
-	UniquePtr<Node> node(new Node());
+	unsigned char codeLengthArray[256];
+	for (unsigned int i = 0; i < 256; i++)
+		if (!inputBitStream->ReadBits(codeLengthArray[i], 4))
+			return false;
 
-	if (!bitStream->ReadBits(*(reinterpret_cast<char*>(&node->type)), 1))
-		return nullptr;
+	HuffmanDecodeTable decodeTable;
+	if (!decodeTable.Build(codeLengthArray, 256))
+		return false;
 
-	switch (node->type)
+	// Decode straight into the output stream if it has room for the whole block in one piece.
+	unsigned int reservedSize = 0;
+	char* reservedBuffer = outputStream->Reserve(reservedSize);
+	if (reservedBuffer && reservedSize >= blockSize)
 	{
-		case Type::INTERNAL:
-		{
-			node->node[0] = Node::Deserialize(bitStream);
-			if (!node->node[0])
-				return nullptr;
-
-			node->node[1] = Node::Deserialize(bitStream);
-			if (!node->node[1])
-				return nullptr;
-
-			break;
-		}
-		case Type::LEAF:
-		{
-			if (!bitStream->ReadAllBits(node->character))
-				return nullptr;
+		if (!HuffmanDecodeSymbols(inputBitStream, decodeTable, (unsigned char*)reservedBuffer, blockSize))
+			return false;
 
-			break;
-		}
+		return outputStream->Commit(blockSize);
 	}
 
-	return node.Release();
-}
+	unsigned char outputBuffer[UU_HUFFMAN_DECODE_BUFFER_SIZE];
+	unsigned int remainingSize = blockSize;
 
-void HuffmanCompression::Node::PopulateCodeMap(HashMap<char, DArray<char>>& codeMap, DArray<char>& treePath) const
-{
-	switch (this->type)
+	while (remainingSize > 0)
 	{
-		case Type::INTERNAL:
-		{
-			treePath.Push(0);
-			this->node[0]->PopulateCodeMap(codeMap, treePath);
-			treePath.Pop();
+		unsigned int outputBufferSize = UU_MIN(remainingSize, UU_HUFFMAN_DECODE_BUFFER_SIZE);
+		if (!HuffmanDecodeSymbols(inputBitStream, decodeTable, outputBuffer, outputBufferSize))
+			return false;
 
-			treePath.Push(1);
-			this->node[1]->PopulateCodeMap(codeMap, treePath);
-			treePath.Pop();
+		if (outputStream->WriteBytes((const char*)outputBuffer, outputBufferSize) != outputBufferSize)
+			return false;
 
-			break;
-		}
-		case Type::LEAF:
-		{
-			codeMap.Insert(this->character, treePath);
-			break;
-		}
+		remainingSize -= outputBufferSize;
 	}
+
+	return true;
 }
\ No newline at end of file
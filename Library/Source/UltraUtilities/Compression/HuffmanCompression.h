@@ -1,55 +1,42 @@
 #pragma once
 
 #include "UltraUtilities/Compression/Compression.h"
-#include "UltraUtilities/Containers/DArray.hpp"
-#include "UltraUtilities/Containers/HashMap.hpp"
 #include "UltraUtilities/Memory/BitStream.hpp"
 
+// This is the default amount of input that is compressed with each code table.
+#define UU_HUFFMAN_BLOCK_SIZE				(128 * 1024)
+
+// Decoded bytes are collected in a buffer of this size before being written to the output stream.
+#define UU_HUFFMAN_DECODE_BUFFER_SIZE		4096
+
 namespace UU
 {
 	/**
 	 * This class implements the Huffman encoding/decoding scheme.
+	 *
+	 * Codes are canonical and no longer than UU_HUFFMAN_MAX_CODE_LENGTH bits, so the
+	 * code table is stored as nothing more than the 4-bit code length of each byte
+	 * value, and each byte is encoded with one table lookup and one bit write.
+	 *
+	 * The input is compressed a block at a time, each block with its own code table,
+	 * so that only one block is ever held in memory and output starts right away.
+	 * Any input stream will do; it's read until it has no more to give.  Each block
+	 * is framed by its size and starts on a byte boundary, and a block of size zero
+	 * marks the end.
 	 */
 	class UU_API HuffmanCompression : public Compression
 	{
 	public:
-		HuffmanCompression();
+		HuffmanCompression(unsigned int blockSize = UU_HUFFMAN_BLOCK_SIZE);
 		virtual ~HuffmanCompression();
 
 		virtual bool Compress(ByteStream* inputStream, ByteStream* outputStream) override;
 		virtual bool Decompress(ByteStream* inputStream, ByteStream* outputStream) override;
 
-		class Node
-		{
-		public:
-			Node();
-			virtual ~Node();
-
-			bool Serialize(BitStream* bitStream) const;
-			static Node* Deserialize(BitStream* bitStream);
-
-			void PopulateCodeMap(HashMap<char, DArray<char>>& codeMap, DArray<char>& treePath) const;
-
-			unsigned int frequency;
-
-			bool operator<(const Node* node) const
-			{
-				return this->frequency < node->frequency;
-			}
-
-			enum Type : char
-			{
-				INTERNAL,
-				LEAF
-			};
-
-			Type type;
+	private:
+		bool CompressBlock(const unsigned char* blockBuffer, unsigned int blockSize, BitStream* outputBitStream);
+		bool DecompressBlock(BitStream* inputBitStream, ByteStream* outputStream, unsigned int blockSize);
 
-			union
-			{
-				Node* node[2];
-				char character;
-			};
-		};
+		unsigned int blockSize;
 	};
 }
\ No newline at end of file
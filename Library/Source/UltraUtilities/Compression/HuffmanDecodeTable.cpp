@@ -0,0 +1,116 @@
+#include "UltraUtilities/Compression/HuffmanDecodeTable.h"
+#include "UltraUtilities/Compression/HuffmanCode.h"
+#include "UltraUtilities/Memory/BitStream.hpp"
+
+using namespace UU;
+
+//----------------------------- HuffmanDecodeTable -----------------------------
+
+HuffmanDecodeTable::HuffmanDecodeTable()
+{
+	this->primaryBits = 0;
+	this->maxCodeLength = 0;
+}
+
+/*virtual*/ HuffmanDecodeTable::~HuffmanDecodeTable()
+{
+}
+
+bool HuffmanDecodeTable::Build(const unsigned long long* codeArray, const unsigned char* codeLengthArray, unsigned int numSymbols)
+{
+	this->entryArray.SetSize(0);
+	this->primaryBits = 0;
+	this->maxCodeLength = 0;
+
+	for (unsigned int i = 0; i < numSymbols; i++)
+		if (codeLengthArray[i] > this->maxCodeLength)
+			this->maxCodeLength = codeLengthArray[i];
+
+	if (this->maxCodeLength == 0 || this->maxCodeLength > UU_BIT_STREAM_MAX_BITS)
+		return false;
+
+	this->primaryBits = UU_MIN(this->maxCodeLength, UU_HUFFMAN_DECODE_TABLE_BITS);
+
+	unsigned int offset = 0;
+	return this->BuildLevel(codeArray, codeLengthArray, numSymbols, 0, 0, this->primaryBits, offset);
+}
+
+bool HuffmanDecodeTable::Build(const unsigned char* codeLengthArray, unsigned int numSymbols)
+{
+	DArray<unsigned int> packedCodeArray(numSymbols);
+	if (!CalcCanonicalHuffmanCodes(codeLengthArray, numSymbols, packedCodeArray.GetBuffer()))
+		return false;
+
+	DArray<unsigned long long> codeArray(numSymbols);
+	for (unsigned int i = 0; i < numSymbols; i++)
+		codeArray[i] = packedCodeArray[i] & 0xFFFF;
+
+	return this->Build(codeArray.GetBuffer(), codeLengthArray, numSymbols);
+}
+
+// Build the table for all codes that begin with the given prefix, indexed by the given number of bits after it.
+bool HuffmanDecodeTable::BuildLevel(const unsigned long long* codeArray, const unsigned char* codeLengthArray, unsigned int numSymbols, unsigned long long prefix, unsigned int prefixLength, unsigned int levelBits, unsigned int& offset)
+{
+	offset = this->entryArray.GetSize();
+	unsigned int levelSize = 1 << levelBits;
+	for (unsigned int i = 0; i < levelSize; i++)
+		this->entryArray.Push(0);
+
+	unsigned long long prefixMask = (1ULL << prefixLength) - 1;
+
+	// Codes that end within this level fill every entry whose low bits match them.
+	for (unsigned int i = 0; i < numSymbols; i++)
+	{
+		unsigned int length = codeLengthArray[i];
+		if (length <= prefixLength || (codeArray[i] & prefixMask) != prefix)
+			continue;
+
+		unsigned int remainingLength = length - prefixLength;
+		if (remainingLength > levelBits)
+			continue;
+
+		unsigned int index = (unsigned int)(codeArray[i] >> prefixLength) & ((1 << remainingLength) - 1);
+		unsigned int entry = (i << HUFFMAN_ENTRY_PAYLOAD_SHIFT) | remainingLength;
+		for (; index < levelSize; index += 1 << remainingLength)
+		{
+			if (this->entryArray[offset + index] != 0)
+				return false;
+
+			this->entryArray[offset + index] = entry;
+		}
+	}
+
+	// Codes that go beyond this level get a secondary table for each distinct run of bits in this level.
+	for (unsigned int i = 0; i < numSymbols; i++)
+	{
+		unsigned int length = codeLengthArray[i];
+		if (length <= prefixLength + levelBits || (codeArray[i] & prefixMask) != prefix)
+			continue;
+
+		unsigned int index = (unsigned int)(codeArray[i] >> prefixLength) & (levelSize - 1);
+		unsigned int entry = this->entryArray[offset + index];
+		if ((entry & HUFFMAN_ENTRY_LINK) != 0)
+			continue;
+
+		if (entry != 0)
+			return false;
+
+		unsigned long long subPrefix = prefix | ((unsigned long long)index << prefixLength);
+		unsigned int subPrefixLength = prefixLength + levelBits;
+		unsigned long long subPrefixMask = (1ULL << subPrefixLength) - 1;
+
+		unsigned int subMaxLength = 0;
+		for (unsigned int j = 0; j < numSymbols; j++)
+			if (codeLengthArray[j] > subPrefixLength && (codeArray[j] & subPrefixMask) == subPrefix)
+				subMaxLength = UU_MAX(subMaxLength, codeLengthArray[j] - subPrefixLength);
+
+		unsigned int subLevelBits = UU_MIN(subMaxLength, UU_HUFFMAN_DECODE_TABLE_BITS);
+		unsigned int subOffset = 0;
+		if (!this->BuildLevel(codeArray, codeLengthArray, numSymbols, subPrefix, subPrefixLength, subLevelBits, subOffset))
+			return false;
+
+		this->entryArray[offset + index] = (subOffset << HUFFMAN_ENTRY_PAYLOAD_SHIFT) | HUFFMAN_ENTRY_LINK | subLevelBits;
+	}
+
+	return true;
+}
\ No newline at end of file
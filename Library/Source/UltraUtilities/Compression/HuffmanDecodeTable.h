@@ -0,0 +1,96 @@
+#pragma once
+
+#include "UltraUtilities/Containers/DArray.hpp"
+
+// This is the most bits a decode table indexes at each level.  Most codes are
+// shorter than this and so are decoded with a single lookup.
+#define UU_HUFFMAN_DECODE_TABLE_BITS		11
+
+namespace UU
+{
+	/**
+	 * This is a lookup table for decoding a Huffman code (or any prefix code)
+	 * a whole code at a time rather than a bit at a time.  The next several bits
+	 * of input index the primary table, and the entry found there gives the symbol
+	 * and the length of its code.  Codes too long for the primary table lead
+	 * through it to secondary tables indexed by the bits that follow.
+	 *
+	 * Bits are taken LSB-first, which is how @ref BitStream delivers them, so
+	 * the first bit of each code must be the LSB of the code given here.
+	 */
+	class UU_API HuffmanDecodeTable
+	{
+	public:
+		HuffmanDecodeTable();
+		virtual ~HuffmanDecodeTable();
+
+		/**
+		 * Build the table for the given code.
+		 *
+		 * @param[in] codeArray This holds the code of each symbol, first bit in the LSB.
+		 * @param[in] codeLengthArray This holds the length of each symbol's code in bits.  Symbols that don't occur have length zero.
+		 * @param[in] numSymbols This is the size of both of the given arrays.
+		 * @return False is returned if the code is not a prefix code or has codes longer than 57 bits.
+		 */
+		bool Build(const unsigned long long* codeArray, const unsigned char* codeLengthArray, unsigned int numSymbols);
+
+		/**
+		 * Build the table for the canonical code with the given code lengths.
+		 * See @ref CalcCanonicalHuffmanCodes.
+		 */
+		bool Build(const unsigned char* codeLengthArray, unsigned int numSymbols);
+
+		/**
+		 * Decode the code at the start of the given bits.
+		 *
+		 * @param[in] bits These are the upcoming bits of the input, first bit in the LSB.
+		 * @param[out] symbol The decoded symbol is put here.
+		 * @return The length of the decoded code is returned, or zero if the bits don't start with any code.
+		 */
+		unsigned int Decode(unsigned long long bits, unsigned int& symbol) const
+		{
+			unsigned int levelBits = this->primaryBits;
+			unsigned int entry = this->entryArray[(unsigned int)bits & ((1 << levelBits) - 1)];
+			unsigned int length = 0;
+
+			while ((entry & HUFFMAN_ENTRY_LINK) != 0)
+			{
+				length += levelBits;
+				bits >>= levelBits;
+				levelBits = entry & HUFFMAN_ENTRY_LENGTH_MASK;
+				entry = this->entryArray[(entry >> HUFFMAN_ENTRY_PAYLOAD_SHIFT) + ((unsigned int)bits & ((1 << levelBits) - 1))];
+			}
+
+			if (entry == 0)
+				return 0;
+
+			symbol = entry >> HUFFMAN_ENTRY_PAYLOAD_SHIFT;
+			return length + (entry & HUFFMAN_ENTRY_LENGTH_MASK);
+		}
+
+		/**
+		 * Return the length of the longest code in the table.
+		 */
+		unsigned int GetMaxCodeLength() const
+		{
+			return this->maxCodeLength;
+		}
+
+	private:
+
+		// An entry is a leaf, giving a symbol and how many of this level's bits its code uses,
+		// or a link, giving the offset of a secondary table and how many bits index it.
+		enum
+		{
+			HUFFMAN_ENTRY_LENGTH_MASK = 0xFF,
+			HUFFMAN_ENTRY_LINK = 0x100,
+			HUFFMAN_ENTRY_PAYLOAD_SHIFT = 9
+		};
+
+		bool BuildLevel(const unsigned long long* codeArray, const unsigned char* codeLengthArray, unsigned int numSymbols, unsigned long long prefix, unsigned int prefixLength, unsigned int levelBits, unsigned int& offset);
+
+		DArray<unsigned int> entryArray;
+		unsigned int primaryBits;
+		unsigned int maxCodeLength;
+	};
+}
\ No newline at end of file
@@ -1,12 +1,14 @@
 #include "UltraUtilities/Compression/LZ77Compression.h"
+#include "UltraUtilities/Compression/LZ77MatchFinder.h"
 #include "UltraUtilities/Containers/DArray.hpp"
 #include "UltraUtilities/Memory/BitStream.hpp"
 
 using namespace UU;
 
-LZ77Compression::LZ77Compression(unsigned int windowSize)
+LZ77Compression::LZ77Compression(unsigned int windowSize, unsigned int level /*= UU_LZ77_DEFAULT_LEVEL*/)
 {
 	this->windowSize = windowSize;
+	this->level = UU_MAX(1, UU_MIN(level, 9));
 }
 
 /*virtual*/ LZ77Compression::~LZ77Compression()
@@ -18,11 +20,29 @@ LZ77Compression::LZ77Compression(unsigned int windowSize)
 	if (inputStream == outputStream)
 		return false;
 
-	const char* inputBuffer = inputStream->GetBuffer();
-	if (!inputBuffer)
-		return false;
+	// The whole input has to be in one piece.  If the input stream doesn't already have it that way, copy it out.
+	unsigned int inputBufferSize = 0;
+	const unsigned char* inputBuffer = (const unsigned char*)inputStream->Peek(inputBufferSize);
+	bool peeked = (inputBuffer != nullptr && inputBufferSize == inputStream->GetSize());
+	DArray<unsigned char> inputArray;
+	if (!peeked)
+	{
+		inputBufferSize = 0;
+		while (true)
+		{
+			if (inputBufferSize == inputArray.GetSize())
+				inputArray.SetSize(UU_MAX(inputBufferSize * 2, 64 * 1024));
+
+			unsigned int numBytesRead = inputStream->ReadBytes((char*)inputArray.GetBuffer() + inputBufferSize, inputArray.GetSize() - inputBufferSize);
+			if (numBytesRead == 0)
+				break;
+
+			inputBufferSize += numBytesRead;
+		}
+
+		inputBuffer = inputArray.GetBuffer();
+	}
 
-	unsigned int inputBufferSize = inputStream->GetSize();
 	if (inputBufferSize == 0)
 		return false;
 
@@ -34,84 +54,37 @@ LZ77Compression::LZ77Compression(unsigned int windowSize)
 	if (numBits >= sizeof(unsigned int) * 8)
 		return false;
 
-	unsigned int i = 0;
-	while (i < inputBufferSize)
-	{
-		bool emitNextByte = true;
+	// Offsets and lengths both have to fit in the bits we give them.
+	unsigned int maxLength = (1U << numBits) - 1;
+	unsigned int maxDistance = UU_MIN(this->windowSize, maxLength);
 
-		unsigned int availableWindowSize = UU_MIN(windowSize, inputBufferSize - i);
-		availableWindowSize = UU_MIN(availableWindowSize, i);
+	const LZ77LevelConfig& config = GetLZ77LevelConfig(this->level);
+	LZ77MatchFinder matchFinder(maxDistance, config.maxChainLength, config.niceLength);
+	matchFinder.Reset(inputBuffer, inputBufferSize);
 
-		for (unsigned int j = 0; j < availableWindowSize; j++)
+	bool parsed = matchFinder.Parse(0, inputBufferSize, maxLength, config.lazy,
+		[&outputBitStream](unsigned char literal) -> bool
 		{
-			const char* patternBuffer = &inputBuffer[i];
-			unsigned int patternBufferSize = availableWindowSize - j;	// Look for patterns from biggest to smallest.
-
-			// If the pattern buffer isn't large enough, then it's not worth it.
-			if (patternBufferSize < 3)
-				break;
-
-			const char* searchBuffer = &inputBuffer[i - availableWindowSize];
-			unsigned int searchBufferSize = availableWindowSize;
-			unsigned int foundPatternOffset = 0;
-
-			if (this->FindPattern(patternBuffer, patternBufferSize, searchBuffer, searchBufferSize, foundPatternOffset))
-			{
-				if (!outputBitStream.WriteBits(char(1), 1))
-					return false;
-
-				unsigned int relativeOffset = searchBufferSize - foundPatternOffset;
-				
-				if (!outputBitStream.WriteBits(relativeOffset, numBits))
-					return false;
-
-				if (!outputBitStream.WriteBits(patternBufferSize, numBits))
-					return false;
-
-				i += patternBufferSize;
-				emitNextByte = false;
-				break;
-			}
-		}
-
-		if (emitNextByte)
+			return outputBitStream.WriteBitsFast((unsigned int)literal << 1, 9);
+		},
+		[&outputBitStream, numBits](unsigned int distance, unsigned int length) -> bool
 		{
-			if (!outputBitStream.WriteBits(char(0), 1))
-				return false;
-
-			if (!outputBitStream.WriteAllBits(inputBuffer[i]))
-				return false;
+			return
+				outputBitStream.WriteBitsFast(1, 1) &&
+				outputBitStream.WriteBitsFast(distance, numBits) &&
+				outputBitStream.WriteBitsFast(length, numBits);
+		});
 
-			i++;
-		}
-	}
+	if (!parsed)
+		return false;
 
 	if (!outputBitStream.Flush())
 		return false;
 
-	return true;
-}
-
-bool LZ77Compression::FindPattern(const char* patternBuffer, unsigned int patternBufferSize, const char* searchBuffer, unsigned int searchBufferSize, unsigned int& foundPatternOffset)
-{
-	for (unsigned int i = 0; i < searchBufferSize; i++)
-	{
-		if (searchBufferSize - i < patternBufferSize)
-			return false;
-
-		unsigned int j;
-		for (j = 0; j < patternBufferSize; j++)
-			if (patternBuffer[j] != searchBuffer[i + j])
-				break;
-
-		if (j == patternBufferSize)
-		{
-			foundPatternOffset = i;
-			return true;
-		}
-	}
+	if (peeked && !inputStream->Consume(inputBufferSize))
+		return false;
 
-	return false;
+	return true;
 }
 
 unsigned int LZ77Compression::CalcMaxBitsForOffsetOrLength()
@@ -135,49 +108,57 @@ unsigned int LZ77Compression::CalcMaxBitsForOffsetOrLength()
 	if (!inputBitStream.ReadAllBits(originalSize))
 		return false;
 
-	DArray<char> outputBuffer;
-	outputBuffer.SetCapacity(originalSize);
+	// The slack at the end lets match copies overshoot rather than having to stop on the exact byte.
+	// Decompress straight into the output stream if it has room for that, or else into a buffer of our own.
+	DArray<unsigned char> outputArray;
+	unsigned int reservedSize = 0;
+	unsigned char* outputBuffer = (unsigned char*)outputStream->Reserve(reservedSize);
+	bool reserved = (outputBuffer != nullptr && reservedSize >= UU_LZ77_COPY_SLACK && reservedSize - UU_LZ77_COPY_SLACK >= originalSize);
+	if (!reserved)
+	{
+		outputArray.SetSize(originalSize + UU_LZ77_COPY_SLACK);
+		outputBuffer = outputArray.GetBuffer();
+	}
+
+	unsigned char* output = outputBuffer;
+	unsigned char* outputEnd = output + originalSize;
 
-	while (true)
+	while (output < outputEnd)
 	{
-		char typeBit = 0;
-		if (!inputBitStream.ReadBits(typeBit, 1))
-			break;
+		unsigned long long bits = 0;
+		unsigned int numBitsAvailable = inputBitStream.PeekBits(bits);
 
-		if (typeBit == 0)
+		if ((bits & 1) == 0)
 		{
-			char byte = 0;
-			if (!inputBitStream.ReadAllBits(byte))
+			if (numBitsAvailable < 9)
 				return false;
 
-			outputBuffer.Push(byte);
+			*output++ = (unsigned char)(bits >> 1);
+			inputBitStream.SkipBits(9);
+			continue;
 		}
-		else if(typeBit == 1)
-		{
-			unsigned int relativeOffset = 0;
-			if (!inputBitStream.ReadBits(relativeOffset, numBits))
-				return false;
 
-			unsigned int patternLength = 0;
-			if (!inputBitStream.ReadBits(patternLength, numBits))
-				return false;
+		inputBitStream.SkipBits(1);
 
-			if (relativeOffset > outputBuffer.GetSize() || patternLength > relativeOffset)
-				return false;		// Malformed data.
+		unsigned long long distance = 0;
+		if (!inputBitStream.ReadBitsFast(distance, numBits))
+			return false;
 
-			unsigned int i = outputBuffer.GetSize() - relativeOffset;
-			for (unsigned int j = 0; j < patternLength; j++)
-				outputBuffer.Push(outputBuffer[i + j]);
-		}
+		unsigned long long length = 0;
+		if (!inputBitStream.ReadBitsFast(length, numBits))
+			return false;
 
-		if (outputBuffer.GetSize() > originalSize)
-			return false;	// Something went wrong in our math.
+		if (distance == 0 || distance > (unsigned long long)(output - outputBuffer) || length > (unsigned long long)(outputEnd - output))
+			return false;		// Malformed data.
 
-		if (outputBuffer.GetSize() == originalSize)
-			break;
+		LZ77CopyMatch(output, (unsigned int)distance, (unsigned int)length);
+		output += length;
 	}
 
-	if (outputStream->WriteBytes(outputBuffer.GetBuffer(), outputBuffer.GetSize()) != outputBuffer.GetSize())
+	if (reserved)
+		return outputStream->Commit(originalSize);
+
+	if (outputStream->WriteBytes((const char*)outputBuffer, originalSize) != originalSize)
 		return false;
 
 	return true;
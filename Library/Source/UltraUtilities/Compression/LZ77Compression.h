@@ -2,25 +2,35 @@
 
 #include "UltraUtilities/Compression/Compression.h"
 
+// This is the compression level used when none is given.
+#define UU_LZ77_DEFAULT_LEVEL		6
+
 namespace UU
 {
 	/**
 	 * This class implements the Lempel/Ziv 1977 encoding/decoding scheme.
+	 *
+	 * Matches are found with a @ref LZ77MatchFinder.  The compression level, from 1 to 9,
+	 * sets how hard it looks.  See @ref GetLZ77LevelConfig.
+	 *
+	 * A match may overlap the bytes it produces, so a run of one repeated byte, for
+	 * example, becomes a literal followed by a single match one byte back.  Decompression
+	 * copies matches 8 or 16 bytes at a time straight into a buffer sized for the whole
+	 * output, so it does very little per byte.
 	 */
 	class UU_API LZ77Compression : public Compression
 	{
 	public:
-		LZ77Compression(unsigned int windowSize);
+		LZ77Compression(unsigned int windowSize, unsigned int level = UU_LZ77_DEFAULT_LEVEL);
 		virtual ~LZ77Compression();
 
 		virtual bool Compress(ByteStream* inputStream, ByteStream* outputStream) override;
 		virtual bool Decompress(ByteStream* inputStream, ByteStream* outputStream) override;
 
 	private:
-		bool FindPattern(const char* patternBuffer, unsigned int patternBufferSize, const char* searchBuffer, unsigned int searchBufferSize, unsigned int& foundPatternOffset);
-
 		unsigned int CalcMaxBitsForOffsetOrLength();
 
 		unsigned int windowSize;
+		unsigned int level;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "UltraUtilities/Compression/LZ77MatchFinder.h"
+
+#if defined _MSC_VER
+#	include <intrin.h>
+#endif
+
+using namespace UU;
+
+// Count how many of the leading bytes of the two given buffers are the same, up to the given limit.
+static inline unsigned int LZ77MatchLength(const unsigned char* bytesA, const unsigned char* bytesB, unsigned int maxLength)
+{
+	unsigned int length = 0;
+
+#if (defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined _M_X64 || defined _M_ARM64
+	// Compare a word at a time.  The first differing byte is the lowest one set in the difference.
+	while (length + 8 <= maxLength)
+	{
+		unsigned long long wordA = 0, wordB = 0;
+		UU_MEMCPY(&wordA, bytesA + length, 8);
+		UU_MEMCPY(&wordB, bytesB + length, 8);
+		unsigned long long difference = wordA ^ wordB;
+		if (difference != 0)
+		{
+#	if defined _MSC_VER
+			unsigned long index = 0;
+			_BitScanForward64(&index, difference);
+			return length + index / 8;
+#	else
+			return length + __builtin_ctzll(difference) / 8;
+#	endif
+		}
+
+		length += 8;
+	}
+#endif
+
+	while (length < maxLength && bytesA[length] == bytesB[length])
+		length++;
+
+	return length;
+}
+
+namespace UU
+{
+	// These follow the levels of zlib.
+	static const LZ77LevelConfig lz77LevelConfigArray[] =
+	{
+		{ 4, 8, false },
+		{ 8, 16, false },
+		{ 16, 32, false },
+		{ 16, 16, true },
+		{ 32, 32, true },
+		{ 128, 128, true },
+		{ 256, 128, true },
+		{ 1024, 258, true },
+		{ 4096, 258, true }
+	};
+
+	const LZ77LevelConfig& GetLZ77LevelConfig(unsigned int level)
+	{
+		return lz77LevelConfigArray[UU_MAX(1, UU_MIN(level, 9)) - 1];
+	}
+}
+
+//----------------------------- LZ77MatchFinder -----------------------------
+
+LZ77MatchFinder::LZ77MatchFinder(unsigned int windowSize, unsigned int maxChainLength, unsigned int niceLength)
+{
+	this->buffer = nullptr;
+	this->bufferSize = 0;
+	this->insertPosition = 0;
+	this->windowSize = windowSize;
+	this->maxChainLength = (maxChainLength == 0) ? 1 : maxChainLength;
+	this->niceLength = niceLength;
+
+	// The chain links live in a ring at least as big as the window, so links are only
+	// ever overwritten by positions beyond the window of anything that could follow them.
+	unsigned int ringSize = RoundUpToPowerOfTwo(windowSize);
+
+	this->windowMask = ringSize - 1;
+	this->headArray.SetSize(1 << UU_LZ77_HASH_BITS);
+	this->prevArray.SetSize(ringSize);
+}
+
+/*virtual*/ LZ77MatchFinder::~LZ77MatchFinder()
+{
+}
+
+void LZ77MatchFinder::Reset(const unsigned char* buffer, unsigned int bufferSize)
+{
+	this->buffer = buffer;
+	this->bufferSize = bufferSize;
+	this->insertPosition = 0;
+
+	// This makes every head 0xFFFFFFFF, which is never before any position, so it ends every chain.
+	UU_MEMSET(this->headArray.GetBuffer(), 0xFF, this->headArray.GetSize() * sizeof(unsigned int));
+}
+
+unsigned int LZ77MatchFinder::FindMatch(unsigned int position, unsigned int maxLength, unsigned int minLength, unsigned int& distance) const
+{
+	maxLength = UU_MIN(maxLength, this->bufferSize - position);
+	if (maxLength < UU_LZ77_MIN_MATCH_LENGTH || maxLength <= minLength)
+		return 0;
+
+	const unsigned char* current = &this->buffer[position];
+	unsigned int bestLength = UU_MAX(minLength, UU_LZ77_MIN_MATCH_LENGTH - 1);
+	unsigned int foundLength = 0;
+
+	unsigned int candidate = this->headArray[this->Hash(position)];
+	for (unsigned int i = 0; i < this->maxChainLength; i++)
+	{
+		if (candidate >= position || position - candidate > this->windowSize)
+			break;
+
+		// A candidate can only do better if it matches at the byte just past the best so far.
+		const unsigned char* match = &this->buffer[candidate];
+		if (match[bestLength] == current[bestLength] && match[0] == current[0])
+		{
+			unsigned int length = LZ77MatchLength(match, current, maxLength);
+			if (length > bestLength)
+			{
+				bestLength = length;
+				foundLength = length;
+				distance = position - candidate;
+
+				if (length >= this->niceLength || length == maxLength)
+					break;
+			}
+		}
+
+		// Chains always run backward, and end in a position no less than where they are.
+		unsigned int next = this->prevArray[candidate & this->windowMask];
+		if (next >= candidate)
+			break;
+
+		candidate = next;
+	}
+
+	return foundLength;
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "UltraUtilities/Containers/DArray.hpp"
+
+// Matches shorter than this aren't looked for, since they rarely pay for themselves.
+#define UU_LZ77_MIN_MATCH_LENGTH		3
+
+// This is the number of bits of the hash of the first few bytes at each position.
+#define UU_LZ77_HASH_BITS				15
+
+// Decompression buffers need this much room past their end so that matches can be copied in whole words.
+#define UU_LZ77_COPY_SLACK				16
+
+namespace UU
+{
+	/**
+	 * These are the match finder settings for a compression level.
+	 */
+	struct LZ77LevelConfig
+	{
+		unsigned int maxChainLength;
+		unsigned int niceLength;
+		bool lazy;
+	};
+
+	/**
+	 * Return the match finder settings for the given compression level, from 1 to 9.
+	 * Levels 1 to 3 take the longest match found at each position (greedy matching).
+	 * Levels 4 to 9 also look for a longer match starting at the next position, and
+	 * emit a literal instead if they find one (lazy matching).  Higher levels search
+	 * further down the hash chains, compressing better but more slowly.
+	 */
+	UU_API const LZ77LevelConfig& GetLZ77LevelConfig(unsigned int level);
+
+	/**
+	 * This finds earlier occurrences of the bytes at a given position in a buffer,
+	 * for use by LZ77-style compressors.  Positions are hashed on their first three
+	 * bytes, and each position is chained to the previous position with the same hash,
+	 * so that only positions that are likely to match are ever compared.  How far down
+	 * a chain to search is configurable, which trades compression ratio for speed.
+	 *
+	 * Positions must be inserted in increasing order, and only positions already
+	 * inserted are found as matches.
+	 */
+	class UU_API LZ77MatchFinder
+	{
+	public:
+		/**
+		 * @param[in] windowSize Matches are never found further back than this.
+		 * @param[in] maxChainLength This is the most candidates that are compared per search.
+		 * @param[in] niceLength A search stops early once it finds a match at least this long.
+		 */
+		LZ77MatchFinder(unsigned int windowSize, unsigned int maxChainLength, unsigned int niceLength);
+		virtual ~LZ77MatchFinder();
+
+		/**
+		 * Start over with the given buffer.  The buffer is not copied, so it must outlive its use here.
+		 */
+		void Reset(const unsigned char* buffer, unsigned int bufferSize);
+
+		/**
+		 * Add the given position to the chains.  Every position should be inserted, whether or not
+		 * it was searched, so that later searches can find it.
+		 */
+		void Insert(unsigned int position)
+		{
+			if (position + UU_LZ77_MIN_MATCH_LENGTH > this->bufferSize)
+				return;
+
+			unsigned int hash = this->Hash(position);
+			this->prevArray[position & this->windowMask] = this->headArray[hash];
+			this->headArray[hash] = position;
+		}
+
+		/**
+		 * Find the longest match for the bytes at the given position among the positions inserted so far.
+		 *
+		 * @param[in] position This is where the bytes to match begin.  It should not have been inserted yet.
+		 * @param[in] maxLength Matches are never longer than this.
+		 * @param[in] minLength Only matches longer than this are of interest.
+		 * @param[out] distance How far back the match begins is put here, if one is found.
+		 * @return The length of the match found is returned, or zero if none was found longer than the given minimum.
+		 */
+		unsigned int FindMatch(unsigned int position, unsigned int maxLength, unsigned int minLength, unsigned int& distance) const;
+
+		/**
+		 * Break the given range of the buffer into literals and matches.  Positions before
+		 * the range are inserted first, so they can be matched against, which is how a block
+		 * can refer back into the one before it.
+		 *
+		 * @param[in] begin This is the first position of the range.
+		 * @param[in] end This is one past the last position of the range.  Matches don't go beyond it.
+		 * @param[in] maxLength Matches are never longer than this.
+		 * @param[in] lazy If true, a match is put off by a literal when a longer one starts at the next position.
+		 * @param[in] literalFunc This is called with each literal byte and returns false to stop.
+		 * @param[in] matchFunc This is called with the distance and length of each match and returns false to stop.
+		 * @return False is returned if either of the given functions did.
+		 */
+		template<typename L, typename M>
+		bool Parse(unsigned int begin, unsigned int end, unsigned int maxLength, bool lazy, L literalFunc, M matchFunc)
+		{
+			unsigned int i = begin;
+			unsigned int length = 0;
+			unsigned int distance = 0;
+			bool searched = false;
+
+			while (i < end)
+			{
+				if (!searched)
+					length = this->InsertAndFindMatch(i, UU_MIN(maxLength, end - i), 0, distance);
+
+				searched = false;
+
+				if (lazy && length > 0 && length < this->niceLength && i + 1 < end)
+				{
+					unsigned int nextDistance = 0;
+					unsigned int nextLength = this->InsertAndFindMatch(i + 1, UU_MIN(maxLength, end - i - 1), length, nextDistance);
+					if (nextLength > 0)
+					{
+						if (!literalFunc(this->buffer[i]))
+							return false;
+
+						i++;
+						length = nextLength;
+						distance = nextDistance;
+						searched = true;
+						continue;
+					}
+				}
+
+				if (length > 0)
+				{
+					if (!matchFunc(distance, length))
+						return false;
+
+					i += length;
+				}
+				else
+				{
+					if (!literalFunc(this->buffer[i]))
+						return false;
+
+					i++;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * Return the size of the window that matches are found in.
+		 */
+		unsigned int GetWindowSize() const
+		{
+			return this->windowSize;
+		}
+
+	private:
+		unsigned int InsertAndFindMatch(unsigned int position, unsigned int maxLength, unsigned int minLength, unsigned int& distance)
+		{
+			while (this->insertPosition < position)
+				this->Insert(this->insertPosition++);
+
+			return this->FindMatch(position, maxLength, minLength, distance);
+		}
+
+		unsigned int Hash(unsigned int position) const
+		{
+			const unsigned char* bytes = &this->buffer[position];
+			unsigned int key = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16);
+			return (key * 2654435761U) >> (32 - UU_LZ77_HASH_BITS);
+		}
+
+		const unsigned char* buffer;
+		unsigned int bufferSize;
+		unsigned int insertPosition;
+		unsigned int windowSize;
+		unsigned int windowMask;
+		unsigned int maxChainLength;
+		unsigned int niceLength;
+		DArray<unsigned int> headArray;
+		DArray<unsigned int> prevArray;
+	};
+
+	/**
+	 * Copy a match of the given length from the given distance back.  The match may overlap
+	 * itself, as it does for runs, in which case the bytes it repeats are the ones it has just
+	 * written.  Up to UU_LZ77_COPY_SLACK bytes past the end of the match may be overwritten.
+	 */
+	inline void LZ77CopyMatch(unsigned char* output, unsigned int distance, unsigned int length)
+	{
+		const unsigned char* source = output - distance;
+		unsigned char* outputEnd = output + length;
+
+		if (distance >= 16)
+		{
+			do
+			{
+				UU_MEMCPY(output, source, 16);
+				output += 16;
+				source += 16;
+			} while (output < outputEnd);
+
+			return;
+		}
+
+		// Closer than a word apart, a wide copy would read bytes it hasn't written yet.  But the match
+		// repeats every distance bytes, so after a few bytes one at a time it can be copied from a
+		// whole number of repeats back instead, which is far enough away to copy a word at a time.
+		if (distance < 8)
+		{
+			unsigned int period = distance;
+			while (period < 8)
+				period += distance;
+
+			for (unsigned int i = period - distance; i > 0 && output < outputEnd; i--)
+				*output++ = *source++;
+
+			source = output - period;
+		}
+
+		while (output < outputEnd)
+		{
+			UU_MEMCPY(output, source, 8);
+			output += 8;
+			source += 8;
+		}
+	}
+}
\ No newline at end of file
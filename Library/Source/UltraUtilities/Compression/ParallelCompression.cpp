@@ -0,0 +1,372 @@
+#include "UltraUtilities/Compression/ParallelCompression.h"
+#include "UltraUtilities/Threading/Thread.h"
+
+using namespace UU;
+
+#define UU_PARALLEL_COMPRESSION_HEADER_SIZE			8
+#define UU_PARALLEL_COMPRESSION_BLOCK_HEADER_SIZE	8
+#define UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE	16
+#define UU_PARALLEL_COMPRESSION_TRAILER_SIZE		8
+
+static void StoreLittleEndian(char* buffer, unsigned long long value, unsigned int numBytes)
+{
+	for (unsigned int i = 0; i < numBytes; i++)
+		buffer[i] = (char)(value >> (8 * i));
+}
+
+static unsigned long long LoadLittleEndian(const char* buffer, unsigned int numBytes)
+{
+	unsigned long long value = 0;
+	for (unsigned int i = 0; i < numBytes; i++)
+		value |= (unsigned long long)(unsigned char)buffer[i] << (8 * i);
+	return value;
+}
+
+// The given stream may give us less than we ask for, so keep asking until we have it all or it has nothing more.
+static unsigned int ReadAllBytes(ByteStream* inputStream, char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesRead = 0;
+	while (numBytesRead < bufferSize)
+	{
+		unsigned int numBytes = inputStream->ReadBytes(buffer + numBytesRead, bufferSize - numBytesRead);
+		if (numBytes == 0)
+			break;
+
+		numBytesRead += numBytes;
+	}
+
+	return numBytesRead;
+}
+
+// Call the given function with each number below the given count, each on its own thread but the last, which is done on this one.
+template<typename F>
+static void RunInParallel(unsigned int count, F func)
+{
+	Thread* threadArray[UU_PARALLEL_COMPRESSION_MAX_THREADS];
+	unsigned int numThreads = 0;
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		auto job = [&func, i]()
+		{
+			func(i);
+		};
+
+		if (i < count - 1)
+		{
+			Thread* thread = new LambdaThread<decltype(job)>(job);
+			if (thread->Start())
+				threadArray[numThreads++] = thread;
+			else
+			{
+				delete thread;
+				job();
+			}
+		}
+		else
+			job();
+	}
+
+	for (unsigned int i = 0; i < numThreads; i++)
+	{
+		threadArray[i]->Join();
+		delete threadArray[i];
+	}
+}
+
+namespace UU
+{
+	// This is one block's worth of work for one thread.
+	class ParallelCompressionJob
+	{
+	public:
+		ParallelCompressionJob()
+		{
+			this->inputSize = 0;
+			this->outputSize = 0;
+			this->succeeded = false;
+		}
+
+		DArray<char> inputBuffer;
+		unsigned int inputSize;
+		DArray<char> outputBuffer;
+		unsigned int outputSize;
+		bool succeeded;
+	};
+}
+
+//----------------------------- ParallelCompression -----------------------------
+
+ParallelCompression::ParallelCompression(Compression* compression, unsigned int blockSize /*= UU_PARALLEL_COMPRESSION_BLOCK_SIZE*/, unsigned int numThreads /*= 0*/)
+{
+	this->compression = compression;
+	this->blockSize = (blockSize == 0) ? UU_PARALLEL_COMPRESSION_BLOCK_SIZE : blockSize;
+	this->numThreads = (numThreads == 0) ? Thread::GetNumProcessors() : numThreads;
+	this->numThreads = UU_MIN(this->numThreads, UU_PARALLEL_COMPRESSION_MAX_THREADS);
+}
+
+/*virtual*/ ParallelCompression::~ParallelCompression()
+{
+}
+
+/*virtual*/ bool ParallelCompression::Compress(ByteStream* inputStream, ByteStream* outputStream)
+{
+	if (inputStream == outputStream || !this->compression)
+		return false;
+
+	char header[UU_PARALLEL_COMPRESSION_HEADER_SIZE];
+	StoreLittleEndian(header, UU_PARALLEL_COMPRESSION_MAGIC, 4);
+	StoreLittleEndian(header + 4, this->blockSize, 4);
+	if (outputStream->WriteBytes(header, sizeof(header)) != sizeof(header))
+		return false;
+
+	DArray<ParallelCompressionJob> jobArray(this->numThreads);
+	DArray<BlockInfo> blockIndex;
+	unsigned long long offset = UU_PARALLEL_COMPRESSION_HEADER_SIZE;
+	bool endOfInput = false;
+
+	while (!endOfInput)
+	{
+		// Reading is done here, in order, while nothing else is running.
+		unsigned int numJobs = 0;
+		while (numJobs < this->numThreads)
+		{
+			ParallelCompressionJob& job = jobArray[numJobs];
+			job.inputBuffer.SetSize(this->blockSize);
+			job.inputSize = ReadAllBytes(inputStream, job.inputBuffer.GetBuffer(), this->blockSize);
+			if (job.inputSize < this->blockSize)
+				endOfInput = true;
+
+			if (job.inputSize > 0)
+				numJobs++;
+
+			if (endOfInput)
+				break;
+		}
+
+		Compression* compression = this->compression;
+		RunInParallel(numJobs, [&jobArray, compression](unsigned int i)
+		{
+			// Anything that doesn't come out smaller than it went in is stored instead.
+			ParallelCompressionJob& job = jobArray[i];
+			job.outputBuffer.SetSize(job.inputSize);
+			MemoryBufferStream blockInputStream(job.inputBuffer.GetBuffer(), job.inputSize, true);
+			MemoryBufferStream blockOutputStream(job.outputBuffer.GetBuffer(), job.inputSize, false);
+			if (compression->Compress(&blockInputStream, &blockOutputStream) && blockOutputStream.GetSize() < job.inputSize)
+				job.outputSize = blockOutputStream.GetSize();
+			else
+				job.outputSize = job.inputSize;
+		});
+
+		for (unsigned int i = 0; i < numJobs; i++)
+		{
+			ParallelCompressionJob& job = jobArray[i];
+
+			char blockHeader[UU_PARALLEL_COMPRESSION_BLOCK_HEADER_SIZE];
+			StoreLittleEndian(blockHeader, job.inputSize, 4);
+			StoreLittleEndian(blockHeader + 4, job.outputSize, 4);
+
+			ByteSegment segmentArray[2];
+			segmentArray[0].buffer = blockHeader;
+			segmentArray[0].bufferSize = sizeof(blockHeader);
+			segmentArray[1].buffer = (job.outputSize < job.inputSize) ? job.outputBuffer.GetBuffer() : job.inputBuffer.GetBuffer();
+			segmentArray[1].bufferSize = job.outputSize;
+			if (outputStream->WriteBytesV(segmentArray, 2) != sizeof(blockHeader) + job.outputSize)
+				return false;
+
+			offset += UU_PARALLEL_COMPRESSION_BLOCK_HEADER_SIZE;
+			blockIndex.Push(BlockInfo{ offset, job.outputSize, job.inputSize });
+			offset += job.outputSize;
+		}
+	}
+
+	char indexEntry[UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE];
+	StoreLittleEndian(indexEntry, 0, 4);
+	if (outputStream->WriteBytes(indexEntry, 4) != 4)
+		return false;
+
+	for (unsigned int i = 0; i < blockIndex.GetSize(); i++)
+	{
+		const BlockInfo& blockInfo = blockIndex[i];
+		StoreLittleEndian(indexEntry, blockInfo.offset, 8);
+		StoreLittleEndian(indexEntry + 8, blockInfo.compressedSize, 4);
+		StoreLittleEndian(indexEntry + 12, blockInfo.originalSize, 4);
+		if (outputStream->WriteBytes(indexEntry, sizeof(indexEntry)) != sizeof(indexEntry))
+			return false;
+	}
+
+	char trailer[UU_PARALLEL_COMPRESSION_TRAILER_SIZE];
+	StoreLittleEndian(trailer, blockIndex.GetSize(), 4);
+	StoreLittleEndian(trailer + 4, UU_PARALLEL_COMPRESSION_MAGIC, 4);
+	if (outputStream->WriteBytes(trailer, sizeof(trailer)) != sizeof(trailer))
+		return false;
+
+	return true;
+}
+
+/*virtual*/ bool ParallelCompression::Decompress(ByteStream* inputStream, ByteStream* outputStream)
+{
+	if (inputStream == outputStream || !this->compression)
+		return false;
+
+	char header[UU_PARALLEL_COMPRESSION_HEADER_SIZE];
+	if (ReadAllBytes(inputStream, header, sizeof(header)) != sizeof(header))
+		return false;
+
+	if (LoadLittleEndian(header, 4) != UU_PARALLEL_COMPRESSION_MAGIC)
+		return false;
+
+	// Blocks are read as they come, so the index isn't needed here except to make sure the frame is whole.
+	DArray<ParallelCompressionJob> jobArray(this->numThreads);
+	unsigned int numBlocks = 0;
+	bool endOfFrame = false;
+
+	while (!endOfFrame)
+	{
+		unsigned int numJobs = 0;
+		while (numJobs < this->numThreads)
+		{
+			char blockHeader[UU_PARALLEL_COMPRESSION_BLOCK_HEADER_SIZE];
+			if (ReadAllBytes(inputStream, blockHeader, 4) != 4)
+				return false;
+
+			unsigned int originalSize = (unsigned int)LoadLittleEndian(blockHeader, 4);
+			if (originalSize == 0)
+			{
+				endOfFrame = true;
+				break;
+			}
+
+			if (ReadAllBytes(inputStream, blockHeader + 4, 4) != 4)
+				return false;
+
+			unsigned int compressedSize = (unsigned int)LoadLittleEndian(blockHeader + 4, 4);
+			if (compressedSize > originalSize)
+				return false;
+
+			ParallelCompressionJob& job = jobArray[numJobs++];
+			job.inputBuffer.SetSize(compressedSize);
+			job.inputSize = compressedSize;
+			job.outputSize = originalSize;
+			if (ReadAllBytes(inputStream, job.inputBuffer.GetBuffer(), compressedSize) != compressedSize)
+				return false;
+		}
+
+		Compression* compression = this->compression;
+		RunInParallel(numJobs, [&jobArray, compression](unsigned int i)
+		{
+			ParallelCompressionJob& job = jobArray[i];
+			if (job.inputSize == job.outputSize)
+			{
+				job.succeeded = true;
+				return;
+			}
+
+			job.outputBuffer.SetSize(job.outputSize);
+			MemoryBufferStream blockInputStream(job.inputBuffer.GetBuffer(), job.inputSize, true);
+			MemoryBufferStream blockOutputStream(job.outputBuffer.GetBuffer(), job.outputSize, false);
+			job.succeeded = compression->Decompress(&blockInputStream, &blockOutputStream) && blockOutputStream.GetSize() == job.outputSize;
+		});
+
+		for (unsigned int i = 0; i < numJobs; i++)
+		{
+			const ParallelCompressionJob& job = jobArray[i];
+			if (!job.succeeded)
+				return false;
+
+			const char* blockData = (job.inputSize < job.outputSize) ? job.outputBuffer.GetBuffer() : job.inputBuffer.GetBuffer();
+			if (outputStream->WriteBytes(blockData, job.outputSize) != job.outputSize)
+				return false;
+		}
+
+		numBlocks += numJobs;
+	}
+
+	// Skip over the index, but make sure it's there and agrees about the number of blocks.
+	char indexEntry[UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE];
+	for (unsigned int i = 0; i < numBlocks; i++)
+		if (ReadAllBytes(inputStream, indexEntry, sizeof(indexEntry)) != sizeof(indexEntry))
+			return false;
+
+	char trailer[UU_PARALLEL_COMPRESSION_TRAILER_SIZE];
+	if (ReadAllBytes(inputStream, trailer, sizeof(trailer)) != sizeof(trailer))
+		return false;
+
+	if (LoadLittleEndian(trailer, 4) != numBlocks || LoadLittleEndian(trailer + 4, 4) != UU_PARALLEL_COMPRESSION_MAGIC)
+		return false;
+
+	return true;
+}
+
+/*static*/ bool ParallelCompression::FindBlockIndex(const char* frameBuffer, unsigned int frameSize, unsigned int& numBlocks, const char*& indexBuffer)
+{
+	if (!frameBuffer || frameSize < UU_PARALLEL_COMPRESSION_HEADER_SIZE + 4 + UU_PARALLEL_COMPRESSION_TRAILER_SIZE)
+		return false;
+
+	if (LoadLittleEndian(frameBuffer, 4) != UU_PARALLEL_COMPRESSION_MAGIC)
+		return false;
+
+	const char* trailer = frameBuffer + frameSize - UU_PARALLEL_COMPRESSION_TRAILER_SIZE;
+	if (LoadLittleEndian(trailer + 4, 4) != UU_PARALLEL_COMPRESSION_MAGIC)
+		return false;
+
+	numBlocks = (unsigned int)LoadLittleEndian(trailer, 4);
+	unsigned long long indexSize = (unsigned long long)numBlocks * UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE;
+	if (indexSize > frameSize - UU_PARALLEL_COMPRESSION_HEADER_SIZE - 4 - UU_PARALLEL_COMPRESSION_TRAILER_SIZE)
+		return false;
+
+	indexBuffer = trailer - indexSize;
+	return true;
+}
+
+/*static*/ bool ParallelCompression::ReadBlockIndex(const char* frameBuffer, unsigned int frameSize, DArray<BlockInfo>& blockIndex)
+{
+	unsigned int numBlocks = 0;
+	const char* indexBuffer = nullptr;
+	if (!FindBlockIndex(frameBuffer, frameSize, numBlocks, indexBuffer))
+		return false;
+
+	blockIndex.SetSize(numBlocks);
+	for (unsigned int i = 0; i < numBlocks; i++)
+	{
+		const char* indexEntry = indexBuffer + i * UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE;
+		BlockInfo& blockInfo = blockIndex[i];
+		blockInfo.offset = LoadLittleEndian(indexEntry, 8);
+		blockInfo.compressedSize = (unsigned int)LoadLittleEndian(indexEntry + 8, 4);
+		blockInfo.originalSize = (unsigned int)LoadLittleEndian(indexEntry + 12, 4);
+		if (blockInfo.offset + blockInfo.compressedSize > (unsigned long long)(indexBuffer - frameBuffer))
+			return false;
+	}
+
+	return true;
+}
+
+bool ParallelCompression::DecompressBlock(const char* frameBuffer, unsigned int frameSize, unsigned int blockNumber, ByteStream* outputStream)
+{
+	if (!this->compression)
+		return false;
+
+	unsigned int numBlocks = 0;
+	const char* indexBuffer = nullptr;
+	if (!FindBlockIndex(frameBuffer, frameSize, numBlocks, indexBuffer) || blockNumber >= numBlocks)
+		return false;
+
+	const char* indexEntry = indexBuffer + blockNumber * UU_PARALLEL_COMPRESSION_INDEX_ENTRY_SIZE;
+	unsigned long long offset = LoadLittleEndian(indexEntry, 8);
+	unsigned int compressedSize = (unsigned int)LoadLittleEndian(indexEntry + 8, 4);
+	unsigned int originalSize = (unsigned int)LoadLittleEndian(indexEntry + 12, 4);
+	if (offset + compressedSize > (unsigned long long)(indexBuffer - frameBuffer) || compressedSize > originalSize)
+		return false;
+
+	if (compressedSize == originalSize)
+		return outputStream->WriteBytes(frameBuffer + offset, compressedSize) == compressedSize;
+
+	// Like the blocks of a whole frame, this has to come out at exactly the size the index says, or the index is corrupt.
+	DArray<char> outputBuffer(originalSize);
+	MemoryBufferStream blockInputStream((char*)frameBuffer + offset, compressedSize, true);
+	MemoryBufferStream blockOutputStream(outputBuffer.GetBuffer(), originalSize, false);
+	if (!this->compression->Decompress(&blockInputStream, &blockOutputStream) || blockOutputStream.GetSize() != originalSize)
+		return false;
+
+	return outputStream->WriteBytes(outputBuffer.GetBuffer(), originalSize) == originalSize;
+}
\ No newline at end of file
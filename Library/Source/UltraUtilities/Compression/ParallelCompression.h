@@ -0,0 +1,92 @@
+#pragma once
+
+#include "UltraUtilities/Compression/Compression.h"
+#include "UltraUtilities/Containers/DArray.hpp"
+
+// This is the default amount of input compressed independently of the rest.
+#define UU_PARALLEL_COMPRESSION_BLOCK_SIZE		(1024 * 1024)
+
+// No more than this many blocks are worked on at once.
+#define UU_PARALLEL_COMPRESSION_MAX_THREADS		64
+
+// Frames begin and end with this, which is "UUPC" in memory.
+#define UU_PARALLEL_COMPRESSION_MAGIC			0x43505555
+
+namespace UU
+{
+	/**
+	 * This wraps another compression scheme so that it runs on many threads at once.  The input
+	 * is cut into blocks which are compressed independently of one another, as many at a time
+	 * as there are threads, and written out in order.  Blocks that don't get any smaller are
+	 * stored as they are.  After the blocks comes an index of where each one is, so that
+	 * decompression can also go a block per thread, and so that any one block can be
+	 * decompressed on its own without reading the others.
+	 *
+	 * A frame looks like this, with all numbers little-endian.
+	 *
+	 *     magic (4 bytes), block size (4 bytes)
+	 *     for each block: original size (4 bytes), compressed size (4 bytes), compressed data
+	 *     zero (4 bytes)
+	 *     for each block: offset of its data in the frame (8 bytes), compressed size (4 bytes), original size (4 bytes)
+	 *     number of blocks (4 bytes), magic (4 bytes)
+	 *
+	 * A block whose compressed size is the same as its original size was stored uncompressed.
+	 *
+	 * Memory use is about two blocks per thread.  The wrapped compression scheme is used from
+	 * several threads at once, so it must not change any of its own state as it runs, which
+	 * is true of all those in this library.  It is not owned by this class.
+	 */
+	class UU_API ParallelCompression : public Compression
+	{
+	public:
+		/**
+		 * This is what the index at the end of a frame says about each block.
+		 */
+		struct BlockInfo
+		{
+			unsigned long long offset;
+			unsigned int compressedSize;
+			unsigned int originalSize;
+		};
+
+		/**
+		 * @param[in] compression This does the actual compressing of each block.
+		 * @param[in] blockSize This is how big each block is, except perhaps the last.
+		 * @param[in] numThreads This is how many blocks to work on at once.  Zero means one per processor.
+		 */
+		ParallelCompression(Compression* compression, unsigned int blockSize = UU_PARALLEL_COMPRESSION_BLOCK_SIZE, unsigned int numThreads = 0);
+		virtual ~ParallelCompression();
+
+		virtual bool Compress(ByteStream* inputStream, ByteStream* outputStream) override;
+		virtual bool Decompress(ByteStream* inputStream, ByteStream* outputStream) override;
+
+		/**
+		 * Read the index at the end of the given frame.
+		 *
+		 * @param[in] frameBuffer This is the whole frame, as written by @ref Compress.
+		 * @param[in] frameSize This is the size of the given frame.
+		 * @param[out] blockIndex This is given one entry per block, in order.
+		 * @return False is returned if the frame is malformed.
+		 */
+		static bool ReadBlockIndex(const char* frameBuffer, unsigned int frameSize, DArray<BlockInfo>& blockIndex);
+
+		/**
+		 * Decompress only the given block of the given frame.  This finds the block through the
+		 * index, so it takes the same time no matter how many blocks come before it.
+		 *
+		 * @param[in] frameBuffer This is the whole frame, as written by @ref Compress.
+		 * @param[in] frameSize This is the size of the given frame.
+		 * @param[in] blockNumber This is which block to decompress, counting from zero.
+		 * @param[out] outputStream The decompressed block is written here.
+		 * @return False is returned if the frame is malformed or there is no such block.
+		 */
+		bool DecompressBlock(const char* frameBuffer, unsigned int frameSize, unsigned int blockNumber, ByteStream* outputStream);
+
+	private:
+		static bool FindBlockIndex(const char* frameBuffer, unsigned int frameSize, unsigned int& numBlocks, const char*& indexBuffer);
+
+		Compression* compression;
+		unsigned int blockSize;
+		unsigned int numThreads;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,720 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+namespace UU
+{
+	template<typename K, typename V, unsigned int NodeBytes> class BPlusTreeIterator;
+
+	/**
+	 * This is a B+ tree map from keys to values.  Unlike the @ref BTree class, whose
+	 * nodes point to keys allocated one at a time on the heap and compare them with
+	 * virtual calls, here the keys are stored right in the nodes, in an array that
+	 * (along with the node's key count) fits in the given number of bytes.  So when
+	 * a node is searched, it's searched within a cache line or two, and the only
+	 * pointer followed is the one down to the next node.
+	 *
+	 * Values are kept only in the leaves, so that the inner nodes can hold as many
+	 * keys as possible, and the leaves are linked together in key order, so that
+	 * going through a range of keys is a walk along the leaves and never goes back
+	 * up the tree.  See @ref LowerBound.
+	 *
+	 * Keys are compared with the less-than operator, and keys and values must both
+	 * be default-constructible and assignable, since nodes hold arrays of them.
+	 * Inserting or removing a pair can move other pairs from node to node, so
+	 * iterators are only valid until the next mutation.
+	 */
+	template<typename K, typename V, unsigned int NodeBytes = UU_CACHE_LINE_SIZE>
+	class UU_API BPlusTree
+	{
+		friend class BPlusTreeIterator<K, V, NodeBytes>;
+
+	public:
+		BPlusTree()
+		{
+			this->rootNode = nullptr;
+			this->numPairs = 0;
+		}
+
+		virtual ~BPlusTree()
+		{
+			this->Clear();
+		}
+
+		BPlusTree(const BPlusTree&) = delete;
+		void operator=(const BPlusTree&) = delete;
+
+		/**
+		 * This provides bracket-syntax access to the tree.
+		 * Note that if you ask for the value of a key that
+		 * does not exist in the tree, then you may get an
+		 * uninitialized value if the value type does not
+		 * have a constructor.
+		 */
+		V operator[](K key)
+		{
+			V value;
+			this->Find(key, &value);
+			return value;
+		}
+
+		/**
+		 * Find a value by key.  If a value pointer is not given,
+		 * then this method can be used to check for existence
+		 * of a given key in the tree.
+		 */
+		bool Find(K key, V* value = nullptr)
+		{
+			if (!this->rootNode)
+				return false;
+
+			LeafNode* leafNode = this->FindLeaf(key);
+			unsigned int i = FindKeyIndex(leafNode, key);
+			if (i == leafNode->numKeys || key < leafNode->keyArray[i])
+				return false;
+
+			if (value)
+				*value = leafNode->valueArray[i];
+
+			return true;
+		}
+
+		/**
+		 * Insert a value at the given key.  If a value already
+		 * exists at the given key, it is replaced.
+		 */
+		bool Insert(K key, V value)
+		{
+			if (!this->rootNode)
+			{
+				LeafNode* leafNode = new LeafNode();
+				leafNode->isLeaf = true;
+				this->rootNode = leafNode;
+			}
+
+			K splitKey;
+			Node* splitNode = nullptr;
+			if (this->InsertIntoNode(this->rootNode, key, value, splitKey, splitNode))
+				this->numPairs++;
+
+			// The tree only ever grows in height at the root, which is what keeps all the leaves at the same depth.
+			if (splitNode)
+			{
+				InternalNode* internalNode = new InternalNode();
+				internalNode->isLeaf = false;
+				internalNode->numKeys = 1;
+				internalNode->keyArray[0] = splitKey;
+				internalNode->childArray[0] = this->rootNode;
+				internalNode->childArray[1] = splitNode;
+				this->rootNode = internalNode;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Remove the value at the given key, if any.
+		 * The value at the given key is returned if desired.
+		 */
+		bool Remove(K key, V* value = nullptr)
+		{
+			if (!this->rootNode || !this->RemoveFromNode(this->rootNode, key, value))
+				return false;
+
+			this->numPairs--;
+
+			// The tree only ever shrinks in height at the root too.
+			if (this->rootNode->numKeys == 0)
+			{
+				Node* node = this->rootNode;
+				this->rootNode = node->isLeaf ? nullptr : static_cast<InternalNode*>(node)->childArray[0];
+				DeleteNode(node);
+			}
+
+			return true;
+		}
+
+		/**
+		 * Remove all key/value pairs.
+		 */
+		void Clear()
+		{
+			if (this->rootNode)
+				DeleteSubTree(this->rootNode);
+
+			this->rootNode = nullptr;
+			this->numPairs = 0;
+		}
+
+		/**
+		 * Indicate how many key/value pairs are stored in the tree.
+		 */
+		unsigned int GetNumPairs() const { return this->numPairs; }
+
+		/**
+		 * Indicate the most keys a node can hold.  Nodes other than the root always hold at least half this many.
+		 */
+		static constexpr unsigned int GetMaxKeysPerNode() { return BPLUS_TREE_MAX_KEYS; }
+
+		/**
+		 * Return an iterator at the first pair whose key is not less than the given key.  Iterating
+		 * from there goes through the rest of the pairs in key order.  The end iterator is returned
+		 * if every key is less than the given key.
+		 */
+		BPlusTreeIterator<K, V, NodeBytes> LowerBound(K key)
+		{
+			if (!this->rootNode)
+				return this->end();
+
+			LeafNode* leafNode = this->FindLeaf(key);
+			unsigned int i = FindKeyIndex(leafNode, key);
+			if (i == leafNode->numKeys)
+				return BPlusTreeIterator<K, V, NodeBytes>(leafNode->nextLeafNode, 0);
+
+			return BPlusTreeIterator<K, V, NodeBytes>(leafNode, i);
+		}
+
+		/**
+		 * This is provided to support the ranged for-loop syntax.  Pairs are visited in key order.
+		 */
+		BPlusTreeIterator<K, V, NodeBytes> begin()
+		{
+			if (!this->rootNode)
+				return this->end();
+
+			Node* node = this->rootNode;
+			while (!node->isLeaf)
+				node = static_cast<InternalNode*>(node)->childArray[0];
+
+			return BPlusTreeIterator<K, V, NodeBytes>(static_cast<LeafNode*>(node), 0);
+		}
+
+		/**
+		 * This is the end sentinal for the ranged for-loop support.
+		 */
+		BPlusTreeIterator<K, V, NodeBytes> end()
+		{
+			return BPlusTreeIterator<K, V, NodeBytes>(nullptr, 0);
+		}
+
+		/**
+		 * This is provided merely for diagnostic purposes to verify that the tree is
+		 * a proper B+ tree.  That is, that the keys are in order, every node but the
+		 * root is at least half full, all leaves are at the same depth, and the leaves
+		 * are linked together in order.
+		 */
+		bool IsValid() const
+		{
+			if (!this->rootNode)
+				return this->numPairs == 0;
+
+			int leafDepth = -1;
+			if (!IsSubTreeValid(this->rootNode, nullptr, nullptr, 0, leafDepth))
+				return false;
+
+			const Node* node = this->rootNode;
+			while (!node->isLeaf)
+				node = static_cast<const InternalNode*>(node)->childArray[0];
+
+			unsigned int numPairsFound = 0;
+			const LeafNode* previousLeafNode = nullptr;
+			for (const LeafNode* leafNode = static_cast<const LeafNode*>(node); leafNode; leafNode = leafNode->nextLeafNode)
+			{
+				if (leafNode->previousLeafNode != previousLeafNode)
+					return false;
+
+				if (previousLeafNode && !(previousLeafNode->keyArray[previousLeafNode->numKeys - 1] < leafNode->keyArray[0]))
+					return false;
+
+				numPairsFound += leafNode->numKeys;
+				previousLeafNode = leafNode;
+			}
+
+			return numPairsFound == this->numPairs;
+		}
+
+	private:
+		// Keys follow the key count and leaf flag, so as many keys fit in a node as what's left of its bytes allows.
+		static constexpr unsigned int BPLUS_TREE_KEY_OFFSET = UU_MAX((unsigned int)(sizeof(unsigned int) * 2), (unsigned int)alignof(K));
+		static constexpr unsigned int BPLUS_TREE_MAX_KEYS = UU_MAX((NodeBytes > BPLUS_TREE_KEY_OFFSET) ? (unsigned int)((NodeBytes - BPLUS_TREE_KEY_OFFSET) / sizeof(K)) : 0, 3u);
+		static constexpr unsigned int BPLUS_TREE_MIN_KEYS = BPLUS_TREE_MAX_KEYS / 2;
+
+		struct alignas(UU_CACHE_LINE_SIZE) Node
+		{
+			unsigned int numKeys = 0;
+			bool isLeaf = false;
+			K keyArray[BPLUS_TREE_MAX_KEYS];
+		};
+
+		// Child i holds the keys from key i-1 (inclusive) up to key i (exclusive).
+		struct InternalNode : public Node
+		{
+			Node* childArray[BPLUS_TREE_MAX_KEYS + 1];
+		};
+
+		struct LeafNode : public Node
+		{
+			LeafNode* nextLeafNode = nullptr;
+			LeafNode* previousLeafNode = nullptr;
+			V valueArray[BPLUS_TREE_MAX_KEYS];
+		};
+
+		/**
+		 * Return the index of the first key in the given node that isn't less than the given key.
+		 */
+		static unsigned int FindKeyIndex(const Node* node, const K& key)
+		{
+			unsigned int low = 0;
+			unsigned int high = node->numKeys;
+			while (low < high)
+			{
+				unsigned int mid = (low + high) / 2;
+				if (node->keyArray[mid] < key)
+					low = mid + 1;
+				else
+					high = mid;
+			}
+
+			return low;
+		}
+
+		/**
+		 * Return the index of the child of the given node under which the given key belongs.
+		 */
+		static unsigned int FindChildIndex(const InternalNode* node, const K& key)
+		{
+			unsigned int low = 0;
+			unsigned int high = node->numKeys;
+			while (low < high)
+			{
+				unsigned int mid = (low + high) / 2;
+				if (key < node->keyArray[mid])
+					high = mid;
+				else
+					low = mid + 1;
+			}
+
+			return low;
+		}
+
+		LeafNode* FindLeaf(const K& key)
+		{
+			Node* node = this->rootNode;
+			while (!node->isLeaf)
+			{
+				InternalNode* internalNode = static_cast<InternalNode*>(node);
+				node = internalNode->childArray[FindChildIndex(internalNode, key)];
+			}
+
+			return static_cast<LeafNode*>(node);
+		}
+
+		static void DeleteNode(Node* node)
+		{
+			if (node->isLeaf)
+				delete static_cast<LeafNode*>(node);
+			else
+				delete static_cast<InternalNode*>(node);
+		}
+
+		static void DeleteSubTree(Node* node)
+		{
+			if (!node->isLeaf)
+			{
+				InternalNode* internalNode = static_cast<InternalNode*>(node);
+				for (unsigned int i = 0; i <= internalNode->numKeys; i++)
+					DeleteSubTree(internalNode->childArray[i]);
+			}
+
+			DeleteNode(node);
+		}
+
+		/**
+		 * Insert the given pair somewhere under the given node.  If the node has to be split to make room,
+		 * its upper half is given back along with the smallest key under it, for the caller to insert.
+		 *
+		 * @return True is returned if a new pair was added, or false if an existing pair was given the value.
+		 */
+		bool InsertIntoNode(Node* node, const K& key, const V& value, K& splitKey, Node*& splitNode)
+		{
+			splitNode = nullptr;
+
+			if (node->isLeaf)
+			{
+				LeafNode* leafNode = static_cast<LeafNode*>(node);
+				unsigned int i = FindKeyIndex(leafNode, key);
+				if (i < leafNode->numKeys && !(key < leafNode->keyArray[i]))
+				{
+					leafNode->valueArray[i] = value;
+					return false;
+				}
+
+				if (leafNode->numKeys < BPLUS_TREE_MAX_KEYS)
+				{
+					InsertIntoLeaf(leafNode, i, key, value);
+					return true;
+				}
+
+				// Split the pairs, counting the new one, as evenly as we can, with the new leaf on the right.
+				LeafNode* newLeafNode = new LeafNode();
+				newLeafNode->isLeaf = true;
+				unsigned int numLeftKeys = (BPLUS_TREE_MAX_KEYS + 1) / 2;
+				unsigned int numKeysKept = (i < numLeftKeys) ? numLeftKeys - 1 : numLeftKeys;
+				for (unsigned int j = numKeysKept; j < BPLUS_TREE_MAX_KEYS; j++)
+				{
+					newLeafNode->keyArray[j - numKeysKept] = static_cast<K&&>(leafNode->keyArray[j]);
+					newLeafNode->valueArray[j - numKeysKept] = static_cast<V&&>(leafNode->valueArray[j]);
+				}
+
+				newLeafNode->numKeys = BPLUS_TREE_MAX_KEYS - numKeysKept;
+				leafNode->numKeys = numKeysKept;
+
+				if (i < numLeftKeys)
+					InsertIntoLeaf(leafNode, i, key, value);
+				else
+					InsertIntoLeaf(newLeafNode, i - numLeftKeys, key, value);
+
+				newLeafNode->nextLeafNode = leafNode->nextLeafNode;
+				newLeafNode->previousLeafNode = leafNode;
+				if (leafNode->nextLeafNode)
+					leafNode->nextLeafNode->previousLeafNode = newLeafNode;
+				leafNode->nextLeafNode = newLeafNode;
+
+				splitKey = newLeafNode->keyArray[0];
+				splitNode = newLeafNode;
+				return true;
+			}
+
+			InternalNode* internalNode = static_cast<InternalNode*>(node);
+			unsigned int i = FindChildIndex(internalNode, key);
+
+			K childSplitKey;
+			Node* childSplitNode = nullptr;
+			bool inserted = this->InsertIntoNode(internalNode->childArray[i], key, value, childSplitKey, childSplitNode);
+			if (!childSplitNode)
+				return inserted;
+
+			if (internalNode->numKeys < BPLUS_TREE_MAX_KEYS)
+			{
+				InsertIntoInternal(internalNode, i, childSplitKey, childSplitNode);
+				return inserted;
+			}
+
+			// Lay out all the keys and children, counting the new ones, then give the middle key to the caller
+			// and split the rest either side of it.  Unlike in a leaf, the middle key doesn't stay down here.
+			K keyArray[BPLUS_TREE_MAX_KEYS + 1];
+			Node* childArray[BPLUS_TREE_MAX_KEYS + 2];
+			for (unsigned int j = 0; j < i; j++)
+				keyArray[j] = static_cast<K&&>(internalNode->keyArray[j]);
+			keyArray[i] = childSplitKey;
+			for (unsigned int j = i; j < BPLUS_TREE_MAX_KEYS; j++)
+				keyArray[j + 1] = static_cast<K&&>(internalNode->keyArray[j]);
+			for (unsigned int j = 0; j <= i; j++)
+				childArray[j] = internalNode->childArray[j];
+			childArray[i + 1] = childSplitNode;
+			for (unsigned int j = i + 1; j <= BPLUS_TREE_MAX_KEYS; j++)
+				childArray[j + 1] = internalNode->childArray[j];
+
+			InternalNode* newInternalNode = new InternalNode();
+			newInternalNode->isLeaf = false;
+			unsigned int middle = (BPLUS_TREE_MAX_KEYS + 1) / 2;
+
+			internalNode->numKeys = middle;
+			for (unsigned int j = 0; j < middle; j++)
+				internalNode->keyArray[j] = static_cast<K&&>(keyArray[j]);
+			for (unsigned int j = 0; j <= middle; j++)
+				internalNode->childArray[j] = childArray[j];
+
+			newInternalNode->numKeys = BPLUS_TREE_MAX_KEYS - middle;
+			for (unsigned int j = middle + 1; j <= BPLUS_TREE_MAX_KEYS; j++)
+				newInternalNode->keyArray[j - middle - 1] = static_cast<K&&>(keyArray[j]);
+			for (unsigned int j = middle + 1; j <= BPLUS_TREE_MAX_KEYS + 1; j++)
+				newInternalNode->childArray[j - middle - 1] = childArray[j];
+
+			splitKey = static_cast<K&&>(keyArray[middle]);
+			splitNode = newInternalNode;
+			return inserted;
+		}
+
+		static void InsertIntoLeaf(LeafNode* leafNode, unsigned int i, const K& key, const V& value)
+		{
+			for (unsigned int j = leafNode->numKeys; j > i; j--)
+			{
+				leafNode->keyArray[j] = static_cast<K&&>(leafNode->keyArray[j - 1]);
+				leafNode->valueArray[j] = static_cast<V&&>(leafNode->valueArray[j - 1]);
+			}
+
+			leafNode->keyArray[i] = key;
+			leafNode->valueArray[i] = value;
+			leafNode->numKeys++;
+		}
+
+		/**
+		 * Put the given key at the given index of the given node, with the given child to the right of it.
+		 */
+		static void InsertIntoInternal(InternalNode* internalNode, unsigned int i, const K& key, Node* childNode)
+		{
+			for (unsigned int j = internalNode->numKeys; j > i; j--)
+			{
+				internalNode->keyArray[j] = static_cast<K&&>(internalNode->keyArray[j - 1]);
+				internalNode->childArray[j + 1] = internalNode->childArray[j];
+			}
+
+			internalNode->keyArray[i] = key;
+			internalNode->childArray[i + 1] = childNode;
+			internalNode->numKeys++;
+		}
+
+		/**
+		 * Take the key at the given index out of the given node, along with the child to the right of it.
+		 */
+		static void RemoveFromInternal(InternalNode* internalNode, unsigned int i)
+		{
+			for (unsigned int j = i; j + 1 < internalNode->numKeys; j++)
+			{
+				internalNode->keyArray[j] = static_cast<K&&>(internalNode->keyArray[j + 1]);
+				internalNode->childArray[j + 1] = internalNode->childArray[j + 2];
+			}
+
+			internalNode->numKeys--;
+		}
+
+		/**
+		 * Remove the pair with the given key from under the given node.  Any child
+		 * left less than half full on the way back up is topped up or merged away.
+		 */
+		bool RemoveFromNode(Node* node, const K& key, V* value)
+		{
+			if (node->isLeaf)
+			{
+				LeafNode* leafNode = static_cast<LeafNode*>(node);
+				unsigned int i = FindKeyIndex(leafNode, key);
+				if (i == leafNode->numKeys || key < leafNode->keyArray[i])
+					return false;
+
+				if (value)
+					*value = static_cast<V&&>(leafNode->valueArray[i]);
+
+				for (unsigned int j = i; j + 1 < leafNode->numKeys; j++)
+				{
+					leafNode->keyArray[j] = static_cast<K&&>(leafNode->keyArray[j + 1]);
+					leafNode->valueArray[j] = static_cast<V&&>(leafNode->valueArray[j + 1]);
+				}
+
+				leafNode->numKeys--;
+				return true;
+			}
+
+			InternalNode* internalNode = static_cast<InternalNode*>(node);
+			unsigned int i = FindChildIndex(internalNode, key);
+			if (!this->RemoveFromNode(internalNode->childArray[i], key, value))
+				return false;
+
+			if (internalNode->childArray[i]->numKeys < BPLUS_TREE_MIN_KEYS)
+				Rebalance(internalNode, i);
+
+			return true;
+		}
+
+		/**
+		 * The given child of the given node has too few keys.  Borrow one from a sibling if a sibling can spare one.
+		 * Otherwise, merge the child with a sibling.  Either way, the node's keys are kept up to date with its children.
+		 */
+		static void Rebalance(InternalNode* parentNode, unsigned int i)
+		{
+			Node* childNode = parentNode->childArray[i];
+			Node* leftNode = (i > 0) ? parentNode->childArray[i - 1] : nullptr;
+			Node* rightNode = (i < parentNode->numKeys) ? parentNode->childArray[i + 1] : nullptr;
+
+			if (childNode->isLeaf)
+			{
+				LeafNode* childLeafNode = static_cast<LeafNode*>(childNode);
+
+				if (leftNode && leftNode->numKeys > BPLUS_TREE_MIN_KEYS)
+				{
+					LeafNode* leftLeafNode = static_cast<LeafNode*>(leftNode);
+					unsigned int j = leftLeafNode->numKeys - 1;
+					InsertIntoLeaf(childLeafNode, 0, leftLeafNode->keyArray[j], leftLeafNode->valueArray[j]);
+					leftLeafNode->numKeys--;
+					parentNode->keyArray[i - 1] = childLeafNode->keyArray[0];
+				}
+				else if (rightNode && rightNode->numKeys > BPLUS_TREE_MIN_KEYS)
+				{
+					LeafNode* rightLeafNode = static_cast<LeafNode*>(rightNode);
+					InsertIntoLeaf(childLeafNode, childLeafNode->numKeys, rightLeafNode->keyArray[0], rightLeafNode->valueArray[0]);
+					for (unsigned int j = 0; j + 1 < rightLeafNode->numKeys; j++)
+					{
+						rightLeafNode->keyArray[j] = static_cast<K&&>(rightLeafNode->keyArray[j + 1]);
+						rightLeafNode->valueArray[j] = static_cast<V&&>(rightLeafNode->valueArray[j + 1]);
+					}
+					rightLeafNode->numKeys--;
+					parentNode->keyArray[i] = rightLeafNode->keyArray[0];
+				}
+				else
+				{
+					unsigned int j = leftNode ? i - 1 : i;
+					LeafNode* destinationNode = static_cast<LeafNode*>(parentNode->childArray[j]);
+					LeafNode* sourceNode = static_cast<LeafNode*>(parentNode->childArray[j + 1]);
+					for (unsigned int k = 0; k < sourceNode->numKeys; k++)
+					{
+						destinationNode->keyArray[destinationNode->numKeys + k] = static_cast<K&&>(sourceNode->keyArray[k]);
+						destinationNode->valueArray[destinationNode->numKeys + k] = static_cast<V&&>(sourceNode->valueArray[k]);
+					}
+					destinationNode->numKeys += sourceNode->numKeys;
+
+					destinationNode->nextLeafNode = sourceNode->nextLeafNode;
+					if (sourceNode->nextLeafNode)
+						sourceNode->nextLeafNode->previousLeafNode = destinationNode;
+
+					RemoveFromInternal(parentNode, j);
+					delete sourceNode;
+				}
+			}
+			else
+			{
+				InternalNode* childInternalNode = static_cast<InternalNode*>(childNode);
+
+				// Borrowing rotates a key through the parent, and the child that goes with it comes across directly.
+				if (leftNode && leftNode->numKeys > BPLUS_TREE_MIN_KEYS)
+				{
+					InternalNode* leftInternalNode = static_cast<InternalNode*>(leftNode);
+					childInternalNode->childArray[childInternalNode->numKeys + 1] = childInternalNode->childArray[childInternalNode->numKeys];
+					for (unsigned int j = childInternalNode->numKeys; j > 0; j--)
+					{
+						childInternalNode->keyArray[j] = static_cast<K&&>(childInternalNode->keyArray[j - 1]);
+						childInternalNode->childArray[j] = childInternalNode->childArray[j - 1];
+					}
+					childInternalNode->keyArray[0] = static_cast<K&&>(parentNode->keyArray[i - 1]);
+					childInternalNode->childArray[0] = leftInternalNode->childArray[leftInternalNode->numKeys];
+					childInternalNode->numKeys++;
+					parentNode->keyArray[i - 1] = static_cast<K&&>(leftInternalNode->keyArray[leftInternalNode->numKeys - 1]);
+					leftInternalNode->numKeys--;
+				}
+				else if (rightNode && rightNode->numKeys > BPLUS_TREE_MIN_KEYS)
+				{
+					InternalNode* rightInternalNode = static_cast<InternalNode*>(rightNode);
+					childInternalNode->keyArray[childInternalNode->numKeys] = static_cast<K&&>(parentNode->keyArray[i]);
+					childInternalNode->childArray[childInternalNode->numKeys + 1] = rightInternalNode->childArray[0];
+					childInternalNode->numKeys++;
+					parentNode->keyArray[i] = static_cast<K&&>(rightInternalNode->keyArray[0]);
+					for (unsigned int j = 0; j + 1 < rightInternalNode->numKeys; j++)
+					{
+						rightInternalNode->keyArray[j] = static_cast<K&&>(rightInternalNode->keyArray[j + 1]);
+						rightInternalNode->childArray[j] = rightInternalNode->childArray[j + 1];
+					}
+					rightInternalNode->childArray[rightInternalNode->numKeys - 1] = rightInternalNode->childArray[rightInternalNode->numKeys];
+					rightInternalNode->numKeys--;
+				}
+				else
+				{
+					// Merging brings the key between the two nodes down from the parent.
+					unsigned int j = leftNode ? i - 1 : i;
+					InternalNode* destinationNode = static_cast<InternalNode*>(parentNode->childArray[j]);
+					InternalNode* sourceNode = static_cast<InternalNode*>(parentNode->childArray[j + 1]);
+					destinationNode->keyArray[destinationNode->numKeys] = parentNode->keyArray[j];
+					for (unsigned int k = 0; k < sourceNode->numKeys; k++)
+						destinationNode->keyArray[destinationNode->numKeys + 1 + k] = static_cast<K&&>(sourceNode->keyArray[k]);
+					for (unsigned int k = 0; k <= sourceNode->numKeys; k++)
+						destinationNode->childArray[destinationNode->numKeys + 1 + k] = sourceNode->childArray[k];
+					destinationNode->numKeys += 1 + sourceNode->numKeys;
+
+					RemoveFromInternal(parentNode, j);
+					delete sourceNode;
+				}
+			}
+		}
+
+		static bool IsSubTreeValid(const Node* node, const K* lowerKey, const K* upperKey, int depth, int& leafDepth)
+		{
+			if (node->numKeys > BPLUS_TREE_MAX_KEYS)
+				return false;
+
+			if (depth > 0 && node->numKeys < BPLUS_TREE_MIN_KEYS)
+				return false;
+
+			for (unsigned int i = 0; i < node->numKeys; i++)
+			{
+				if (i > 0 && !(node->keyArray[i - 1] < node->keyArray[i]))
+					return false;
+
+				if (lowerKey && node->keyArray[i] < *lowerKey)
+					return false;
+
+				if (upperKey && !(node->keyArray[i] < *upperKey))
+					return false;
+			}
+
+			if (node->isLeaf)
+			{
+				if (leafDepth == -1)
+					leafDepth = depth;
+
+				return leafDepth == depth && node->numKeys > 0;
+			}
+
+			const InternalNode* internalNode = static_cast<const InternalNode*>(node);
+			for (unsigned int i = 0; i <= internalNode->numKeys; i++)
+			{
+				const K* childLowerKey = (i > 0) ? &internalNode->keyArray[i - 1] : lowerKey;
+				const K* childUpperKey = (i < internalNode->numKeys) ? &internalNode->keyArray[i] : upperKey;
+				if (!IsSubTreeValid(internalNode->childArray[i], childLowerKey, childUpperKey, depth + 1, leafDepth))
+					return false;
+			}
+
+			return true;
+		}
+
+		Node* rootNode;
+		unsigned int numPairs;
+	};
+
+	/**
+	 * This is used internally by the @ref BPlusTree class to
+	 * support ranged for-loop syntax in C++, and to go through
+	 * ranges of keys.  It walks along the leaves in key order.
+	 */
+	template<typename K, typename V, unsigned int NodeBytes>
+	class UU_API BPlusTreeIterator
+	{
+		typedef typename BPlusTree<K, V, NodeBytes>::LeafNode LeafNode;
+
+	public:
+		struct Pair
+		{
+			K key;
+			V value;
+		};
+
+		BPlusTreeIterator(LeafNode* leafNode, unsigned int i)
+		{
+			this->leafNode = leafNode;
+			this->i = i;
+		}
+
+		void operator++()
+		{
+			if (++this->i == this->leafNode->numKeys)
+			{
+				this->leafNode = this->leafNode->nextLeafNode;
+				this->i = 0;
+			}
+		}
+
+		bool operator==(const BPlusTreeIterator& iterator) const
+		{
+			return this->leafNode == iterator.leafNode && this->i == iterator.i;
+		}
+
+		Pair operator*()
+		{
+			Pair pair;
+			pair.key = this->leafNode->keyArray[this->i];
+			pair.value = this->leafNode->valueArray[this->i];
+			return pair;
+		}
+
+	private:
+		LeafNode* leafNode;
+		unsigned int i;
+	};
+}
\ No newline at end of file
@@ -22,6 +22,9 @@ namespace UU
 	 * In particular, if a key's left and right child have minimal degree, then the
 	 * key can be pushed down into a node that merges the left and right child.  This
 	 * is sometimes done during key removal, but I don't see any reason to do it.
+	 *
+	 * For plain keys like integers, see the @ref BPlusTree class, which keeps its
+	 * keys in its nodes rather than in separate allocations.
 	 */
 	class UU_API BTree
 	{
@@ -1,10 +1,36 @@
 #pragma once
 
 #include "UltraUtilities/Defines.h"
+#include <new>
+
+/**
+ * When this is nonzero, the bracket operators of @ref DArray assert that the given
+ * index is in range, and wrap it into range if not.  Otherwise they index straight
+ * into the buffer with no division and no branch, which lets loops over arrays be
+ * unrolled and vectorized.  It's on in debug builds and off in release builds by default.
+ */
+#if !defined UU_DARRAY_CHECKED
+#	if defined NDEBUG
+#		define UU_DARRAY_CHECKED		0
+#	else
+#		define UU_DARRAY_CHECKED		1
+#	endif
+#endif
+
+// Ranges smaller than this are sorted with insertion sort.
+#define UU_DARRAY_INSERTION_SORT_THRESHOLD			24
+
+// Ranges larger than this choose their quicksort pivot from nine values instead of three.
+#define UU_DARRAY_NINTHER_THRESHOLD					128
+
+// This many moves is as much as we'll put into an insertion sort that's just a guess.
+#define UU_DARRAY_PARTIAL_INSERTION_SORT_LIMIT		8
 
 namespace UU
 {
+	template<typename V> class DArray;
 	template<typename V> class DArrayIterator;
+	template<typename V, typename P> void ParallelSort(DArray<V>& array, P predicate);
 
 	/**
 	 * These are dynamic arrays.
@@ -12,71 +38,94 @@ namespace UU
 	template<typename V>
 	class UU_API DArray
 	{
+		template<typename T, typename P> friend void ParallelSort(DArray<T>& array, P predicate);
+
 	public:
 		DArray(unsigned int size = 0)
 		{
 			this->iterationDirection = DArrayIterator<V>::Direction::FORWARD;
 			this->bufferSize = (size == 0) ? 1 : size;
-			this->buffer = new V[this->bufferSize];
-			this->arraySize = size;
+			this->buffer = AllocateBuffer(this->bufferSize);
+			this->arraySize = 0;
+			this->SetSize(size);
 		}
 
 		DArray(const DArray& array)
 		{
 			this->iterationDirection = DArrayIterator<V>::Direction::FORWARD;
 			this->bufferSize = array.bufferSize;
-			this->arraySize = array.arraySize;
-			this->buffer = new V[array.bufferSize];
-			for (unsigned int i = 0; i < array.arraySize; i++)
-				this->buffer[i] = array.buffer[i];
+			this->arraySize = 0;
+			this->buffer = AllocateBuffer(array.bufferSize);
+			this->CopyConstruct(array.buffer, array.arraySize);
 		}
 
 		DArray(DArray&& array)
 		{
+			this->iterationDirection = DArrayIterator<V>::Direction::FORWARD;
 			this->bufferSize = array.bufferSize;
 			this->arraySize = array.arraySize;
 			this->buffer = array.buffer;
 			array.buffer = nullptr;
+			array.bufferSize = 0;
+			array.arraySize = 0;
 		}
 
 		DArray(const V* givenBuffer, unsigned int givenBufferSize)
 		{
-			this->bufferSize = givenBufferSize;
-			this->arraySize = givenBufferSize;
-			this->buffer = new V[givenBufferSize];
-			for (unsigned int i = 0; i < givenBufferSize; i++)
-				this->buffer[i] = givenBuffer[i];
+			this->iterationDirection = DArrayIterator<V>::Direction::FORWARD;
+			this->bufferSize = (givenBufferSize == 0) ? 1 : givenBufferSize;
+			this->arraySize = 0;
+			this->buffer = AllocateBuffer(this->bufferSize);
+			this->CopyConstruct(givenBuffer, givenBufferSize);
 		}
 
 		virtual ~DArray()
 		{
-			delete[] this->buffer;
+			this->SetSize(0);
+			FreeBuffer(this->buffer);
 		}
 
 		void operator=(const DArray& array)
 		{
+			if (this == &array)
+				return;
+			this->SetSize(0);
 			this->EnsureCapacity(array.arraySize);
-			this->SetSize(array.arraySize);
-			for (unsigned int i = 0; i < array.arraySize; i++)
-				this->buffer[i] = array.buffer[i];
+			this->CopyConstruct(array.buffer, array.arraySize);
 		}
 
 		void operator=(DArray&& array)
 		{
+			if (this == &array)
+				return;
+			this->SetSize(0);
+			FreeBuffer(this->buffer);
 			this->bufferSize = array.bufferSize;
 			this->arraySize = array.arraySize;
 			this->buffer = array.buffer;
 			array.buffer = nullptr;
+			array.bufferSize = 0;
+			array.arraySize = 0;
 		}
 
 		V& operator[](unsigned int i)
 		{
+#if UU_DARRAY_CHECKED
+			UU_ASSERT(i < this->arraySize);
 			return this->buffer[i % this->arraySize];
+#else
+			return this->buffer[i];
+#endif
 		}
 
 		const V& operator[](unsigned int i) const
 		{
+#if UU_DARRAY_CHECKED
+			UU_ASSERT(i < this->arraySize);
 			return this->buffer[i % this->arraySize];
+#else
+			return this->buffer[i];
+#endif
 		}
 
 		/**
@@ -87,7 +136,7 @@ namespace UU
 			if (this->arraySize == this->bufferSize)
 				this->SetCapacity(this->bufferSize * 2);
 
-			this->buffer[this->arraySize++] = value;
+			new (&this->buffer[this->arraySize++]) V(static_cast<V&&>(value));
 		}
 
 		/**
@@ -98,8 +147,8 @@ namespace UU
 			if (this->arraySize == 0)
 				return false;
 			if (value)
-				*value = this->buffer[this->arraySize - 1];
-			this->arraySize--;
+				*value = static_cast<V&&>(this->buffer[this->arraySize - 1]);
+			this->buffer[--this->arraySize].~V();
 			return true;
 		}
 
@@ -131,13 +180,17 @@ namespace UU
 		/**
 		 * Set the number of elements in this array.  If the new size is smaller,
 		 * elements are lost.  If the new size is larger, then uninitialized
-		 * elements are added to the array.
+		 * elements are added to the array.  (That is, they're default-initialized,
+		 * which for types without a constructor means uninitialized.)
 		 */
 		void SetSize(unsigned int size)
 		{
 			if (size > this->bufferSize)
 				this->SetCapacity(size);
-			this->arraySize = size;
+			while (this->arraySize < size)
+				new (&this->buffer[this->arraySize++]) V;
+			while (this->arraySize > size)
+				this->buffer[--this->arraySize].~V();
 		}
 
 		unsigned int GetCapacity() const
@@ -145,15 +198,32 @@ namespace UU
 			return this->bufferSize;
 		}
 
+		/**
+		 * Reallocate this array's buffer to hold the given number of elements.
+		 * Only the elements in use are carried over to the new buffer, and they're
+		 * moved rather than copied.  Unused capacity is left as raw memory.
+		 */
 		bool SetCapacity(unsigned int capacity)
 		{
-			// STPTODO: A realloc here would be much more efficient if possible.
 			if (capacity < this->arraySize)
 				return false;
-			V* newBuffer = new V[capacity];
-			for (unsigned int i = 0; i < this->arraySize; i++)
-				newBuffer[i] = this->buffer[i];
-			delete[] this->buffer;
+			if (capacity == 0)
+				capacity = 1;
+			V* newBuffer = AllocateBuffer(capacity);
+			if constexpr (UU_IS_TRIVIALLY_COPYABLE(V))
+			{
+				if (this->arraySize > 0)
+					UU_MEMCPY(newBuffer, this->buffer, this->arraySize * sizeof(V));
+			}
+			else
+			{
+				for (unsigned int i = 0; i < this->arraySize; i++)
+				{
+					new (&newBuffer[i]) V(static_cast<V&&>(this->buffer[i]));
+					this->buffer[i].~V();
+				}
+			}
+			FreeBuffer(this->buffer);
 			this->buffer = newBuffer;
 			this->bufferSize = capacity;
 			return true;
@@ -186,9 +256,9 @@ namespace UU
 				return false;
 
 			if (i != this->arraySize - 1)
-				this->buffer[i] = this->buffer[this->arraySize - 1];
+				this->buffer[i] = static_cast<V&&>(this->buffer[this->arraySize - 1]);
 
-			this->arraySize--;
+			this->buffer[--this->arraySize].~V();
 			return true;
 		}
 
@@ -200,11 +270,21 @@ namespace UU
 			if (i >= this->arraySize)
 				return false;
 
-			if (i != this->arraySize - 1)
-				for (unsigned int j = i; j < this->arraySize - 1; j++)
-					this->buffer[j] = this->buffer[j + 1];
+			if constexpr (UU_IS_TRIVIALLY_COPYABLE(V))
+			{
+				if (i != this->arraySize - 1)
+					UU_MEMMOVE(&this->buffer[i], &this->buffer[i + 1], (this->arraySize - 1 - i) * sizeof(V));
+				this->arraySize--;
+			}
+			else
+			{
+				if (i != this->arraySize - 1)
+					for (unsigned int j = i; j < this->arraySize - 1; j++)
+						this->buffer[j] = static_cast<V&&>(this->buffer[j + 1]);
+
+				this->buffer[--this->arraySize].~V();
+			}
 
-			this->arraySize--;
 			return true;
 		}
 
@@ -230,12 +310,15 @@ namespace UU
 			if (this->arraySize == this->bufferSize)
 				this->SetCapacity(this->bufferSize * 2);
 
-			this->arraySize++;
-
-			if (this->arraySize - 1 != i)
-				this->buffer[this->arraySize - 1] = this->buffer[i];
+			if (i == this->arraySize)
+				new (&this->buffer[this->arraySize]) V(static_cast<V&&>(value));
+			else
+			{
+				new (&this->buffer[this->arraySize]) V(static_cast<V&&>(this->buffer[i]));
+				this->buffer[i] = static_cast<V&&>(value);
+			}
 
-			this->buffer[i] = value;
+			this->arraySize++;
 			return true;
 		}
 
@@ -250,11 +333,26 @@ namespace UU
 			if (this->arraySize == this->bufferSize)
 				this->SetCapacity(this->bufferSize * 2);
 
-			this->arraySize++;
-			for (unsigned int j = this->arraySize - 1; j > i; j--)
-				this->buffer[j] = this->buffer[j - 1];
+			if constexpr (UU_IS_TRIVIALLY_COPYABLE(V))
+			{
+				if (i != this->arraySize)
+					UU_MEMMOVE(&this->buffer[i + 1], &this->buffer[i], (this->arraySize - i) * sizeof(V));
+				new (&this->buffer[i]) V(static_cast<V&&>(value));
+			}
+			else
+			{
+				if (i == this->arraySize)
+					new (&this->buffer[i]) V(static_cast<V&&>(value));
+				else
+				{
+					new (&this->buffer[this->arraySize]) V(static_cast<V&&>(this->buffer[this->arraySize - 1]));
+					for (unsigned int j = this->arraySize - 1; j > i; j--)
+						this->buffer[j] = static_cast<V&&>(this->buffer[j - 1]);
+					this->buffer[i] = static_cast<V&&>(value);
+				}
+			}
 
-			this->buffer[i] = value;
+			this->arraySize++;
 			return true;
 		}
 
@@ -277,36 +375,392 @@ namespace UU
 		}
 
 		/**
-		 * This is a super lame and slow bubble sort.  It is a stable sort, though.
-		 * I think the worst-case running time may be when the list is in reverse order.
-		 * The best-case running time, though, is linear when the list is already sorted.
+		 * Sort this array using pattern-defeating quicksort.  This runs in O(n log n) time
+		 * in the worst case, and in linear time for inputs that are already sorted, reverse
+		 * sorted, or made of very few distinct values.  It is not a stable sort.
+		 *
+		 * @param[in] predicate This is called with two values, A and B, and should return a positive number if A belongs after B, and zero or a negative number otherwise.
 		 */
 		template<typename P>
 		void Sort(P predicate)
 		{
-			if (this->arraySize == 0)
+			if (this->arraySize < 2)
+				return;
+
+			unsigned int badPartitionsAllowed = 0;
+			for (unsigned int i = this->arraySize; i > 1; i >>= 1)
+				badPartitionsAllowed++;
+
+			SortRange(this->buffer, this->buffer + this->arraySize, predicate, badPartitionsAllowed, true);
+		}
+
+		/**
+		 * Sort this array using merge sort.  This is a stable sort, so values the predicate
+		 * considers equal stay in the order they were in.  It runs in O(n log n) time and
+		 * uses temporary space for half the array.  See @ref Sort for the predicate.
+		 */
+		template<typename P>
+		void StableSort(P predicate)
+		{
+			if (this->arraySize < 2)
 				return;
-			bool sorted = false;
-			while (!sorted)
+
+			V* scratchBuffer = AllocateBuffer((this->arraySize + 1) / 2);
+			MergeSortRange(this->buffer, this->arraySize, scratchBuffer, predicate);
+			FreeBuffer(scratchBuffer);
+		}
+
+	private:
+		// Buffers are raw memory.  Only the first arraySize elements are ever constructed.
+		static V* AllocateBuffer(unsigned int capacity)
+		{
+			return static_cast<V*>(::operator new(capacity * sizeof(V)));
+		}
+
+		static void FreeBuffer(V* buffer)
+		{
+			::operator delete(buffer);
+		}
+
+		// A sort predicate says whether A belongs after B, so A belongs before B if B belongs after A.
+		template<typename P>
+		static bool SortLess(P& predicate, const V& valueA, const V& valueB)
+		{
+			return predicate(valueB, valueA) > 0;
+		}
+
+		template<typename P>
+		static void SortTwo(V* valueA, V* valueB, P& predicate)
+		{
+			if (SortLess(predicate, *valueB, *valueA))
+				Exchange(*valueA, *valueB);
+		}
+
+		template<typename P>
+		static void SortThree(V* valueA, V* valueB, V* valueC, P& predicate)
+		{
+			SortTwo(valueA, valueB, predicate);
+			SortTwo(valueB, valueC, predicate);
+			SortTwo(valueA, valueB, predicate);
+		}
+
+		// Insertion sort.  If guarded is false, the value just before the range must not be greater than anything in the range.
+		template<typename P>
+		static void InsertionSortRange(V* begin, V* end, P& predicate, bool guarded)
+		{
+			for (V* current = begin + 1; current < end; current++)
+			{
+				if (!SortLess(predicate, *current, *(current - 1)))
+					continue;
+
+				V value = static_cast<V&&>(*current);
+				V* hole = current;
+				do
+				{
+					*hole = static_cast<V&&>(*(hole - 1));
+					hole--;
+				} while ((!guarded || hole != begin) && SortLess(predicate, value, *(hole - 1)));
+				*hole = static_cast<V&&>(value);
+			}
+		}
+
+		// Like an insertion sort, but give up if it looks like it would take too many moves.
+		template<typename P>
+		static bool PartialInsertionSortRange(V* begin, V* end, P& predicate)
+		{
+			unsigned int numMoves = 0;
+			for (V* current = begin + 1; current < end; current++)
+			{
+				if (!SortLess(predicate, *current, *(current - 1)))
+					continue;
+
+				V value = static_cast<V&&>(*current);
+				V* hole = current;
+				do
+				{
+					*hole = static_cast<V&&>(*(hole - 1));
+					hole--;
+				} while (hole != begin && SortLess(predicate, value, *(hole - 1)));
+				*hole = static_cast<V&&>(value);
+
+				numMoves += (unsigned int)(current - hole);
+				if (numMoves > UU_DARRAY_PARTIAL_INSERTION_SORT_LIMIT)
+					return false;
+			}
+
+			return true;
+		}
+
+		template<typename P>
+		static void HeapSortRange(V* begin, V* end, P& predicate)
+		{
+			unsigned int size = (unsigned int)(end - begin);
+
+			auto siftDown = [begin, &predicate](unsigned int i, unsigned int heapSize)
+			{
+				while (true)
+				{
+					unsigned int largest = i;
+					unsigned int left = 2 * i + 1;
+					unsigned int right = left + 1;
+					if (left < heapSize && SortLess(predicate, begin[largest], begin[left]))
+						largest = left;
+					if (right < heapSize && SortLess(predicate, begin[largest], begin[right]))
+						largest = right;
+					if (largest == i)
+						break;
+					Exchange(begin[i], begin[largest]);
+					i = largest;
+				}
+			};
+
+			for (unsigned int i = size / 2; i-- > 0;)
+				siftDown(i, size);
+
+			for (unsigned int i = size - 1; i > 0; i--)
+			{
+				Exchange(begin[0], begin[i]);
+				siftDown(0, i);
+			}
+		}
+
+		// Partition around the pivot at the start of the range, putting values equal to it on the right.
+		// Return where the pivot ended up, and whether the range was already partitioned.
+		template<typename P>
+		static V* PartitionRight(V* begin, V* end, P& predicate, bool& alreadyPartitioned)
+		{
+			V pivot = static_cast<V&&>(*begin);
+			V* first = begin;
+			V* last = end;
+
+			// The median-of-three pivot selection guarantees that these scans stop.
+			while (SortLess(predicate, *++first, pivot))
 			{
-				sorted = true;
-				for (unsigned int i = 0; i < this->arraySize - 1; i++)
+			}
+
+			if (first - 1 == begin)
+			{
+				while (first < last && !SortLess(predicate, *--last, pivot))
 				{
-					V& valueA = this->buffer[i];
-					V& valueB = this->buffer[i + 1];
-					int compare = predicate(valueA, valueB);
-					if (compare > 0)
+				}
+			}
+			else
+			{
+				while (!SortLess(predicate, *--last, pivot))
+				{
+				}
+			}
+
+			alreadyPartitioned = (first >= last);
+
+			while (first < last)
+			{
+				Exchange(*first, *last);
+				while (SortLess(predicate, *++first, pivot))
+				{
+				}
+				while (!SortLess(predicate, *--last, pivot))
+				{
+				}
+			}
+
+			V* pivotPosition = first - 1;
+			*begin = static_cast<V&&>(*pivotPosition);
+			*pivotPosition = static_cast<V&&>(pivot);
+			return pivotPosition;
+		}
+
+		// Partition around the pivot at the start of the range, putting values equal to it on the left.
+		// This is used when the pivot equals the value just before the range, in which case everything
+		// equal to it is already in its final place, so this is what makes many duplicates fast.
+		template<typename P>
+		static V* PartitionLeft(V* begin, V* end, P& predicate)
+		{
+			V pivot = static_cast<V&&>(*begin);
+			V* first = begin;
+			V* last = end;
+
+			while (SortLess(predicate, pivot, *--last))
+			{
+			}
+
+			if (last + 1 == end)
+			{
+				while (first < last && !SortLess(predicate, pivot, *++first))
+				{
+				}
+			}
+			else
+			{
+				while (!SortLess(predicate, pivot, *++first))
+				{
+				}
+			}
+
+			while (first < last)
+			{
+				Exchange(*first, *last);
+				while (SortLess(predicate, pivot, *--last))
+				{
+				}
+				while (!SortLess(predicate, pivot, *++first))
+				{
+				}
+			}
+
+			V* pivotPosition = last;
+			*begin = static_cast<V&&>(*pivotPosition);
+			*pivotPosition = static_cast<V&&>(pivot);
+			return pivotPosition;
+		}
+
+		// This is pattern-defeating quicksort.  See: https://arxiv.org/abs/2106.05123
+		template<typename P>
+		static void SortRange(V* begin, V* end, P& predicate, unsigned int badPartitionsAllowed, bool leftmost)
+		{
+			while (true)
+			{
+				unsigned int size = (unsigned int)(end - begin);
+				if (size < UU_DARRAY_INSERTION_SORT_THRESHOLD)
+				{
+					InsertionSortRange(begin, end, predicate, leftmost);
+					return;
+				}
+
+				// Move the median of three (or the pseudo-median of nine for big ranges) to the start as our pivot.
+				unsigned int half = size / 2;
+				if (size > UU_DARRAY_NINTHER_THRESHOLD)
+				{
+					SortThree(begin, begin + half, end - 1, predicate);
+					SortThree(begin + 1, begin + (half - 1), end - 2, predicate);
+					SortThree(begin + 2, begin + (half + 1), end - 3, predicate);
+					SortThree(begin + (half - 1), begin + half, begin + (half + 1), predicate);
+					Exchange(*begin, *(begin + half));
+				}
+				else
+					SortThree(begin + half, begin, end - 1, predicate);
+
+				if (!leftmost && !SortLess(predicate, *(begin - 1), *begin))
+				{
+					begin = PartitionLeft(begin, end, predicate) + 1;
+					continue;
+				}
+
+				bool alreadyPartitioned = false;
+				V* pivotPosition = PartitionRight(begin, end, predicate, alreadyPartitioned);
+
+				unsigned int leftSize = (unsigned int)(pivotPosition - begin);
+				unsigned int rightSize = (unsigned int)(end - (pivotPosition + 1));
+
+				if (leftSize < size / 8 || rightSize < size / 8)
+				{
+					// Too many bad partitions means the input is adversarial, so fall back on a guaranteed O(n log n) sort.
+					if (--badPartitionsAllowed == 0)
 					{
-						V valueC = valueA;
-						valueA = valueB;
-						valueB = valueC;
-						sorted = false;
+						HeapSortRange(begin, end, predicate);
+						return;
+					}
+
+					// Otherwise, shuffle a few values around to break up whatever pattern caused this.
+					if (leftSize >= UU_DARRAY_INSERTION_SORT_THRESHOLD)
+					{
+						Exchange(*begin, *(begin + leftSize / 4));
+						Exchange(*(pivotPosition - 1), *(pivotPosition - leftSize / 4));
+						if (leftSize > UU_DARRAY_NINTHER_THRESHOLD)
+						{
+							Exchange(*(begin + 1), *(begin + (leftSize / 4 + 1)));
+							Exchange(*(begin + 2), *(begin + (leftSize / 4 + 2)));
+							Exchange(*(pivotPosition - 2), *(pivotPosition - (leftSize / 4 + 1)));
+							Exchange(*(pivotPosition - 3), *(pivotPosition - (leftSize / 4 + 2)));
+						}
+					}
+
+					if (rightSize >= UU_DARRAY_INSERTION_SORT_THRESHOLD)
+					{
+						Exchange(*(pivotPosition + 1), *(pivotPosition + (1 + rightSize / 4)));
+						Exchange(*(end - 1), *(end - rightSize / 4));
+						if (rightSize > UU_DARRAY_NINTHER_THRESHOLD)
+						{
+							Exchange(*(pivotPosition + 2), *(pivotPosition + (2 + rightSize / 4)));
+							Exchange(*(pivotPosition + 3), *(pivotPosition + (3 + rightSize / 4)));
+							Exchange(*(end - 2), *(end - (1 + rightSize / 4)));
+							Exchange(*(end - 3), *(end - (2 + rightSize / 4)));
+						}
 					}
 				}
+				else if (alreadyPartitioned)
+				{
+					// A good partition that didn't move anything suggests the range may already be sorted.
+					if (PartialInsertionSortRange(begin, pivotPosition, predicate) && PartialInsertionSortRange(pivotPosition + 1, end, predicate))
+						return;
+				}
+
+				SortRange(begin, pivotPosition, predicate, badPartitionsAllowed, leftmost);
+				begin = pivotPosition + 1;
+				leftmost = false;
+			}
+		}
+
+		// Merge the sorted runs [0, middle) and [middle, size) of the given buffer.  The left run is moved
+		// out into the given scratch buffer, which is raw memory with room for at least middle values.
+		template<typename P>
+		static void MergeRuns(V* buffer, unsigned int middle, unsigned int size, V* scratchBuffer, P& predicate)
+		{
+			// Nothing to do if the runs are already in order, which is common for partially sorted input.
+			if (middle == 0 || middle == size || !SortLess(predicate, buffer[middle], buffer[middle - 1]))
+				return;
+
+			for (unsigned int i = 0; i < middle; i++)
+				new (&scratchBuffer[i]) V(static_cast<V&&>(buffer[i]));
+
+			// The write position never passes the read position of the right run, so this is safe in place.
+			unsigned int i = 0, j = middle, k = 0;
+			while (i < middle && j < size)
+			{
+				if (SortLess(predicate, buffer[j], scratchBuffer[i]))
+					buffer[k++] = static_cast<V&&>(buffer[j++]);
+				else
+					buffer[k++] = static_cast<V&&>(scratchBuffer[i++]);
+			}
+
+			while (i < middle)
+				buffer[k++] = static_cast<V&&>(scratchBuffer[i++]);
+
+			for (i = 0; i < middle; i++)
+				scratchBuffer[i].~V();
+		}
+
+		template<typename P>
+		static void MergeSortRange(V* buffer, unsigned int size, V* scratchBuffer, P& predicate)
+		{
+			if (size < UU_DARRAY_INSERTION_SORT_THRESHOLD)
+			{
+				InsertionSortRange(buffer, buffer + size, predicate, true);
+				return;
+			}
+
+			unsigned int middle = size / 2;
+			MergeSortRange(buffer, middle, scratchBuffer, predicate);
+			MergeSortRange(buffer + middle, size - middle, scratchBuffer, predicate);
+			MergeRuns(buffer, middle, size, scratchBuffer, predicate);
+		}
+
+		// Copy-construct the given values onto the end of this array, which must have room for them.
+		void CopyConstruct(const V* givenBuffer, unsigned int givenBufferSize)
+		{
+			if constexpr (UU_IS_TRIVIALLY_COPYABLE(V))
+			{
+				if (givenBufferSize > 0)
+					UU_MEMCPY(&this->buffer[this->arraySize], givenBuffer, givenBufferSize * sizeof(V));
+				this->arraySize += givenBufferSize;
+			}
+			else
+			{
+				for (unsigned int i = 0; i < givenBufferSize; i++)
+					new (&this->buffer[this->arraySize++]) V(givenBuffer[i]);
 			}
 		}
 
-	private:
 		V* buffer;
 		unsigned int bufferSize;
 		unsigned int arraySize;
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Threading/Thread.h"
+
+// Arrays smaller than this aren't worth sorting with more than one thread.
+#if !defined UU_DARRAY_PARALLEL_SORT_THRESHOLD
+#	define UU_DARRAY_PARALLEL_SORT_THRESHOLD		(1 << 16)
+#endif
+
+#define UU_DARRAY_PARALLEL_SORT_MAX_CHUNKS			64
+
+namespace UU
+{
+	/**
+	 * Sort the given array using several threads.  The array is cut into one chunk per thread,
+	 * each of which is sorted like @ref DArray::Sort does, and then the chunks are merged together
+	 * in pairs, again in parallel.  Arrays smaller than UU_DARRAY_PARALLEL_SORT_THRESHOLD are just
+	 * sorted on the calling thread.  This is not a stable sort.  See @ref DArray::Sort for the
+	 * predicate, which is copied once per thread and must be safe to call concurrently.
+	 *
+	 * This lives apart from @ref DArray so that using arrays doesn't mean pulling in threads.
+	 */
+	template<typename V, typename P>
+	void ParallelSort(DArray<V>& array, P predicate)
+	{
+		unsigned int numProcessors = Thread::GetNumProcessors();
+		if (array.arraySize < UU_DARRAY_PARALLEL_SORT_THRESHOLD || numProcessors < 2)
+		{
+			array.Sort(predicate);
+			return;
+		}
+
+		// Use a power of two number of chunks so that they merge together evenly.
+		unsigned int numChunks = 1;
+		while (numChunks * 2 <= numProcessors && numChunks < UU_DARRAY_PARALLEL_SORT_MAX_CHUNKS)
+			numChunks *= 2;
+
+		unsigned int chunkBounds[UU_DARRAY_PARALLEL_SORT_MAX_CHUNKS + 1];
+		for (unsigned int i = 0; i <= numChunks; i++)
+			chunkBounds[i] = (unsigned int)((unsigned long long)array.arraySize * i / numChunks);
+
+		V* buffer = array.buffer;
+		Thread* threadArray[UU_DARRAY_PARALLEL_SORT_MAX_CHUNKS];
+		unsigned int numThreads = 0;
+
+		auto joinAndDeleteThreads = [&threadArray, &numThreads]()
+		{
+			for (unsigned int i = 0; i < numThreads; i++)
+			{
+				threadArray[i]->Join();
+				delete threadArray[i];
+			}
+
+			numThreads = 0;
+		};
+
+		for (unsigned int i = 0; i < numChunks; i++)
+		{
+			unsigned int start = chunkBounds[i];
+			unsigned int finish = chunkBounds[i + 1];
+			auto sortChunk = [buffer, start, finish, predicate]()
+			{
+				P chunkPredicate = predicate;
+				unsigned int badPartitionsAllowed = 0;
+				for (unsigned int j = finish - start; j > 1; j >>= 1)
+					badPartitionsAllowed++;
+				DArray<V>::SortRange(buffer + start, buffer + finish, chunkPredicate, badPartitionsAllowed, true);
+			};
+
+			// The last chunk is done on this thread while the others run.
+			if (i < numChunks - 1)
+			{
+				Thread* thread = new LambdaThread<decltype(sortChunk)>(sortChunk);
+				if (thread->Start())
+					threadArray[numThreads++] = thread;
+				else
+				{
+					delete thread;
+					sortChunk();
+				}
+			}
+			else
+				sortChunk();
+		}
+
+		joinAndDeleteThreads();
+
+		// Each merge uses the part of the scratch buffer that lines up with its own part of the array.
+		V* scratchBuffer = DArray<V>::AllocateBuffer(array.arraySize);
+
+		for (unsigned int width = 1; width < numChunks; width *= 2)
+		{
+			for (unsigned int i = 0; i < numChunks; i += 2 * width)
+			{
+				unsigned int start = chunkBounds[i];
+				unsigned int middle = chunkBounds[i + width];
+				unsigned int finish = chunkBounds[i + 2 * width];
+				auto mergeChunks = [buffer, scratchBuffer, start, middle, finish, predicate]()
+				{
+					P chunkPredicate = predicate;
+					DArray<V>::MergeRuns(buffer + start, middle - start, finish - start, scratchBuffer + start, chunkPredicate);
+				};
+
+				if (i + 2 * width < numChunks)
+				{
+					Thread* thread = new LambdaThread<decltype(mergeChunks)>(mergeChunks);
+					if (thread->Start())
+						threadArray[numThreads++] = thread;
+					else
+					{
+						delete thread;
+						mergeChunks();
+					}
+				}
+				else
+					mergeChunks();
+			}
+
+			joinAndDeleteThreads();
+		}
+
+		DArray<V>::FreeBuffer(scratchBuffer);
+	}
+}
\ No newline at end of file
@@ -65,6 +65,10 @@ FibonacciHeap::Node* FibonacciHeap::RemoveMinimumNode()
 		this->rootList.RemoveNode(rootNodeA);
 
 		unsigned int degree = rootNodeA->childList.GetNumNodes();
+
+		// The log estimate above is only a guess at the maximum degree, so grow as needed.
+		while (degree >= nodeArray.GetSize())
+			nodeArray.Push(nullptr);
 		
 		if (nodeArray[degree] == nullptr)
 			nodeArray[degree] = rootNodeA;
@@ -0,0 +1,533 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+#include "UltraUtilities/Hash.h"
+#include "UltraUtilities/String.h"
+#include <new>
+
+namespace UU
+{
+	template<typename K> class FlatHashMapHasher;
+	template<typename K, typename V, typename H> class FlatHashMapIterator;
+
+	/**
+	 * This is an open-addressing alternative to the @ref HashMap class.  Where the
+	 * @ref HashMap class allocates a node and a key for every pair and chains them
+	 * together in per-bucket linked lists, here all key/value pairs live inline in
+	 * one contiguous array of slots.  A parallel array of control bytes records, for
+	 * each slot, whether it is occupied and how far its occupant sits from its home
+	 * slot.  Collisions are resolved with Robin Hood linear probing, which keeps probe
+	 * sequences short and lets a lookup give up early, and removal shifts subsequent
+	 * pairs back rather than leaving tombstones behind.  A typical lookup touches
+	 * one control byte cache line and one slot cache line, and never calls a virtual.
+	 *
+	 * Note that inserting or removing a pair can move other pairs around in memory,
+	 * so a pointer returned by @ref FindPtr is only valid until the next mutation.
+	 *
+	 * Keys are hashed and compared using the given hasher class, which must provide
+	 * static Hash and Equal methods.  See @ref FlatHashMapHasher.
+	 */
+	template<typename K, typename V, typename H = FlatHashMapHasher<K>>
+	class UU_API FlatHashMap
+	{
+		friend class FlatHashMapIterator<K, V, H>;
+
+	public:
+		FlatHashMap(unsigned int initialCapacity = 0)
+		{
+			this->controlArray = nullptr;
+			this->slotArray = nullptr;
+			this->capacity = 0;
+			this->numPairs = 0;
+			this->Reserve(initialCapacity);
+		}
+
+		FlatHashMap(const FlatHashMap& map)
+		{
+			this->controlArray = nullptr;
+			this->slotArray = nullptr;
+			this->capacity = 0;
+			this->numPairs = 0;
+			*this = map;
+		}
+
+		FlatHashMap(FlatHashMap&& map)
+		{
+			this->controlArray = map.controlArray;
+			this->slotArray = map.slotArray;
+			this->capacity = map.capacity;
+			this->numPairs = map.numPairs;
+			map.controlArray = nullptr;
+			map.slotArray = nullptr;
+			map.capacity = 0;
+			map.numPairs = 0;
+		}
+
+		virtual ~FlatHashMap()
+		{
+			this->Clear();
+			this->FreeTable(this->controlArray, this->slotArray);
+		}
+
+		void operator=(const FlatHashMap& map)
+		{
+			if (this == &map)
+				return;
+
+			this->Clear();
+			this->Reserve(map.numPairs);
+			for (unsigned int i = 0; i < map.capacity; i++)
+				if (map.controlArray[i] != 0)
+					this->InsertNew(map.slotArray[i].key, map.slotArray[i].value);
+		}
+
+		/**
+		 * This provides bracket-syntax access to the hash map.
+		 * Note that if you ask for the value of a key that
+		 * does not exist in the map, then you may get an
+		 * uninitialized value if the value type does not
+		 * have a constructor.
+		 */
+		V operator[](K key)
+		{
+			V value;
+			this->Find(key, &value);
+			return value;
+		}
+
+		/**
+		 * Find a value by key.  If a value pointer is not given,
+		 * then this method can be used to check for existence
+		 * of a given key in the hash map.
+		 */
+		bool Find(K key, V* value = nullptr)
+		{
+			unsigned int i = this->FindSlot(key);
+			if (i == FLAT_HASH_MAP_NO_SLOT)
+				return false;
+			if (value)
+				*value = this->slotArray[i].value;
+			return true;
+		}
+
+		/**
+		 * Find a pointer to a value by key.  The pointer is
+		 * invalidated by any subsequent insertion or removal.
+		 */
+		bool FindPtr(K key, V*& value)
+		{
+			unsigned int i = this->FindSlot(key);
+			if (i == FLAT_HASH_MAP_NO_SLOT)
+				return false;
+			value = &this->slotArray[i].value;
+			return true;
+		}
+
+		/**
+		 * Insert a value at the given key.  If a value already
+		 * exists at the given key, it is replaced.
+		 */
+		bool Insert(K key, V value)
+		{
+			unsigned int i = this->FindSlot(key);
+			if (i != FLAT_HASH_MAP_NO_SLOT)
+			{
+				this->slotArray[i].value = static_cast<V&&>(value);
+				return true;
+			}
+
+			return this->InsertNew(static_cast<K&&>(key), static_cast<V&&>(value));
+		}
+
+		/**
+		 * Remove the value at the given key, if any.
+		 * The value at the given key is returned if desired.
+		 */
+		bool Remove(K key, V* value = nullptr)
+		{
+			unsigned int i = this->FindSlot(key);
+			if (i == FLAT_HASH_MAP_NO_SLOT)
+				return false;
+
+			if (value)
+				*value = static_cast<V&&>(this->slotArray[i].value);
+
+			this->slotArray[i].~Slot();
+			this->controlArray[i] = 0;
+			this->numPairs--;
+
+			// Shift back any displaced pairs that follow so that no probe sequence is broken.
+			unsigned int mask = this->capacity - 1;
+			unsigned int j = (i + 1) & mask;
+			while (this->controlArray[j] > 1)
+			{
+				new (&this->slotArray[i]) Slot(static_cast<Slot&&>(this->slotArray[j]));
+				this->controlArray[i] = this->controlArray[j] - 1;
+				this->slotArray[j].~Slot();
+				this->controlArray[j] = 0;
+				i = j;
+				j = (j + 1) & mask;
+			}
+
+			return true;
+		}
+
+		/**
+		 * Remove all key/value pairs.  The slot array is kept.
+		 */
+		void Clear()
+		{
+			for (unsigned int i = 0; i < this->capacity; i++)
+			{
+				if (this->controlArray[i] != 0)
+				{
+					this->slotArray[i].~Slot();
+					this->controlArray[i] = 0;
+				}
+			}
+
+			this->numPairs = 0;
+		}
+
+		/**
+		 * Make sure that the given number of pairs can be stored
+		 * in this map without it having to grow.
+		 */
+		void Reserve(unsigned int numPairs)
+		{
+			unsigned int requiredCapacity = numPairs + numPairs / 7;
+			if (requiredCapacity <= this->capacity)
+				return;
+
+			unsigned int newCapacity = UU_MAX(this->capacity, FLAT_HASH_MAP_MIN_CAPACITY);
+			while (newCapacity < requiredCapacity + 1)
+				newCapacity *= 2;
+
+			this->Rehash(newCapacity);
+		}
+
+		/**
+		 * Indicate how many key/value pairs are stored in the map.
+		 */
+		unsigned int GetNumPairs() const { return this->numPairs; }
+
+		/**
+		 * Indicate how many slots the map currently has.  This is always a power of two.
+		 */
+		unsigned int GetCapacity() const { return this->capacity; }
+
+		/**
+		 * This is provided to support the ranged for-loop syntax.
+		 */
+		FlatHashMapIterator<K, V, H> begin()
+		{
+			return FlatHashMapIterator<K, V, H>(this);
+		}
+
+		/**
+		 * This is the end sentinal for the ranged for-loop support.
+		 */
+		int end()
+		{
+			return int(this->capacity);
+		}
+
+	private:
+		enum : unsigned int
+		{
+			FLAT_HASH_MAP_MIN_CAPACITY = 8,
+			FLAT_HASH_MAP_MAX_PROBE_DISTANCE = 254,
+			FLAT_HASH_MAP_NO_SLOT = 0xFFFFFFFF
+		};
+
+		struct Slot
+		{
+			Slot(K&& key, V&& value) : key(static_cast<K&&>(key)), value(static_cast<V&&>(value))
+			{
+			}
+
+			Slot(Slot&& slot) : key(static_cast<K&&>(slot.key)), value(static_cast<V&&>(slot.value))
+			{
+			}
+
+			K key;
+			V value;
+		};
+
+		/**
+		 * Return the slot index of the given key, or FLAT_HASH_MAP_NO_SLOT if it isn't in the map.  Each
+		 * control byte holds one plus its occupant's probe distance, zero meaning empty.
+		 * Since Robin Hood insertion never leaves a pair further from home than one it
+		 * passed over, we can stop as soon as we find a slot whose occupant is closer
+		 * to home than we are.  Keys only ever need comparing when the distances agree.
+		 */
+		unsigned int FindSlot(const K& key) const
+		{
+			if (this->numPairs == 0)
+				return FLAT_HASH_MAP_NO_SLOT;
+
+			unsigned int mask = this->capacity - 1;
+			unsigned int i = (unsigned int)H::Hash(key) & mask;
+			unsigned int distance = 0;
+			while (true)
+			{
+				unsigned int control = this->controlArray[i];
+				if (control == 0 || control - 1 < distance)
+					return FLAT_HASH_MAP_NO_SLOT;
+
+				if (control - 1 == distance && H::Equal(this->slotArray[i].key, key))
+					return i;
+
+				i = (i + 1) & mask;
+				distance++;
+			}
+		}
+
+		/**
+		 * Insert a key that is known not to already be in the map.
+		 */
+		bool InsertNew(K key, V value)
+		{
+			if (this->numPairs + 1 > this->capacity - this->capacity / 8)
+				this->Rehash(this->capacity == 0 ? FLAT_HASH_MAP_MIN_CAPACITY : this->capacity * 2);
+
+			unsigned int mask = this->capacity - 1;
+			unsigned int i = (unsigned int)H::Hash(key) & mask;
+			unsigned int distance = 0;
+			while (true)
+			{
+				unsigned int control = this->controlArray[i];
+				if (control == 0)
+				{
+					new (&this->slotArray[i]) Slot(static_cast<K&&>(key), static_cast<V&&>(value));
+					this->controlArray[i] = (unsigned char)(distance + 1);
+					this->numPairs++;
+					return true;
+				}
+
+				// Take from the rich (close to home) and give to the poor (far from home).
+				if (control - 1 < distance)
+				{
+					K displacedKey(static_cast<K&&>(this->slotArray[i].key));
+					V displacedValue(static_cast<V&&>(this->slotArray[i].value));
+					this->slotArray[i].key = static_cast<K&&>(key);
+					this->slotArray[i].value = static_cast<V&&>(value);
+					key = static_cast<K&&>(displacedKey);
+					value = static_cast<V&&>(displacedValue);
+					this->controlArray[i] = (unsigned char)(distance + 1);
+					distance = control - 1;
+				}
+
+				i = (i + 1) & mask;
+				if (++distance > FLAT_HASH_MAP_MAX_PROBE_DISTANCE)
+				{
+					// The hash function is clustering badly.  Growing is our only recourse.
+					this->Rehash(this->capacity * 2);
+					return this->InsertNew(static_cast<K&&>(key), static_cast<V&&>(value));
+				}
+			}
+		}
+
+		void Rehash(unsigned int newCapacity)
+		{
+			unsigned char* oldControlArray = this->controlArray;
+			Slot* oldSlotArray = this->slotArray;
+			unsigned int oldCapacity = this->capacity;
+
+			this->controlArray = new unsigned char[newCapacity];
+			for (unsigned int i = 0; i < newCapacity; i++)
+				this->controlArray[i] = 0;
+			this->slotArray = static_cast<Slot*>(::operator new(newCapacity * sizeof(Slot)));
+			this->capacity = newCapacity;
+			this->numPairs = 0;
+
+			for (unsigned int i = 0; i < oldCapacity; i++)
+			{
+				if (oldControlArray[i] != 0)
+				{
+					Slot* slot = &oldSlotArray[i];
+					this->InsertNew(static_cast<K&&>(slot->key), static_cast<V&&>(slot->value));
+					slot->~Slot();
+				}
+			}
+
+			this->FreeTable(oldControlArray, oldSlotArray);
+		}
+
+		static void FreeTable(unsigned char* controlArray, Slot* slotArray)
+		{
+			delete[] controlArray;
+			::operator delete(slotArray);
+		}
+
+		unsigned char* controlArray;
+		Slot* slotArray;
+		unsigned int capacity;
+		unsigned int numPairs;
+	};
+
+	/**
+	 * This is used internally by the @ref FlatHashMap class to
+	 * support ranged for-loop syntax in C++.
+	 */
+	template<typename K, typename V, typename H>
+	class UU_API FlatHashMapIterator
+	{
+	public:
+		struct Pair
+		{
+			K key;
+			V value;
+		};
+
+		FlatHashMapIterator(FlatHashMap<K, V, H>* map)
+		{
+			this->map = map;
+			this->i = -1;
+			this->Advance();
+		}
+
+		void operator++()
+		{
+			this->Advance();
+		}
+
+		bool operator==(int i)
+		{
+			return this->i == i;
+		}
+
+		Pair operator*()
+		{
+			Pair pair;
+			pair.key = this->map->slotArray[this->i].key;
+			pair.value = this->map->slotArray[this->i].value;
+			return pair;
+		}
+
+	private:
+		void Advance()
+		{
+			do
+			{
+				this->i++;
+			} while (this->i < int(this->map->capacity) && this->map->controlArray[this->i] == 0);
+		}
+
+		int i;
+		FlatHashMap<K, V, H>* map;
+	};
+
+	/**
+	 * This is the default hasher used by the @ref FlatHashMap class.  It defers
+	 * to the same static Hash and Equal methods of the key class that the @ref HashMap
+	 * class uses, asking for a hash over a 2^31 entry table and then mixing it, since
+	 * a key class's hash need not be well mixed.  Key types with a full 64-bit hash of
+	 * their own, like strings, should have a specialization that returns it directly.
+	 */
+	template<typename K>
+	class UU_API FlatHashMapHasher
+	{
+	public:
+		static unsigned long long Hash(const K& key)
+		{
+			return HashInteger(K::Hash(key, 0x80000000));
+		}
+
+		static bool Equal(const K& keyA, const K& keyB)
+		{
+			return K::Equal(keyA, keyB);
+		}
+	};
+
+	/**
+	 * Provide a specialization for unsigned integers.
+	 */
+	template<>
+	class UU_API FlatHashMapHasher<unsigned int>
+	{
+	public:
+		static unsigned long long Hash(unsigned int key)
+		{
+			return HashInteger(key);
+		}
+
+		static bool Equal(unsigned int keyA, unsigned int keyB)
+		{
+			return keyA == keyB;
+		}
+	};
+
+	/**
+	 * Provide a specialization for integers.
+	 */
+	template<>
+	class UU_API FlatHashMapHasher<int>
+	{
+	public:
+		static unsigned long long Hash(int key)
+		{
+			return HashInteger(static_cast<unsigned int>(key));
+		}
+
+		static bool Equal(int keyA, int keyB)
+		{
+			return keyA == keyB;
+		}
+	};
+
+	/**
+	 * Provide a specialization for long integers.
+	 */
+	template<>
+	class UU_API FlatHashMapHasher<unsigned long long>
+	{
+	public:
+		static unsigned long long Hash(unsigned long long key)
+		{
+			return HashInteger(key);
+		}
+
+		static bool Equal(unsigned long long keyA, unsigned long long keyB)
+		{
+			return keyA == keyB;
+		}
+	};
+
+	/**
+	 * Provide a specialization for strings.  Their 64-bit hash is already well mixed,
+	 * so it's used as is, rather than being cut down to 31 bits and mixed again.
+	 */
+	template<>
+	class UU_API FlatHashMapHasher<String>
+	{
+	public:
+		static unsigned long long Hash(const String& key)
+		{
+			return HashBytes((const char*)key, key.Length());
+		}
+
+		static bool Equal(const String& keyA, const String& keyB)
+		{
+			return String::Equal(keyA, keyB);
+		}
+	};
+
+	/**
+	 * Provide a specialization for characters.
+	 */
+	template<>
+	class UU_API FlatHashMapHasher<char>
+	{
+	public:
+		static unsigned long long Hash(char key)
+		{
+			return HashInteger(static_cast<unsigned char>(key));
+		}
+
+		static bool Equal(char keyA, char keyB)
+		{
+			return keyA == keyB;
+		}
+	};
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "UltraUtilities/Containers/HashTable.h"
+#include "UltraUtilities/Hash.h"
 #include "UltraUtilities/Memory/ObjectHeap.hpp"
 
 namespace UU
@@ -22,6 +23,7 @@ namespace UU
 
 		virtual ~HashMap()
 		{
+			this->Clear();
 		}
 
 		/**
@@ -120,7 +122,12 @@ namespace UU
 		 */
 		void Clear()
 		{
-			this->table.Clear();
+			// The nodes and keys came from our heaps, so that's where they have to go back to.
+			this->table.Clear([this](HashTableNode* node)
+				{
+					this->keyHeap.Deallocate(static_cast<HashMapKey<K>*>(node->GetKey()));
+					this->nodeHeap.Deallocate(static_cast<HashMapNode<V>*>(node));
+				});
 		}
 
 		/**
@@ -128,6 +135,24 @@ namespace UU
 		 */
 		unsigned int GetNumPairs() const { return this->table.GetNumNodes(); }
 
+		/**
+		 * Size the underlying table up front for the given number of key/value pairs.
+		 * See @ref HashTable::Reserve.
+		 */
+		void Reserve(unsigned int numPairs)
+		{
+			this->table.Reserve(numPairs);
+		}
+
+		/**
+		 * Set the load factor above which the underlying table grows.
+		 * See @ref HashTable::SetMaxLoadFactor.
+		 */
+		void SetMaxLoadFactor(double maxLoadFactor)
+		{
+			this->table.SetMaxLoadFactor(maxLoadFactor);
+		}
+
 		/**
 		 * Provide access to the hash table being wrapped by this template class.
 		 */
@@ -144,9 +169,9 @@ namespace UU
 		/**
 		 * This is the end sentinal for the ranged for-loop support.
 		 */
-		int end()
+		HashTableNode* end()
 		{
-			return int(this->table.GetTableSize()) - 1;
+			return nullptr;
 		}
 
 	private:
@@ -172,19 +197,17 @@ namespace UU
 		HashMapIterator(HashTable* hashTable)
 		{
 			this->hashTable = hashTable;
-			this->node = nullptr;
-			this->i = -1;
-			this->Advance();
+			this->node = hashTable->GetFirstNode();
 		}
 
 		void operator++()
 		{
-			this->Advance();
+			this->node = this->hashTable->GetNextNode(this->node);
 		}
 
-		bool operator==(int i)
+		bool operator==(HashTableNode* node)
 		{
-			return this->i == i;
+			return this->node == node;
 		}
 
 		Pair operator*()
@@ -196,15 +219,6 @@ namespace UU
 		}
 
 	private:
-		void Advance()
-		{
-			if (this->node)
-				this->node = static_cast<HashTableNode*>(this->node->GetNext());
-			while (!this->node && this->i < int(this->hashTable->GetTableSize()) - 1)
-				this->node = static_cast<HashTableNode*>(hashTable->GetTable()[++this->i].GetHead());
-		}
-
-		int i;
 		HashTableNode* node;
 		HashTable* hashTable;
 	};
@@ -241,7 +255,7 @@ namespace UU
 	};
 
 	/**
-	 * Provide a specialization that uses unsigned integers and the division method of hashing.
+	 * Provide a specialization for unsigned integers.
 	 */
 	template<>
 	class UU_API HashMapKey<unsigned int> : public HashTableKey
@@ -249,7 +263,7 @@ namespace UU
 	public:
 		virtual unsigned int Hash(unsigned int tableSize) const override
 		{
-			return this->value % tableSize;
+			return HashToIndex(HashInteger(this->value), tableSize);
 		}
 
 		virtual bool operator==(const HashTableKey& key) const override
@@ -262,7 +276,7 @@ namespace UU
 	};
 
 	/**
-	 * Provide a specialization that uses integers and the division method of hashing.
+	 * Provide a specialization for integers.
 	 */
 	template<>
 	class UU_API HashMapKey<int> : public HashTableKey
@@ -270,7 +284,7 @@ namespace UU
 	public:
 		virtual unsigned int Hash(unsigned int tableSize) const override
 		{
-			return static_cast<unsigned int>(this->value) % tableSize;
+			return HashToIndex(HashInteger(static_cast<unsigned int>(this->value)), tableSize);
 		}
 
 		virtual bool operator==(const HashTableKey& key) const override
@@ -283,7 +297,7 @@ namespace UU
 	};
 
 	/**
-	 * Provide a specialization that uses long integers and the division method of hashing.
+	 * Provide a specialization for long integers.
 	 */
 	template<>
 	class UU_API HashMapKey<unsigned long long> : public HashTableKey
@@ -291,7 +305,7 @@ namespace UU
 	public:
 		virtual unsigned int Hash(unsigned int tableSize) const override
 		{
-			return static_cast<unsigned int>(this->value % static_cast<unsigned long long>(tableSize));
+			return HashToIndex(HashInteger(this->value), tableSize);
 		}
 
 		virtual bool operator==(const HashTableKey& key) const override
@@ -304,7 +318,7 @@ namespace UU
 	};
 
 	/**
-	 * Provide a specialization that uses characters and the division method of hashing.
+	 * Provide a specialization for characters.
 	 */
 	template<>
 	class UU_API HashMapKey<char> : public HashTableKey
@@ -313,7 +327,7 @@ namespace UU
 	public:
 		virtual unsigned int Hash(unsigned int tableSize) const override
 		{
-			return static_cast<unsigned int>(this->value) % tableSize;
+			return HashToIndex(HashInteger(static_cast<unsigned char>(this->value)), tableSize);
 		}
 
 		virtual bool operator==(const HashTableKey& key) const override
@@ -24,6 +24,11 @@ namespace UU
 		{
 		}
 
+		virtual ~HashSet()
+		{
+			this->Clear();
+		}
+
 		/**
 		 * This provides bracket-syntax for membership queries.
 		 */
@@ -84,7 +89,12 @@ namespace UU
 		 */
 		void Clear()
 		{
-			this->table.Clear();
+			// The nodes and keys came from our heaps, so that's where they have to go back to.
+			this->table.Clear([this](HashTableNode* node)
+				{
+					this->keyHeap.Deallocate(static_cast<HashMapKey<K>*>(node->GetKey()));
+					this->nodeHeap.Deallocate(node);
+				});
 		}
 
 		/**
@@ -92,6 +102,24 @@ namespace UU
 		 */
 		unsigned int GetNumKeys() const { return this->table.GetNumNodes(); }
 
+		/**
+		 * Size the underlying table up front for the given number of keys.
+		 * See @ref HashTable::Reserve.
+		 */
+		void Reserve(unsigned int numKeys)
+		{
+			this->table.Reserve(numKeys);
+		}
+
+		/**
+		 * Set the load factor above which the underlying table grows.
+		 * See @ref HashTable::SetMaxLoadFactor.
+		 */
+		void SetMaxLoadFactor(double maxLoadFactor)
+		{
+			this->table.SetMaxLoadFactor(maxLoadFactor);
+		}
+
 		/**
 		 * Provide access to the hash table being wrapped by this template class.
 		 */
@@ -108,9 +136,9 @@ namespace UU
 		/**
 		 * This is the end sentinal for the ranged for-loop support.
 		 */
-		int end()
+		HashTableNode* end()
 		{
-			return int(this->table.GetTableSize()) - 1;
+			return nullptr;
 		}
 
 	private:
@@ -130,19 +158,17 @@ namespace UU
 		HashSetIterator(HashTable* hashTable)
 		{
 			this->hashTable = hashTable;
-			this->node = nullptr;
-			this->i = -1;
-			this->Advance();
+			this->node = hashTable->GetFirstNode();
 		}
 
 		void operator++()
 		{
-			this->Advance();
+			this->node = this->hashTable->GetNextNode(this->node);
 		}
 
-		bool operator==(int i)
+		bool operator==(HashTableNode* node)
 		{
-			return this->i == i;
+			return this->node == node;
 		}
 
 		K operator*()
@@ -151,15 +177,6 @@ namespace UU
 		}
 
 	private:
-		void Advance()
-		{
-			if (this->node)
-				this->node = static_cast<HashTableNode*>(this->node->GetNext());
-			while (!this->node && this->i < int(this->hashTable->GetTableSize()) - 1)
-				this->node = static_cast<HashTableNode*>(hashTable->GetTable()[++this->i].GetHead());
-		}
-
-		int i;
 		HashTableNode* node;
 		HashTable* hashTable;
 	};
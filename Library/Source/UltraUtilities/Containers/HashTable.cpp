@@ -4,11 +4,20 @@ using namespace UU;
 
 //------------------------------ HashTable ------------------------------
 
-HashTable::HashTable(unsigned int tableSize /*= 2048*/)
+// This many buckets of the old table are migrated per insertion or removal while rehashing.
+#define UU_HASH_TABLE_REHASH_STEP		4
+
+HashTable::HashTable(unsigned int tableSize /*= 8*/)
 {
-	this->tableSize = tableSize;
-	this->table = new LinkedList[tableSize];
+	// Table sizes are kept at powers of two so that hashes can be reduced to bucket indices with a mask.
+	this->tableSize = RoundUpToPowerOfTwo(tableSize);
+	this->minTableSize = this->tableSize;
+	this->table = new LinkedList[this->tableSize];
+	this->oldTable = nullptr;
+	this->oldTableSize = 0;
+	this->rehashIndex = 0;
 	this->numNodes = 0;
+	this->maxLoadFactor = 1.0;
 }
 
 /*virtual*/ HashTable::~HashTable()
@@ -17,15 +26,32 @@ HashTable::HashTable(unsigned int tableSize /*= 2048*/)
 	delete[] this->table;
 }
 
+LinkedList* HashTable::FindBucket(const HashTableKey* key)
+{
+	unsigned int i = key->Hash(this->tableSize) & (this->tableSize - 1);
+	return &this->table[i];
+}
+
 HashTableNode* HashTable::FindNode(const HashTableKey* key)
 {
-	unsigned int i = key->Hash(this->tableSize);
-	UU_ASSERT(i < this->tableSize);
-	if (i >= this->tableSize)
-		return nullptr;
+	// Until the old table is fully migrated, the node could be in either table.
+	if (this->oldTable)
+	{
+		unsigned int i = key->Hash(this->oldTableSize) & (this->oldTableSize - 1);
+		if (i >= this->rehashIndex)
+		{
+			LinkedListNode* node = this->oldTable[i].GetHead();
+			while (node)
+			{
+				if (*static_cast<HashTableNode*>(node)->key == *key)
+					return static_cast<HashTableNode*>(node);
+
+				node = node->GetNext();
+			}
+		}
+	}
 
-	LinkedList* list = &this->table[i];
-	LinkedListNode* node = list->GetHead();
+	LinkedListNode* node = this->FindBucket(key)->GetHead();
 	while (node)
 	{
 		if (*static_cast<HashTableNode*>(node)->key == *key)
@@ -42,15 +68,11 @@ bool HashTable::InsertNode(HashTableNode* newNode)
 	if (newNode->table != nullptr)
 		return false;
 
-	unsigned int i = newNode->key->Hash(this->tableSize);
-	UU_ASSERT(i < this->tableSize);
-	if (i >= this->tableSize)
-		return false;
-
-	LinkedList* list = &this->table[i];
-	list->InsertAfter(newNode);
+	this->FindBucket(newNode->key)->InsertAfter(newNode);
 	newNode->table = this;
 	this->numNodes++;
+	this->RehashStep();
+	this->GrowIfNeeded();
 	return true;
 }
 
@@ -60,9 +82,7 @@ HashTableNode* HashTable::RemoveNode(const HashTableKey* key)
 	if (!oldNode)
 		return nullptr;
 
-	oldNode->GetList()->Remove(oldNode);
-	oldNode->table = nullptr;
-	this->numNodes--;
+	this->RemoveNode(oldNode);
 	return oldNode;
 }
 
@@ -74,6 +94,8 @@ bool HashTable::RemoveNode(HashTableNode* oldNode)
 	oldNode->GetList()->Remove(oldNode);
 	oldNode->table = nullptr;
 	this->numNodes--;
+	this->RehashStep();
+	this->ShrinkIfNeeded();
 	return true;
 }
 
@@ -89,12 +111,166 @@ bool HashTable::DeleteNode(HashTableKey* key)
 
 void HashTable::Clear()
 {
-	for (unsigned int i = 0; i < this->tableSize; i++)
-		this->table[i].Clear();
+	if (this->oldTable)
+	{
+		delete[] this->oldTable;
+		this->oldTable = nullptr;
+		this->oldTableSize = 0;
+	}
+
+	if (this->tableSize != this->minTableSize)
+	{
+		delete[] this->table;
+		this->tableSize = this->minTableSize;
+		this->table = new LinkedList[this->tableSize];
+	}
+	else
+	{
+		for (unsigned int i = 0; i < this->tableSize; i++)
+			this->table[i].Clear();
+	}
 
 	this->numNodes = 0;
 }
 
+void HashTable::Reserve(unsigned int numNodes)
+{
+	// The reserved size becomes the floor, so that the table doesn't shrink away from it before it fills up.
+	while (double(numNodes) > double(this->minTableSize) * this->maxLoadFactor && this->minTableSize < UU_MAX_POWER_OF_TWO)
+		this->minTableSize *= 2;
+
+	if (this->minTableSize > this->tableSize)
+	{
+		this->Resize(this->minTableSize);
+		this->FinishRehash();
+	}
+}
+
+void HashTable::SetMaxLoadFactor(double maxLoadFactor)
+{
+	UU_ASSERT(maxLoadFactor > 0.0);
+	if (maxLoadFactor <= 0.0)
+		return;
+
+	this->maxLoadFactor = maxLoadFactor;
+	this->GrowIfNeeded();
+	this->ShrinkIfNeeded();
+}
+
+void HashTable::GrowIfNeeded()
+{
+	// Doubling the biggest table would overflow to zero, so it just gets more loaded from there on.
+	if (this->GetLoadFactor() > this->maxLoadFactor && this->tableSize < UU_MAX_POWER_OF_TWO)
+		this->Resize(this->tableSize * 2);
+}
+
+void HashTable::ShrinkIfNeeded()
+{
+	if (this->GetLoadFactor() < this->maxLoadFactor / 4.0 && this->tableSize / 2 >= this->minTableSize)
+		this->Resize(this->tableSize / 2);
+}
+
+void HashTable::Resize(unsigned int newTableSize)
+{
+	// We can only be migrating from one old table at a time.
+	this->FinishRehash();
+
+	this->oldTable = this->table;
+	this->oldTableSize = this->tableSize;
+	this->rehashIndex = 0;
+
+	this->table = new LinkedList[newTableSize];
+	this->tableSize = newTableSize;
+}
+
+void HashTable::RehashStep()
+{
+	if (!this->oldTable)
+		return;
+
+	// Bound the number of empty buckets we skip as well, so that the step stays cheap.
+	unsigned int numBucketsMigrated = 0;
+	unsigned int numEmptyBucketsVisited = 0;
+	while (this->rehashIndex < this->oldTableSize && numBucketsMigrated < UU_HASH_TABLE_REHASH_STEP)
+	{
+		LinkedList* oldList = &this->oldTable[this->rehashIndex++];
+		if (oldList->GetNumNodes() == 0)
+		{
+			if (++numEmptyBucketsVisited == 10 * UU_HASH_TABLE_REHASH_STEP)
+				break;
+
+			continue;
+		}
+
+		while (oldList->GetNumNodes() > 0)
+		{
+			auto node = static_cast<HashTableNode*>(oldList->GetHead());
+			oldList->Remove(node);
+			this->FindBucket(node->key)->InsertAfter(node);
+		}
+
+		numBucketsMigrated++;
+	}
+
+	if (this->rehashIndex == this->oldTableSize)
+	{
+		delete[] this->oldTable;
+		this->oldTable = nullptr;
+		this->oldTableSize = 0;
+		this->rehashIndex = 0;
+	}
+}
+
+void HashTable::FinishRehash()
+{
+	while (this->oldTable)
+		this->RehashStep();
+}
+
+HashTableNode* HashTable::GetFirstNode()
+{
+	HashTableNode* node = nullptr;
+
+	if (this->oldTable)
+		node = FindFirstNode(this->oldTable, this->oldTableSize, this->rehashIndex);
+
+	if (!node)
+		node = FindFirstNode(this->table, this->tableSize, 0);
+
+	return node;
+}
+
+HashTableNode* HashTable::GetNextNode(HashTableNode* node)
+{
+	if (node->GetNext())
+		return static_cast<HashTableNode*>(node->GetNext());
+
+	LinkedList* list = node->GetList();
+
+	if (this->oldTable && list >= this->oldTable && list < this->oldTable + this->oldTableSize)
+	{
+		HashTableNode* nextNode = FindFirstNode(this->oldTable, this->oldTableSize, (unsigned int)(list - this->oldTable) + 1);
+		if (nextNode)
+			return nextNode;
+
+		return FindFirstNode(this->table, this->tableSize, 0);
+	}
+
+	return FindFirstNode(this->table, this->tableSize, (unsigned int)(list - this->table) + 1);
+}
+
+/*static*/ HashTableNode* HashTable::FindFirstNode(LinkedList* table, unsigned int tableSize, unsigned int i)
+{
+	while (i < tableSize)
+	{
+		LinkedListNode* node = table[i++].GetHead();
+		if (node)
+			return static_cast<HashTableNode*>(node);
+	}
+
+	return nullptr;
+}
+
 //------------------------------ HashTableNode ------------------------------
 
 HashTableNode::HashTableNode()
@@ -9,12 +9,21 @@ namespace UU
 	class HashTableNode;
 
 	/**
-	 * 
+	 * These are hash tables that resolve collisions by chaining.  The table grows
+	 * when its load factor (the ratio of nodes to buckets) exceeds a maximum, and
+	 * shrinks when it drops well below that maximum, so that bucket chains stay short
+	 * at any size.  Rather than rehash every node at once, which would make the
+	 * occasional insertion or removal very slow, the old table is kept around after
+	 * a resize and a few of its buckets are migrated to the new table on each
+	 * subsequent insertion or removal.  Lookups consult both tables until then.
 	 */
 	class UU_API HashTable
 	{
 	public:
-		HashTable(unsigned int tableSize = 2048);
+		/**
+		 * @param[in] tableSize This is the initial number of buckets, rounded up to a power of two.  The table never shrinks below it.
+		 */
+		HashTable(unsigned int tableSize = 8);
 		virtual ~HashTable();
 
 		/**
@@ -51,10 +60,60 @@ namespace UU
 		bool DeleteNode(HashTableKey* key);
 
 		/**
-		 * Remove all nodes from this hash table.
+		 * Remove all nodes from this hash table.  The table is also
+		 * shrunk back down to its initial size.
 		 */
 		void Clear();
 
+		/**
+		 * This is like @ref Clear, but rather than delete each node, the table
+		 * removes it and then hands it to the given functor, which takes ownership of it.
+		 * Use this when the nodes were not allocated with the built-in free-store.
+		 */
+		template<typename F>
+		void Clear(F disposeFunc);
+
+		/**
+		 * Grow the table, if necessary, so that it can hold the given number of
+		 * nodes without exceeding the maximum load factor.  This is useful if the
+		 * caller knows up front roughly how many nodes will be inserted, because
+		 * the table is then never resized during those insertions.  The table
+		 * won't shrink below the reserved size afterwards, not even when cleared.
+		 */
+		void Reserve(unsigned int numNodes);
+
+		/**
+		 * Set the ratio of nodes to buckets above which the table grows.
+		 * The table shrinks when this ratio falls below a quarter of the maximum.
+		 */
+		void SetMaxLoadFactor(double maxLoadFactor);
+
+		double GetMaxLoadFactor() const { return this->maxLoadFactor; }
+
+		double GetLoadFactor() const { return double(this->numNodes) / double(this->tableSize); }
+
+		/**
+		 * Indicate whether nodes are still being migrated from an old table to
+		 * the current one, as is done incrementally after a resize.
+		 */
+		bool IsRehashing() const { return this->oldTable != nullptr; }
+
+		/**
+		 * Migrate all remaining nodes, if any, from the old table to the current one.
+		 */
+		void FinishRehash();
+
+		/**
+		 * Return the first node of this table in iteration order, or null if the table is empty.
+		 */
+		HashTableNode* GetFirstNode();
+
+		/**
+		 * Return the node after the given node in iteration order, or null if there
+		 * are no more nodes.  The table must not be modified while iterating.
+		 */
+		HashTableNode* GetNextNode(HashTableNode* node);
+
 		unsigned int GetNumNodes() const { return this->numNodes; }
 
 		unsigned int GetTableSize() const { return this->tableSize; }
@@ -62,17 +121,36 @@ namespace UU
 		LinkedList* GetTable() { return this->table; }
 
 	private:
+		LinkedList* FindBucket(const HashTableKey* key);
+		void GrowIfNeeded();
+		void ShrinkIfNeeded();
+		void Resize(unsigned int newTableSize);
+		void RehashStep();
+
+		static HashTableNode* FindFirstNode(LinkedList* table, unsigned int tableSize, unsigned int i);
+
 		LinkedList* table;
 		unsigned int tableSize;
+		unsigned int minTableSize;
+		LinkedList* oldTable;
+		unsigned int oldTableSize;
+		unsigned int rehashIndex;
 		unsigned int numNodes;
+		double maxLoadFactor;
 	};
 
 	/**
-	 * 
+	 * These are the keys by which nodes of a @ref HashTable are found.
 	 */
 	class UU_API HashTableKey
 	{
 	public:
+		/**
+		 * Return the index of the bucket for this key in a table of the given size.
+		 * The table size is always a power of two, so an implementation should mix its
+		 * key well (see @ref HashInteger and @ref HashBytes) and then mask with the
+		 * table size (see @ref HashToIndex).  The table masks the result regardless.
+		 */
 		virtual unsigned int Hash(unsigned int tableSize) const = 0;
 		virtual bool operator==(const HashTableKey& key) const = 0;
 	};
@@ -95,4 +173,25 @@ namespace UU
 		HashTable* table;
 		HashTableKey* key;
 	};
+
+	template<typename F>
+	void HashTable::Clear(F disposeFunc)
+	{
+		this->FinishRehash();
+
+		for (unsigned int i = 0; i < this->tableSize; i++)
+		{
+			LinkedList* list = &this->table[i];
+			while (list->GetNumNodes() > 0)
+			{
+				auto node = static_cast<HashTableNode*>(list->GetHead());
+				list->Remove(node);
+				node->table = nullptr;
+				this->numNodes--;
+				disposeFunc(node);
+			}
+		}
+
+		this->Clear();
+	}
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "UltraUtilities/Threading/Atomic.h"
+
+namespace UU
+{
+	/**
+	 * This is a bounded first-in-first-out queue that any number of threads can push
+	 * values to and pop values from at once, without any locking.  It's Dmitry Vyukov's
+	 * bounded MPMC queue.  Each slot has a sequence number that says whose turn it is:
+	 * a slot at position P is free for the pusher who claims P when its sequence number
+	 * is P, and holds a value for the popper who claims P when its sequence number is P+1.
+	 * Threads claim positions with a compare-exchange, so a thread only ever retries
+	 * because another thread got there first.  A push to a full queue or a pop from an
+	 * empty one just fails.
+	 */
+	template<typename T>
+	class UU_API MPMCQueue
+	{
+	public:
+		/**
+		 * @param[in] capacity This is rounded up to a power of two, and is at least two.
+		 */
+		MPMCQueue(unsigned int capacity)
+		{
+			this->capacity = RoundUpToPowerOfTwo(UU_MAX(capacity, 2U));
+			this->mask = this->capacity - 1;
+			this->slotArray = new Slot[this->capacity];
+			for (unsigned int i = 0; i < this->capacity; i++)
+				this->slotArray[i].sequence.Store(i, MemoryOrder::RELAXED);
+
+			this->pushPosition.Store(0, MemoryOrder::RELAXED);
+			this->popPosition.Store(0, MemoryOrder::RELAXED);
+		}
+
+		virtual ~MPMCQueue()
+		{
+			delete[] this->slotArray;
+		}
+
+		MPMCQueue(const MPMCQueue&) = delete;
+		void operator=(const MPMCQueue&) = delete;
+
+		/**
+		 * Add the given value to the back of the queue.
+		 *
+		 * @return False is returned if the queue is full.
+		 */
+		bool TryPush(const T& value)
+		{
+			Slot* slot = nullptr;
+			unsigned int position = this->pushPosition.Load(MemoryOrder::RELAXED);
+			while (true)
+			{
+				slot = &this->slotArray[position & this->mask];
+				int difference = (int)(slot->sequence.Load(MemoryOrder::ACQUIRE) - position);
+				if (difference == 0)
+				{
+					if (this->pushPosition.CompareExchange(position, position + 1, MemoryOrder::RELAXED))
+						break;
+				}
+				else if (difference < 0)
+					return false;		// The slot still holds the value from a lap ago, so the queue is full.
+				else
+					position = this->pushPosition.Load(MemoryOrder::RELAXED);
+			}
+
+			slot->value = value;
+			slot->sequence.Store(position + 1, MemoryOrder::RELEASE);
+			return true;
+		}
+
+		/**
+		 * Take the value at the front of the queue.
+		 *
+		 * @return False is returned if the queue is empty.
+		 */
+		bool TryPop(T& value)
+		{
+			Slot* slot = nullptr;
+			unsigned int position = this->popPosition.Load(MemoryOrder::RELAXED);
+			while (true)
+			{
+				slot = &this->slotArray[position & this->mask];
+				int difference = (int)(slot->sequence.Load(MemoryOrder::ACQUIRE) - (position + 1));
+				if (difference == 0)
+				{
+					if (this->popPosition.CompareExchange(position, position + 1, MemoryOrder::RELAXED))
+						break;
+				}
+				else if (difference < 0)
+					return false;		// Nothing has been pushed to the slot yet, so the queue is empty.
+				else
+					position = this->popPosition.Load(MemoryOrder::RELAXED);
+			}
+
+			value = static_cast<T&&>(slot->value);
+			slot->sequence.Store(position + this->capacity, MemoryOrder::RELEASE);
+			return true;
+		}
+
+		/**
+		 * Return roughly the number of values in the queue.  With other threads
+		 * at work, this may be out of date by the time it's returned.
+		 */
+		unsigned int GetSize() const
+		{
+			unsigned int popPosition = this->popPosition.Load(MemoryOrder::ACQUIRE);
+			unsigned int pushPosition = this->pushPosition.Load(MemoryOrder::ACQUIRE);
+			int size = (int)(pushPosition - popPosition);
+			return (size > 0) ? UU_MIN((unsigned int)size, this->capacity) : 0;
+		}
+
+		/**
+		 * Return the most values the queue can hold at once.
+		 */
+		unsigned int GetCapacity() const
+		{
+			return this->capacity;
+		}
+
+	private:
+		struct Slot
+		{
+			Atomic<unsigned int> sequence;
+			T value;
+		};
+
+		Slot* slotArray;
+		unsigned int capacity;
+		unsigned int mask;
+
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> pushPosition;
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> popPosition;
+	};
+}
\ No newline at end of file
@@ -22,6 +22,11 @@ namespace UU
 			this->iterationDirection = RBMapIterator<K, V>::FORWARD;
 		}
 
+		virtual ~RBMap()
+		{
+			this->Clear();
+		}
+
 		/**
 		 * This provides bracket-syntax access to the map.
 		 * Note that if you ask for the value of a key that
@@ -104,7 +109,12 @@ namespace UU
 		 */
 		void Clear()
 		{
-			this->tree.Clear();
+			// The nodes and keys came from our heaps, so that's where they have to go back to.
+			this->tree.Clear([this](RBTreeNode* node)
+				{
+					this->keyHeap.Deallocate(static_cast<RBMapKey<K>*>(node->GetKey()));
+					this->nodeHeap.Deallocate(static_cast<RBMapNode<V>*>(node));
+				});
 		}
 
 		/**
@@ -21,6 +21,11 @@ namespace UU
 			this->iterationDirection = RBSetIterator<K>::FORWARD;
 		}
 
+		virtual ~RBSet()
+		{
+			this->Clear();
+		}
+
 		/**
 		 * This provides bracket-syntax for membership queries.
 		 */
@@ -81,7 +86,12 @@ namespace UU
 		 */
 		void Clear()
 		{
-			this->tree.Clear();
+			// The nodes and keys came from our heaps, so that's where they have to go back to.
+			this->tree.Clear([this](RBTreeNode* node)
+				{
+					this->keyHeap.Deallocate(static_cast<RBMapKey<K>*>(node->GetKey()));
+					this->nodeHeap.Deallocate(node);
+				});
 		}
 
 		/**
@@ -145,6 +145,11 @@ bool RBTree::RemoveNode(RBTreeNode*& oldNode)
 		RBTreeNode* node = oldNode->FindSuccessor();	// Could use predecessor here too; doesn't matter which.
 		UU_ASSERT(!node->IsInternal());
 
+		// The old node takes on the key and value of its successor, and the successor leaves the tree
+		// in its place, taking the old key with it, so that the caller can free the returned node and its key together.
+		RBTreeKey* key = oldNode->key;
+		oldNode->key = node->key;
+		node->key = key;
 		oldNode->CopyValue(node);
 
 		if (!this->RemoveNode(node))
@@ -72,6 +72,21 @@ namespace UU
 		 */
 		void Clear();
 
+		/**
+		 * This is like @ref Clear, but rather than delete each node, the tree
+		 * detaches it and then hands it to the given functor, which takes ownership of it.
+		 * Use this when the nodes were not allocated with the built-in free-store.
+		 */
+		template<typename F>
+		void Clear(F disposeFunc)
+		{
+			if (this->rootNode)
+				DisposeSubTree(this->rootNode, disposeFunc);
+
+			this->rootNode = nullptr;
+			this->numNodes = 0;
+		}
+
 		/**
 		 * Find and return the node in this tree having the smallest key.
 		 */
@@ -101,6 +116,10 @@ namespace UU
 		const RBTreeNode* GetRootNode() const { return this->rootNode; }
 
 	private:
+		// Children are detached before their parent is disposed, since node destructors delete their children.
+		template<typename F>
+		static void DisposeSubTree(RBTreeNode* node, F& disposeFunc);
+
 		RBTreeNode* rootNode;
 		unsigned int numNodes;
 	};
@@ -260,4 +279,24 @@ namespace UU
 		virtual bool operator<=(const RBTreeKey& key) const;
 		virtual bool operator>=(const RBTreeKey& key) const;
 	};
+
+	template<typename F>
+	/*static*/ void RBTree::DisposeSubTree(RBTreeNode* node, F& disposeFunc)
+	{
+		RBTreeNode* leftChildNode = node->leftChildNode;
+		RBTreeNode* rightChildNode = node->rightChildNode;
+
+		node->leftChildNode = nullptr;
+		node->rightChildNode = nullptr;
+		node->parentNode = nullptr;
+		node->tree = nullptr;
+
+		if (leftChildNode)
+			DisposeSubTree(leftChildNode, disposeFunc);
+
+		if (rightChildNode)
+			DisposeSubTree(rightChildNode, disposeFunc);
+
+		disposeFunc(node);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "UltraUtilities/Threading/Atomic.h"
+
+namespace UU
+{
+	/**
+	 * This is a bounded first-in-first-out queue through which exactly one thread can
+	 * send values to exactly one other thread, without any locking.  Neither side ever
+	 * waits on the other; a push to a full queue or a pop from an empty one just fails.
+	 *
+	 * The sender only ever writes the tail position and the receiver only ever writes
+	 * the head position, and each is kept on a cache line of its own.  Each side also
+	 * keeps its own copy of the other side's position, and only goes to look at the real
+	 * one when its copy says the queue is full or empty.
+	 */
+	template<typename T>
+	class UU_API SPSCQueue
+	{
+	public:
+		/**
+		 * @param[in] capacity This is rounded up to a power of two.
+		 */
+		SPSCQueue(unsigned int capacity)
+		{
+			this->capacity = RoundUpToPowerOfTwo(capacity);
+			this->mask = this->capacity - 1;
+			this->valueArray = new T[this->capacity];
+			this->cachedHead = 0;
+			this->cachedTail = 0;
+		}
+
+		virtual ~SPSCQueue()
+		{
+			delete[] this->valueArray;
+		}
+
+		SPSCQueue(const SPSCQueue&) = delete;
+		void operator=(const SPSCQueue&) = delete;
+
+		/**
+		 * Add the given value to the back of the queue.  Only the sending thread may call this.
+		 *
+		 * @return False is returned if the queue is full.
+		 */
+		bool TryPush(const T& value)
+		{
+			unsigned int tail = this->tail.Load(MemoryOrder::RELAXED);
+			if (tail - this->cachedHead == this->capacity)
+			{
+				this->cachedHead = this->head.Load(MemoryOrder::ACQUIRE);
+				if (tail - this->cachedHead == this->capacity)
+					return false;
+			}
+
+			this->valueArray[tail & this->mask] = value;
+			this->tail.Store(tail + 1, MemoryOrder::RELEASE);
+			return true;
+		}
+
+		/**
+		 * Take the value at the front of the queue.  Only the receiving thread may call this.
+		 *
+		 * @return False is returned if the queue is empty.
+		 */
+		bool TryPop(T& value)
+		{
+			unsigned int head = this->head.Load(MemoryOrder::RELAXED);
+			if (head == this->cachedTail)
+			{
+				this->cachedTail = this->tail.Load(MemoryOrder::ACQUIRE);
+				if (head == this->cachedTail)
+					return false;
+			}
+
+			value = static_cast<T&&>(this->valueArray[head & this->mask]);
+			this->head.Store(head + 1, MemoryOrder::RELEASE);
+			return true;
+		}
+
+		/**
+		 * Return the number of values in the queue.  Unless called from one of its two
+		 * threads while the other is idle, this may be out of date by the time it's returned.
+		 */
+		unsigned int GetSize() const
+		{
+			// The head is loaded first.  The tail can only have moved further ahead of it since.
+			unsigned int head = this->head.Load(MemoryOrder::ACQUIRE);
+			unsigned int tail = this->tail.Load(MemoryOrder::ACQUIRE);
+			return tail - head;
+		}
+
+		/**
+		 * Return the most values the queue can hold at once.
+		 */
+		unsigned int GetCapacity() const
+		{
+			return this->capacity;
+		}
+
+	private:
+		T* valueArray;
+		unsigned int capacity;
+		unsigned int mask;
+
+		// These belong to the sender.
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> tail;
+		unsigned int cachedHead;
+
+		// These belong to the receiver.
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> head;
+		unsigned int cachedTail;
+	};
+}
\ No newline at end of file
@@ -28,14 +28,49 @@
 #define UU_MIN(a,b)			((a) < (b) ? (a) : (b))
 #define UU_MAX(a,b)			((a) > (b) ? (a) : (b))
 
+#if defined _MSC_VER
+#	include <string.h>
+#	define UU_MEMCPY(dest, src, size)			memcpy((dest), (src), (size))
+#	define UU_MEMMOVE(dest, src, size)			memmove((dest), (src), (size))
+#	define UU_MEMSET(dest, value, size)			memset((dest), (value), (size))
+#else
+#	define UU_MEMCPY(dest, src, size)			__builtin_memcpy((dest), (src), (size))
+#	define UU_MEMMOVE(dest, src, size)			__builtin_memmove((dest), (src), (size))
+#	define UU_MEMSET(dest, value, size)			__builtin_memset((dest), (value), (size))
+#endif
+
+// True if objects of the given type can be copied or relocated with a plain memory copy.
+#define UU_IS_TRIVIALLY_COPYABLE(T)			__is_trivially_copyable(T)
+
+// Data written by different threads is kept at least this far apart so that they don't fight over the same cache line.
+#define UU_CACHE_LINE_SIZE					64
+
+// This is the largest power of two that an unsigned int can hold.
+#define UU_MAX_POWER_OF_TWO					0x80000000U
+
 namespace UU
 {
 	template<typename T>
 	inline void Exchange(T& a, T& b)
 	{
-		T temp = a;
-		a = b;
-		b = temp;
+		T temp = static_cast<T&&>(a);
+		a = static_cast<T&&>(b);
+		b = static_cast<T&&>(temp);
+	}
+
+	/**
+	 * Return the smallest power of two that is at least the given value.  Anything above
+	 * the largest power of two an unsigned int can hold is clamped down to that power,
+	 * since doubling past it would overflow to zero.
+	 */
+	inline unsigned int RoundUpToPowerOfTwo(unsigned int value)
+	{
+		UU_ASSERT(value <= UU_MAX_POWER_OF_TWO);
+		unsigned int powerOfTwo = 1;
+		while (powerOfTwo < value && powerOfTwo < UU_MAX_POWER_OF_TWO)
+			powerOfTwo <<= 1;
+
+		return powerOfTwo;
 	}
 
 	template<typename Functor>
@@ -0,0 +1,232 @@
+#include "UltraUtilities/Hash.h"
+
+#if defined __SSE2__ || defined _M_X64 || defined _M_AMD64
+#	define UU_HASH_USE_SSE2
+#	include <emmintrin.h>
+#endif
+
+#if !defined __SIZEOF_INT128__ && defined _M_X64
+#	include <intrin.h>
+#endif
+
+namespace UU
+{
+	// These were generated with SplitMix64 seeded with the leading digits of pi.
+	static const unsigned long long hashSecret[16] =
+	{
+		0x2CB0F69F4ABEA221ULL, 0x9417034723148989ULL, 0xDD555950609DFE03ULL, 0xDBAFB150DEB12800ULL,
+		0x7E789B2E6C442CB6ULL, 0xF41E5636C7E4F8C4ULL, 0x0959D150F8FBA7E4ULL, 0xA97316F13CDB9EEAULL,
+		0x74CD8258F9520068ULL, 0x55C74A62E116868BULL, 0xD2F4C799A2023CBDULL, 0xDF98CB79A37B51B9ULL,
+		0x396F5885524F3905ULL, 0xAF1D56386CA3B276ULL, 0xA9FFBE6B5104E85AULL, 0x6BD0C51B9FD533B3ULL
+	};
+
+	static const unsigned long long hashPrime32 = 0x9E3779B1ULL;
+	static const unsigned long long hashPrime64A = 0x9E3779B185EBCA87ULL;
+	static const unsigned long long hashPrime64B = 0xC2B2AE3D27D4EB4FULL;
+	static const unsigned long long hashPrime64C = 0x165667B19E3779F9ULL;
+
+	static const unsigned int hashStripeSize = 64;
+	static const unsigned int hashStripesPerBlock = 8;
+
+	// Compilers recognize these as single unaligned loads on little-endian machines.
+	static inline unsigned long long HashRead64(const unsigned char* bytes)
+	{
+		return
+			(unsigned long long)bytes[0] |
+			((unsigned long long)bytes[1] << 8) |
+			((unsigned long long)bytes[2] << 16) |
+			((unsigned long long)bytes[3] << 24) |
+			((unsigned long long)bytes[4] << 32) |
+			((unsigned long long)bytes[5] << 40) |
+			((unsigned long long)bytes[6] << 48) |
+			((unsigned long long)bytes[7] << 56);
+	}
+
+	static inline unsigned long long HashRead32(const unsigned char* bytes)
+	{
+		return
+			(unsigned long long)bytes[0] |
+			((unsigned long long)bytes[1] << 8) |
+			((unsigned long long)bytes[2] << 16) |
+			((unsigned long long)bytes[3] << 24);
+	}
+
+	// Multiply to get the full 128-bit product, then fold the high half into the low half.
+	static inline unsigned long long HashMultiplyFold(unsigned long long a, unsigned long long b)
+	{
+#if defined __SIZEOF_INT128__
+		unsigned __int128 product = (unsigned __int128)a * (unsigned __int128)b;
+		return (unsigned long long)product ^ (unsigned long long)(product >> 64);
+#elif defined _M_X64
+		unsigned long long high = 0;
+		unsigned long long low = _umul128(a, b, &high);
+		return low ^ high;
+#else
+		unsigned long long aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+		unsigned long long bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+		unsigned long long lowLow = aLow * bLow;
+		unsigned long long highLow = aHigh * bLow;
+		unsigned long long lowHigh = aLow * bHigh;
+		unsigned long long highHigh = aHigh * bHigh;
+		unsigned long long cross = (lowLow >> 32) + (highLow & 0xFFFFFFFF) + lowHigh;
+		unsigned long long low = (cross << 32) | (lowLow & 0xFFFFFFFF);
+		unsigned long long high = (highLow >> 32) + (cross >> 32) + highHigh;
+		return low ^ high;
+#endif
+	}
+
+	static inline unsigned long long HashAvalanche(unsigned long long hash)
+	{
+		hash ^= hash >> 37;
+		hash *= hashPrime64C;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	static inline unsigned long long HashMix16(const unsigned char* bytes, const unsigned long long* secret, unsigned long long seed)
+	{
+		return HashMultiplyFold(HashRead64(bytes) ^ (secret[0] + seed), HashRead64(bytes + 8) ^ (secret[1] - seed));
+	}
+
+	static unsigned long long HashShort(const unsigned char* bytes, unsigned int size, unsigned long long seed)
+	{
+		if (size > 8)
+		{
+			unsigned long long low = HashRead64(bytes) ^ (hashSecret[0] + seed);
+			unsigned long long high = HashRead64(bytes + size - 8) ^ (hashSecret[1] - seed);
+			return HashAvalanche(size + low + high + HashMultiplyFold(low, high));
+		}
+
+		if (size >= 4)
+		{
+			unsigned long long combined = (HashRead32(bytes) << 32) | HashRead32(bytes + size - 4);
+			return HashInteger((combined ^ (hashSecret[2] + seed)) + size);
+		}
+
+		if (size > 0)
+		{
+			unsigned long long combined = ((unsigned long long)bytes[0] << 16) | ((unsigned long long)bytes[size >> 1] << 24) | (unsigned long long)bytes[size - 1] | ((unsigned long long)size << 8);
+			return HashInteger(combined ^ (hashSecret[3] + seed));
+		}
+
+		return HashInteger(seed ^ hashSecret[4]);
+	}
+
+	static unsigned long long HashMedium(const unsigned char* bytes, unsigned int size, unsigned long long seed)
+	{
+		unsigned long long accumulator = size * hashPrime64A;
+
+		// Every chunk but the last is a full 16 bytes.  The last one overlaps its predecessor if need be.
+		unsigned int numChunks = (size + 15) / 16;
+		for (unsigned int i = 0; i < numChunks - 1; i++)
+			accumulator += HashMix16(bytes + i * 16, &hashSecret[i * 2], seed);
+		accumulator += HashMix16(bytes + size - 16, &hashSecret[(numChunks - 1) * 2], seed);
+
+		return HashAvalanche(accumulator);
+	}
+
+	// Each of the eight lanes takes a keyed 32x32->64-bit product of its own word and
+	// the unkeyed word of its neighbor.  The lanes are independent, so this vectorizes.
+	static inline void HashAccumulateStripe(unsigned long long* accumulator, const unsigned char* bytes, const unsigned long long* secret)
+	{
+#if defined UU_HASH_USE_SSE2
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i * 16));
+			__m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + i * 2));
+			__m128i dataKey = _mm_xor_si128(data, key);
+			__m128i dataKeyHigh = _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1));
+			__m128i product = _mm_mul_epu32(dataKey, dataKeyHigh);
+			__m128i dataSwapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+			__m128i* lanes = reinterpret_cast<__m128i*>(accumulator + i * 2);
+			_mm_store_si128(lanes, _mm_add_epi64(_mm_load_si128(lanes), _mm_add_epi64(product, dataSwapped)));
+		}
+#else
+		for (unsigned int i = 0; i < 8; i++)
+		{
+			unsigned long long data = HashRead64(bytes + i * 8);
+			unsigned long long dataKey = data ^ secret[i];
+			accumulator[i ^ 1] += data;
+			accumulator[i] += (dataKey & 0xFFFFFFFF) * (dataKey >> 32);
+		}
+#endif
+	}
+
+	// Between blocks we fold the high bits of each lane back into its low bits so that
+	// the 32-bit products of the next block see them.
+	static inline void HashScramble(unsigned long long* accumulator, const unsigned long long* secret)
+	{
+#if defined UU_HASH_USE_SSE2
+		__m128i prime = _mm_set1_epi32((int)hashPrime32);
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			__m128i* lanes = reinterpret_cast<__m128i*>(accumulator + i * 2);
+			__m128i lane = _mm_load_si128(lanes);
+			lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+			lane = _mm_xor_si128(lane, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + i * 2)));
+			__m128i productLow = _mm_mul_epu32(lane, prime);
+			__m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(lane, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+			_mm_store_si128(lanes, _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32)));
+		}
+#else
+		for (unsigned int i = 0; i < 8; i++)
+		{
+			unsigned long long lane = accumulator[i];
+			lane ^= lane >> 47;
+			lane ^= secret[i];
+			lane *= hashPrime32;
+			accumulator[i] = lane;
+		}
+#endif
+	}
+
+	static unsigned long long HashLong(const unsigned char* bytes, unsigned int size, unsigned long long seed)
+	{
+		alignas(16) unsigned long long accumulator[8] =
+		{
+			hashPrime32 + seed, hashPrime64A - seed, hashPrime64B + seed, hashPrime64C - seed,
+			hashPrime64A + seed, hashPrime64B - seed, hashPrime64C + seed, hashPrime32 - seed
+		};
+
+		unsigned int numStripes = (size - 1) / hashStripeSize;
+		unsigned int i = 0;
+		while (i < numStripes)
+		{
+			unsigned int stripeInBlock = i % hashStripesPerBlock;
+			HashAccumulateStripe(accumulator, bytes + i * hashStripeSize, &hashSecret[stripeInBlock]);
+			if (++i % hashStripesPerBlock == 0)
+				HashScramble(accumulator, &hashSecret[8]);
+		}
+
+		// The final stripe is always a full one, overlapping the previous if need be.
+		HashAccumulateStripe(accumulator, bytes + size - hashStripeSize, &hashSecret[7]);
+
+		unsigned long long result = size * hashPrime64A;
+		for (unsigned int j = 0; j < 4; j++)
+			result += HashMultiplyFold(accumulator[2 * j] ^ hashSecret[2 * j + 1], accumulator[2 * j + 1] ^ hashSecret[2 * j + 8]);
+
+		return HashAvalanche(result);
+	}
+
+	unsigned long long HashBytes(const void* data, unsigned int size, unsigned long long seed /*= 0*/)
+	{
+		auto bytes = static_cast<const unsigned char*>(data);
+
+		if (size <= 16)
+			return HashShort(bytes, size, seed);
+
+		if (size <= 128)
+			return HashMedium(bytes, size, seed);
+
+		return HashLong(bytes, size, seed);
+	}
+
+	unsigned long long HashString(const char* string, unsigned long long seed /*= 0*/)
+	{
+		unsigned int length = 0;
+		while (string[length] != '\0')
+			length++;
+
+		return HashBytes(string, length, seed);
+	}
+}
\ No newline at end of file
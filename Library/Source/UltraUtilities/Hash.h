@@ -0,0 +1,52 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+namespace UU
+{
+	/**
+	 * Scramble the bits of the given integer so that every bit of the result depends
+	 * on every bit of the input.  In particular, the low bits of the result are good
+	 * enough to be used directly as a bucket index, which the identity function or
+	 * the division method are not for keys that share a common stride.  This is the
+	 * 64-bit finalizer of MurmurHash3, which is also what xxHash uses to avalanche.
+	 */
+	inline unsigned long long HashInteger(unsigned long long x)
+	{
+		x ^= x >> 33;
+		x *= 0xFF51AFD7ED558CCDULL;
+		x ^= x >> 33;
+		x *= 0xC4CEB9FE1A85EC53ULL;
+		x ^= x >> 33;
+		return x;
+	}
+
+	/**
+	 * Calculate a 64-bit hash of the given bytes.  This is in the style of xxHash3.
+	 * Short inputs are read a word at a time with no loop at all, medium inputs
+	 * are folded 16 bytes at a time through a 64x64->128-bit multiply, and long inputs
+	 * are accumulated in 64-byte stripes across eight independent lanes, which is
+	 * done with SSE2 instructions where they're available.
+	 *
+	 * @param[in] data This points to the bytes to hash.  No alignment is required.
+	 * @param[in] size This is the number of bytes to hash.
+	 * @param[in] seed This can be varied to get a different, independent hash function.
+	 */
+	UU_API unsigned long long HashBytes(const void* data, unsigned int size, unsigned long long seed = 0);
+
+	/**
+	 * Calculate a 64-bit hash of the given null-terminated string using @ref HashBytes.
+	 */
+	UU_API unsigned long long HashString(const char* string, unsigned long long seed = 0);
+
+	/**
+	 * Reduce the given hash to an index into a table of the given size, which
+	 * must be a power of two.  This is just a mask, so it's much cheaper than the
+	 * division method, but it relies on the low bits of the hash being well mixed.
+	 */
+	inline unsigned int HashToIndex(unsigned long long hash, unsigned int tableSize)
+	{
+		UU_ASSERT((tableSize & (tableSize - 1)) == 0);
+		return static_cast<unsigned int>(hash) & (tableSize - 1);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,352 @@
+#include "UltraUtilities/Memory/AsyncStream.h"
+#include "UltraUtilities/Threading/Thread.h"
+
+using namespace UU;
+
+namespace UU
+{
+	/**
+	 * This does all the reading or writing of the wrapped stream.
+	 */
+	class AsyncStream::WorkerThread : public Thread
+	{
+	public:
+		WorkerThread(AsyncStream* asyncStream)
+		{
+			this->asyncStream = asyncStream;
+		}
+
+		virtual ~WorkerThread()
+		{
+			if (this->IsRunning())
+				this->Join();
+		}
+
+	protected:
+		virtual void Run() override
+		{
+			this->asyncStream->Work();
+		}
+
+	private:
+		AsyncStream* asyncStream;
+	};
+}
+
+AsyncStream::AsyncStream(ByteStream* byteStream, Mode mode, unsigned int bufferSize /*= UU_ASYNC_STREAM_BUFFER_SIZE*/, unsigned int numBuffers /*= 2*/)
+{
+	this->byteStream = byteStream;
+	this->mode = mode;
+	this->bufferSize = UU_MAX(bufferSize, 1);
+	this->numBuffers = UU_MAX(numBuffers, 2);
+	this->bufferMemory = new char[(unsigned long long)this->bufferSize * this->numBuffers];
+	this->bufferFillArray = new unsigned int[this->numBuffers];
+	this->queueHead = 0;
+	this->queueCount = 0;
+	this->stopping = false;
+	this->ended = false;
+	this->failed = false;
+	this->userIndex = 0;
+	this->userOffset = 0;
+	this->holdingBuffer = false;
+
+	for (unsigned int i = 0; i < this->numBuffers; i++)
+		this->bufferFillArray[i] = 0;
+
+	this->workerThread = new WorkerThread(this);
+	if (!this->workerThread->Start())
+	{
+		this->failed = true;
+		this->ended = true;
+	}
+}
+
+/*virtual*/ AsyncStream::~AsyncStream()
+{
+	if (this->mode == Mode::WRITE)
+		this->Flush();
+
+	{
+		MutexLocker locker(this->mutex);
+		this->stopping = true;
+		this->condition.Broadcast();
+	}
+
+	delete this->workerThread;
+	delete[] this->bufferMemory;
+	delete[] this->bufferFillArray;
+}
+
+bool AsyncStream::Flush()
+{
+	if (this->mode != Mode::WRITE)
+		return true;
+
+	if (this->userOffset > 0 && !this->HandOffBuffer())
+		return false;
+
+	MutexLocker locker(this->mutex);
+	while (this->queueCount > 0)
+		this->condition.Wait(this->mutex);
+
+	return !this->failed;
+}
+
+/*virtual*/ unsigned int AsyncStream::WriteBytes(const char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesWritten = 0;
+
+	while (numBytesWritten < bufferSize)
+	{
+		unsigned int size = 0;
+		char* reservedBuffer = this->Reserve(size);
+		if (!reservedBuffer)
+			break;
+
+		unsigned int numBytes = UU_MIN(size, bufferSize - numBytesWritten);
+		UU_MEMCPY(reservedBuffer, &buffer[numBytesWritten], numBytes);
+		this->userOffset += numBytes;
+		numBytesWritten += numBytes;
+	}
+
+	return numBytesWritten;
+}
+
+/*virtual*/ unsigned int AsyncStream::ReadBytes(char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesRead = 0;
+
+	while (numBytesRead < bufferSize)
+	{
+		unsigned int size = 0;
+		const char* peekedBuffer = this->Peek(size);
+		if (!peekedBuffer)
+			break;
+
+		unsigned int numBytes = UU_MIN(size, bufferSize - numBytesRead);
+		UU_MEMCPY(&buffer[numBytesRead], peekedBuffer, numBytes);
+		this->userOffset += numBytes;
+		numBytesRead += numBytes;
+	}
+
+	return numBytesRead;
+}
+
+/*virtual*/ unsigned int AsyncStream::GetSize()
+{
+	if (this->mode != Mode::READ)
+		return 0;
+
+	MutexLocker locker(this->mutex);
+
+	unsigned int size = 0;
+	for (unsigned int i = 0; i < this->queueCount; i++)
+		size += this->bufferFillArray[(this->queueHead + i) % this->numBuffers];
+
+	if (this->holdingBuffer)
+		size -= this->userOffset;
+
+	return size;
+}
+
+/*virtual*/ const char* AsyncStream::Peek(unsigned int& size)
+{
+	size = 0;
+
+	if (this->mode != Mode::READ)
+		return nullptr;
+
+	if (!this->holdingBuffer || this->userOffset == this->bufferFillArray[this->queueHead])
+	{
+		if (!this->TakeBuffer())
+			return nullptr;
+	}
+
+	size = this->bufferFillArray[this->queueHead] - this->userOffset;
+	return &this->bufferMemory[(unsigned long long)this->queueHead * this->bufferSize + this->userOffset];
+}
+
+/*virtual*/ bool AsyncStream::Consume(unsigned int size)
+{
+	while (size > 0)
+	{
+		unsigned int peekedSize = 0;
+		if (!this->Peek(peekedSize))
+			return false;
+
+		unsigned int numBytes = UU_MIN(size, peekedSize);
+		this->userOffset += numBytes;
+		size -= numBytes;
+	}
+
+	return true;
+}
+
+/*virtual*/ char* AsyncStream::Reserve(unsigned int& size)
+{
+	size = 0;
+
+	if (this->mode != Mode::WRITE)
+		return nullptr;
+
+	if (this->userOffset == this->bufferSize && !this->HandOffBuffer())
+		return nullptr;
+
+	size = this->bufferSize - this->userOffset;
+	return &this->bufferMemory[(unsigned long long)this->userIndex * this->bufferSize + this->userOffset];
+}
+
+/*virtual*/ bool AsyncStream::Commit(unsigned int size)
+{
+	if (this->mode != Mode::WRITE || size > this->bufferSize - this->userOffset)
+		return false;
+
+	this->userOffset += size;
+	return true;
+}
+
+bool AsyncStream::HandOffBuffer()
+{
+	MutexLocker locker(this->mutex);
+
+	if (this->failed)
+		return false;
+
+	this->bufferFillArray[this->userIndex] = this->userOffset;
+	this->queueCount++;
+	this->condition.Broadcast();
+
+	// Wait for a buffer to come free.  The next one to fill is always the one after the last full one.
+	while (this->queueCount == this->numBuffers)
+		this->condition.Wait(this->mutex);
+
+	this->userIndex = (this->queueHead + this->queueCount) % this->numBuffers;
+	this->userOffset = 0;
+	return !this->failed;
+}
+
+bool AsyncStream::TakeBuffer()
+{
+	MutexLocker locker(this->mutex);
+
+	if (this->holdingBuffer)
+	{
+		this->holdingBuffer = false;
+		this->queueHead = (this->queueHead + 1) % this->numBuffers;
+		this->queueCount--;
+		this->condition.Broadcast();
+	}
+
+	while (this->queueCount == 0 && !this->ended)
+		this->condition.Wait(this->mutex);
+
+	if (this->queueCount == 0)
+		return false;
+
+	this->holdingBuffer = true;
+	this->userOffset = 0;
+	return true;
+}
+
+void AsyncStream::Work()
+{
+	if (this->mode == Mode::WRITE)
+		this->WorkOnWrites();
+	else
+		this->WorkOnReads();
+}
+
+void AsyncStream::WorkOnWrites()
+{
+	while (true)
+	{
+		unsigned int index = 0;
+		bool skip = false;
+
+		{
+			MutexLocker locker(this->mutex);
+
+			while (this->queueCount == 0 && !this->stopping)
+				this->condition.Wait(this->mutex);
+
+			if (this->queueCount == 0)
+				return;
+
+			index = this->queueHead;
+			skip = this->failed;
+		}
+
+		// Once a write has failed, the rest are let go of unwritten so that nobody waits on them forever.
+		bool written = true;
+		if (!skip)
+		{
+			const char* buffer = &this->bufferMemory[(unsigned long long)index * this->bufferSize];
+			unsigned int size = this->bufferFillArray[index];
+			unsigned int numBytesWritten = 0;
+			while (numBytesWritten < size)
+			{
+				unsigned int numBytes = this->byteStream->WriteBytes(&buffer[numBytesWritten], size - numBytesWritten);
+				if (numBytes == 0)
+					break;
+
+				numBytesWritten += numBytes;
+			}
+
+			written = (numBytesWritten == size);
+		}
+
+		MutexLocker locker(this->mutex);
+		if (!written)
+			this->failed = true;
+
+		this->queueHead = (index + 1) % this->numBuffers;
+		this->queueCount--;
+		this->condition.Broadcast();
+	}
+}
+
+void AsyncStream::WorkOnReads()
+{
+	while (true)
+	{
+		unsigned int index = 0;
+
+		{
+			MutexLocker locker(this->mutex);
+
+			while (this->queueCount == this->numBuffers && !this->stopping)
+				this->condition.Wait(this->mutex);
+
+			if (this->stopping)
+				return;
+
+			index = (this->queueHead + this->queueCount) % this->numBuffers;
+		}
+
+		// Nobody else looks at this buffer until it's added to the full ones.
+		char* buffer = &this->bufferMemory[(unsigned long long)index * this->bufferSize];
+		unsigned int size = 0;
+		while (size < this->bufferSize)
+		{
+			unsigned int numBytes = this->byteStream->ReadBytes(&buffer[size], this->bufferSize - size);
+			if (numBytes == 0)
+				break;
+
+			size += numBytes;
+		}
+
+		MutexLocker locker(this->mutex);
+		if (size > 0)
+		{
+			this->bufferFillArray[index] = size;
+			this->queueCount++;
+		}
+
+		if (size < this->bufferSize)
+			this->ended = true;
+
+		this->condition.Broadcast();
+		if (this->ended)
+			return;
+	}
+}
\ No newline at end of file
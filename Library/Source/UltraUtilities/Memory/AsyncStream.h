@@ -0,0 +1,102 @@
+#pragma once
+
+#include "UltraUtilities/Memory/ByteStream.h"
+#include "UltraUtilities/Threading/ConditionVariable.h"
+
+#define UU_ASYNC_STREAM_BUFFER_SIZE			(256 * 1024)
+
+namespace UU
+{
+	/**
+	 * This wraps another stream so that it's read or written on a thread of its own.
+	 * Bytes pass through a small number of buffers.  When writing, one buffer is filled
+	 * while the thread writes the ones before it to the wrapped stream.  When reading,
+	 * the thread reads ahead from the wrapped stream into the buffers while the one
+	 * ahead of them is being used.  This way a codec writing to a slow stream, or reading
+	 * from one, can get on with its work instead of waiting.  Two buffers make for double
+	 * buffering, three for triple buffering, and so on.
+	 *
+	 * A stream made for writing can't be read from, and vice versa.  When reading, the end
+	 * is reached the first time the wrapped stream gives no bytes.  The wrapped stream must
+	 * not be used by anything else while this has it, and it isn't owned by this.
+	 */
+	class UU_API AsyncStream : public ByteStream
+	{
+	public:
+		enum class Mode
+		{
+			READ,
+			WRITE
+		};
+
+		/**
+		 * Start the thread that reads or writes the given stream.
+		 *
+		 * @param[in] byteStream This is the stream to read or write.
+		 * @param[in] mode This says whether the given stream is to be read or written.
+		 * @param[in] bufferSize This is the size of each buffer.
+		 * @param[in] numBuffers This is how many buffers there are, which is at least two.
+		 */
+		AsyncStream(ByteStream* byteStream, Mode mode, unsigned int bufferSize = UU_ASYNC_STREAM_BUFFER_SIZE, unsigned int numBuffers = 2);
+
+		/**
+		 * When writing, everything written is flushed to the wrapped stream before the thread is stopped.
+		 */
+		virtual ~AsyncStream();
+
+		AsyncStream(const AsyncStream&) = delete;
+		void operator=(const AsyncStream&) = delete;
+
+		/**
+		 * When writing, wait until everything written so far has been written to the wrapped stream.
+		 *
+		 * @return False is returned if the wrapped stream couldn't take everything, or the thread couldn't be started.
+		 */
+		bool Flush();
+
+		virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
+
+		/**
+		 * When reading, this is the number of bytes that have been read ahead and not yet used.
+		 * There may be more to come from the wrapped stream.  When writing, this is zero.
+		 */
+		virtual unsigned int GetSize() override;
+
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
+
+	private:
+		class WorkerThread;
+
+		void Work();
+		void WorkOnWrites();
+		void WorkOnReads();
+		bool HandOffBuffer();
+		bool TakeBuffer();
+
+		ByteStream* byteStream;
+		Mode mode;
+		unsigned int bufferSize;
+		unsigned int numBuffers;
+		char* bufferMemory;
+		unsigned int* bufferFillArray;
+		WorkerThread* workerThread;
+
+		// The buffers go round in a circle.  These are guarded by the mutex.
+		Mutex mutex;
+		ConditionVariable condition;
+		unsigned int queueHead;				///< The oldest full buffer.
+		unsigned int queueCount;			///< The number of full buffers, counting on from the oldest.
+		bool stopping;
+		bool ended;
+		bool failed;
+
+		// These are only touched by the user of this stream.
+		unsigned int userIndex;				///< When writing, this is the buffer being filled.
+		unsigned int userOffset;			///< How far into its buffer the user has written or read.
+		bool holdingBuffer;					///< When reading, this says if the oldest full buffer is being used.
+	};
+}
\ No newline at end of file
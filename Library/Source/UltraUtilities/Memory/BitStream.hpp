@@ -2,61 +2,102 @@
 
 #include "UltraUtilities/Memory/ByteStream.h"
 
+// This is the default size of the chunks in which a bit stream reads and writes its byte stream.
+#define UU_BIT_STREAM_CHUNK_SIZE		4096
+
+// This is the most bits that can be read or written in one go without splitting.
+#define UU_BIT_STREAM_MAX_BITS			57
+
+// Room reserved in a byte stream is only written to directly if there is at least this much of it.
+#define UU_BIT_STREAM_MIN_RESERVE_SIZE	16
+
 namespace UU
 {
 	/**
 	 * This class sits on top of a byte stream and lets you read and write
 	 * in terms of bits instead of bytes.  This can be useful if you're trying
 	 * to read or write very compact data.
+	 *
+	 * Bits are packed LSB-first.  They accumulate in a 64-bit register, so that
+	 * up to 57 bits at a time are read or written with a few shifts and masks, and
+	 * whole bytes go to and from the byte stream in chunks, so that the byte stream
+	 * is called once every few thousand bytes rather than once per byte.  Where the
+	 * byte stream supports @ref ByteStream::Peek and @ref ByteStream::Reserve, the
+	 * chunks are the byte stream's own memory, so nothing is copied in between.
+	 *
+	 * Two things follow from this.  First, written bits don't reach the byte stream
+	 * until a chunk fills up or @ref Flush is called.  Second, reading may pull more
+	 * from the byte stream than the bits actually read, up to a chunk, or up to all
+	 * the stream has if it can be peeked at, so a byte stream being read through a
+	 * bit stream should be left to the bit stream from then on.
 	 */
 	class UU_API BitStream
 	{
 	public:
-		BitStream(ByteStream* byteStream)
+		BitStream(ByteStream* byteStream, unsigned int chunkSize = UU_BIT_STREAM_CHUNK_SIZE)
 		{
 			this->byteStream = byteStream;
-			this->currentByteWrite = 0;
-			this->bitOffsetWrite = 0;
-			this->currentByteRead = 0;
-			this->bitOffsetRead = 7;
+			this->chunkSize = (chunkSize < 16) ? 16 : chunkSize;
+
+			this->writeChunk = nullptr;
+			this->writeChunkBuffer = nullptr;
+			this->writeChunkSize = 0;
+			this->writeChunkCapacity = 0;
+			this->writeChunkReserved = false;
+			this->writeBits = 0;
+			this->numWriteBits = 0;
+			this->writeFailed = false;
+
+			this->readChunk = nullptr;
+			this->readChunkBuffer = nullptr;
+			this->readChunkOffset = 0;
+			this->readChunkSize = 0;
+			this->readChunkPeeked = false;
+			this->readBits = 0;
+			this->numReadBits = 0;
 		}
 
+		/**
+		 * Anything written but not yet flushed is flushed here.
+		 */
 		virtual ~BitStream()
 		{
+			if (this->writeChunk && (this->numWriteBits > 0 || this->writeChunkSize > 0))
+				this->Flush();
+
+			// Whatever we were reading in place is let go of along with the rest.
+			if (this->readChunkPeeked)
+				this->byteStream->Consume(this->readChunkSize);
+
+			delete[] this->writeChunkBuffer;
+			delete[] this->readChunkBuffer;
 		}
 
 		/**
 		 * Write the given number of bits in the given data to the byte stream.
-		 * 
+		 *
 		 * @param[in] dataIn Bits are taken from this starting at the LSB and moving toward the MSB.
 		 * @param[in] numBits This is the number of bits to write and must not exceed the number of bits available in the given data.
-		 * @return Failure can occur here if the underlying byte stream fails to write.
+		 * @return Failure can occur here if the underlying byte stream fails to write.  Since writes are buffered, this may be reported by a later call.
 		 */
 		template<typename T>
 		bool WriteBits(T dataIn, unsigned int numBits)
 		{
-			if (numBits / 8 > sizeof(T))
+			if (numBits > sizeof(T) * 8)
 				return false;
 
-			for (unsigned int i = 0; i < numBits; i++)
+			unsigned long long data = (unsigned long long)dataIn;
+
+			if (numBits > UU_BIT_STREAM_MAX_BITS)
 			{
-				if ((dataIn & (1 << i)) != 0)
-					this->currentByteWrite |= (1 << this->bitOffsetWrite);
+				if (!this->WriteBitsFast(data & 0xFFFFFFFF, 32))
+					return false;
 
-				if (++this->bitOffsetWrite == 8)
-				{
-					if (this->byteStream->WriteBytes((const char*)&this->currentByteWrite, 1) != 1)
-					{
-						this->bitOffsetWrite--;
-						return false;
-					}
-
-					this->bitOffsetWrite = 0;
-					this->currentByteWrite = 0;
-				}
+				data >>= 32;
+				numBits -= 32;
 			}
 
-			return true;
+			return this->WriteBitsFast(data & ((1ULL << numBits) - 1), numBits);
 		}
 
 		/**
@@ -69,38 +110,64 @@ namespace UU
 			return this->WriteBits(dataIn, sizeof(T) * 8);
 		}
 
+		/**
+		 * Write the given bits, which must not have any bits set at or above the given number
+		 * of bits.  The number of bits must not exceed UU_BIT_STREAM_MAX_BITS.  This is what
+		 * @ref WriteBits calls, but with no conversion, masking or splitting.
+		 */
+		bool WriteBitsFast(unsigned long long data, unsigned int numBits)
+		{
+			// The pending bits and the new bits fit in the register together because there are fewer than 8 pending.
+			this->writeBits |= data << this->numWriteBits;
+			this->numWriteBits += numBits;
+
+			if (!this->writeChunk || this->writeChunkSize > this->writeChunkCapacity - 8)
+			{
+				if (!this->FlushChunk() || !this->NextWriteChunk())
+					return false;
+			}
+
+			// Write all 8 bytes of the register, but only count the whole ones.  The rest get written again next time.
+			StoreLittleEndian(&this->writeChunk[this->writeChunkSize], this->writeBits);
+			unsigned int numBytes = this->numWriteBits >> 3;
+			this->writeChunkSize += numBytes;
+			this->writeBits >>= (numBytes * 8) & 63;
+			this->numWriteBits &= 7;
+			this->writeBits &= (1ULL << this->numWriteBits) - 1;
+
+			return !this->writeFailed;
+		}
+
 		/**
 		 * Read the given number of bits into the given data from the byte stream.
-		 * 
+		 *
 		 * @param[out] dataOut Bits are put into this starting at the LSB and moving toward the MSB.
 		 * @param[in] numBits This is the number of bits to read and must not exceed the number of bits available in the given data.
-		 * @return Failure can occur here if the underlying byte stream fails to read.
+		 * @return Failure can occur here if the underlying byte stream runs out of data.
 		 */
 		template<typename T>
 		bool ReadBits(T& dataOut, unsigned int numBits)
 		{
-			if (numBits / 8 > sizeof(T))
+			if (numBits > sizeof(T) * 8)
 				return false;
 
-			dataOut = (T)0;
+			unsigned long long data = 0;
 
-			for (unsigned int i = 0; i < numBits; i++)
+			if (numBits > UU_BIT_STREAM_MAX_BITS)
 			{
-				if (++this->bitOffsetRead == 8)
-				{
-					if (this->byteStream->ReadBytes((char*)&this->currentByteRead, 1) != 1)
-					{
-						this->bitOffsetRead--;
-						return false;
-					}
+				unsigned long long lowData = 0;
+				if (!this->ReadBitsFast(lowData, 32))
+					return false;
 
-					this->bitOffsetRead = 0;
-				}
+				if (!this->ReadBitsFast(data, numBits - 32))
+					return false;
 
-				if ((this->currentByteRead & (1 << this->bitOffsetRead)) != 0)
-					dataOut |= (1 << i);
+				data = (data << 32) | lowData;
 			}
+			else if (!this->ReadBitsFast(data, numBits))
+				return false;
 
+			dataOut = (T)data;
 			return true;
 		}
 
@@ -114,21 +181,228 @@ namespace UU
 			return this->ReadBits(dataOut, sizeof(T) * 8);
 		}
 
+		/**
+		 * Read the given number of bits, which must not exceed UU_BIT_STREAM_MAX_BITS.
+		 * This is what @ref ReadBits calls, but with no conversion or splitting.
+		 */
+		bool ReadBitsFast(unsigned long long& data, unsigned int numBits)
+		{
+			if (this->numReadBits < numBits)
+			{
+				this->Refill();
+				if (this->numReadBits < numBits)
+					return false;
+			}
+
+			data = this->readBits & ((1ULL << numBits) - 1);
+			this->readBits >>= numBits;
+			this->numReadBits -= numBits;
+			return true;
+		}
+
+		/**
+		 * Look at the upcoming bits without consuming them.  This is for decoders
+		 * that need to see a code before they know how long it is.  Follow this
+		 * with a call to @ref SkipBits once the number of bits used is known.
+		 *
+		 * @param[out] data The upcoming bits are put here, starting at the LSB.  Bits beyond those available are zero.
+		 * @return The number of bits available is returned.  This is at least 57 unless the byte stream is running out.
+		 */
+		unsigned int PeekBits(unsigned long long& data)
+		{
+			if (this->numReadBits < UU_BIT_STREAM_MAX_BITS)
+				this->Refill();
+
+			data = this->readBits;
+			return this->numReadBits;
+		}
+
+		/**
+		 * Consume the given number of bits, which must not exceed
+		 * the number last reported available by @ref PeekBits.
+		 */
+		bool SkipBits(unsigned int numBits)
+		{
+			if (numBits > this->numReadBits)
+				return false;
+
+			this->readBits = (numBits < 64) ? (this->readBits >> numBits) : 0;
+			this->numReadBits -= numBits;
+			return true;
+		}
+
+		/**
+		 * Discard what's left of the byte currently being read, so that the next
+		 * read starts on a byte boundary.  This is the reading counterpart to the
+		 * padding that @ref Flush writes.
+		 */
+		void SkipToByteBoundary()
+		{
+			// Only whole bytes are ever loaded, so whatever isn't a multiple of 8 is the tail of the current byte.
+			this->SkipBits(this->numReadBits & 7);
+		}
+
 		/**
 		 * Once you're done writing to the bit stream, you should call this
-		 * to flush any pending bits that there may be in the current byte.
+		 * to flush any pending bits that there may be in the current byte,
+		 * along with any buffered bytes.  The current byte is padded with zeros.
 		 */
 		bool Flush()
 		{
-			unsigned char data = 0;
-			return this->WriteBits(data, 8 - this->bitOffsetWrite);
+			if (!this->writeChunk)
+				return true;
+
+			if (this->numWriteBits > 0)
+			{
+				if (!this->WriteBitsFast(0, 8 - this->numWriteBits))
+					return false;
+			}
+
+			return this->FlushChunk();
 		}
 
 	private:
+		static void StoreLittleEndian(unsigned char* buffer, unsigned long long data)
+		{
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			data = __builtin_bswap64(data);
+#endif
+			UU_MEMCPY(buffer, &data, 8);
+		}
+
+		static unsigned long long LoadLittleEndian(const unsigned char* buffer)
+		{
+			unsigned long long data = 0;
+			UU_MEMCPY(&data, buffer, 8);
+#if defined __BYTE_ORDER__ && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+			data = __builtin_bswap64(data);
+#endif
+			return data;
+		}
+
+		// Write out the whole bytes we've buffered so far, and let go of the chunk they were in.
+		bool FlushChunk()
+		{
+			if (!this->writeChunk)
+				return !this->writeFailed;
+
+			if (this->writeChunkReserved)
+			{
+				if (!this->byteStream->Commit(this->writeChunkSize))
+					this->writeFailed = true;
+			}
+			else if (this->writeChunkSize > 0)
+			{
+				if (this->byteStream->WriteBytes((const char*)this->writeChunk, this->writeChunkSize) != this->writeChunkSize)
+					this->writeFailed = true;
+			}
+
+			this->writeChunk = nullptr;
+			this->writeChunkSize = 0;
+			this->writeChunkCapacity = 0;
+			this->writeChunkReserved = false;
+
+			return !this->writeFailed;
+		}
+
+		// Find somewhere to put the next chunk, preferably straight in the byte stream.
+		bool NextWriteChunk()
+		{
+			unsigned int reservedSize = 0;
+			char* reservedBuffer = this->byteStream->Reserve(reservedSize);
+			if (reservedBuffer && reservedSize >= UU_BIT_STREAM_MIN_RESERVE_SIZE)
+			{
+				this->writeChunk = (unsigned char*)reservedBuffer;
+				this->writeChunkCapacity = reservedSize;
+				this->writeChunkReserved = true;
+				return true;
+			}
+
+			if (!this->writeChunkBuffer)
+				this->writeChunkBuffer = new unsigned char[this->chunkSize];
+
+			this->writeChunk = this->writeChunkBuffer;
+			this->writeChunkCapacity = this->chunkSize;
+			return true;
+		}
+
+		// Move on to the next chunk to read, preferably straight from the byte stream.
+		bool NextReadChunk()
+		{
+			if (this->readChunkPeeked)
+			{
+				this->byteStream->Consume(this->readChunkSize);
+				this->readChunkPeeked = false;
+			}
+
+			this->readChunkOffset = 0;
+
+			unsigned int peekedSize = 0;
+			const char* peekedBuffer = this->byteStream->Peek(peekedSize);
+			if (peekedBuffer && peekedSize > 0)
+			{
+				this->readChunk = (const unsigned char*)peekedBuffer;
+				this->readChunkSize = peekedSize;
+				this->readChunkPeeked = true;
+				return true;
+			}
+
+			if (!this->readChunkBuffer)
+				this->readChunkBuffer = new unsigned char[this->chunkSize];
+
+			this->readChunk = this->readChunkBuffer;
+			this->readChunkSize = this->byteStream->ReadBytes((char*)this->readChunkBuffer, this->chunkSize);
+			return this->readChunkSize > 0;
+		}
+
+		// Top up the read register so that it holds at least 57 bits, or else everything that's left.
+		void Refill()
+		{
+			while (this->numReadBits <= UU_BIT_STREAM_MAX_BITS - 1)
+			{
+				if (this->readChunkSize - this->readChunkOffset >= 8)
+				{
+					// Load a whole word, but only take as many bytes as fit in the register.
+					this->readBits |= LoadLittleEndian(&this->readChunk[this->readChunkOffset]) << this->numReadBits;
+					unsigned int numBytes = (64 - this->numReadBits) >> 3;
+					this->readChunkOffset += numBytes;
+					this->numReadBits += numBytes * 8;
+					this->readBits &= (this->numReadBits < 64) ? ((1ULL << this->numReadBits) - 1) : ~0ULL;
+					return;
+				}
+
+				if (this->readChunkOffset == this->readChunkSize)
+				{
+					if (!this->NextReadChunk())
+						return;
+
+					continue;
+				}
+
+				// We're near the end of the chunk, so go a byte at a time.
+				this->readBits |= (unsigned long long)this->readChunk[this->readChunkOffset++] << this->numReadBits;
+				this->numReadBits += 8;
+			}
+		}
+
 		ByteStream* byteStream;
-		unsigned int bitOffsetWrite;
-		unsigned char currentByteWrite;
-		unsigned int bitOffsetRead;
-		unsigned char currentByteRead;
+		unsigned int chunkSize;
+
+		unsigned char* writeChunk;
+		unsigned char* writeChunkBuffer;
+		unsigned int writeChunkSize;
+		unsigned int writeChunkCapacity;
+		bool writeChunkReserved;
+		unsigned long long writeBits;
+		unsigned int numWriteBits;
+		bool writeFailed;
+
+		const unsigned char* readChunk;
+		unsigned char* readChunkBuffer;
+		unsigned int readChunkOffset;
+		unsigned int readChunkSize;
+		bool readChunkPeeked;
+		unsigned long long readBits;
+		unsigned int numReadBits;
 	};
 }
\ No newline at end of file
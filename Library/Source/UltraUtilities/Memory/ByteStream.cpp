@@ -17,6 +17,58 @@ ByteStream::ByteStream()
 	return nullptr;
 }
 
+/*virtual*/ const char* ByteStream::Peek(unsigned int& size)
+{
+	size = 0;
+	return nullptr;
+}
+
+/*virtual*/ bool ByteStream::Consume(unsigned int /*size*/)
+{
+	return false;
+}
+
+/*virtual*/ char* ByteStream::Reserve(unsigned int& size)
+{
+	size = 0;
+	return nullptr;
+}
+
+/*virtual*/ bool ByteStream::Commit(unsigned int /*size*/)
+{
+	return false;
+}
+
+/*virtual*/ unsigned int ByteStream::WriteBytesV(const ByteSegment* segmentArray, unsigned int numSegments)
+{
+	unsigned int totalBytesWritten = 0;
+
+	for (unsigned int i = 0; i < numSegments; i++)
+	{
+		unsigned int numBytesWritten = this->WriteBytes(segmentArray[i].buffer, segmentArray[i].bufferSize);
+		totalBytesWritten += numBytesWritten;
+		if (numBytesWritten != segmentArray[i].bufferSize)
+			break;
+	}
+
+	return totalBytesWritten;
+}
+
+/*virtual*/ unsigned int ByteStream::ReadBytesV(const ByteSegment* segmentArray, unsigned int numSegments)
+{
+	unsigned int totalBytesRead = 0;
+
+	for (unsigned int i = 0; i < numSegments; i++)
+	{
+		unsigned int numBytesRead = this->ReadBytes(segmentArray[i].buffer, segmentArray[i].bufferSize);
+		totalBytesRead += numBytesRead;
+		if (numBytesRead != segmentArray[i].bufferSize)
+			break;
+	}
+
+	return totalBytesRead;
+}
+
 //---------------------------------- MemoryBufferStream ----------------------------------
 
 MemoryBufferStream::MemoryBufferStream(char* memoryBuffer, unsigned int memoryBufferSize, bool isFull)
@@ -36,8 +88,7 @@ MemoryBufferStream::MemoryBufferStream(char* memoryBuffer, unsigned int memoryBu
 	unsigned int numBytesCanBeWritten = this->memoryBufferSize - this->writeOffset;
 	unsigned int numBytesWritten = bufferSize <= numBytesCanBeWritten ? bufferSize : numBytesCanBeWritten;
 
-	for (unsigned int i = 0; i < numBytesWritten; i++)
-		this->memoryBuffer[this->writeOffset + i] = buffer[i];
+	UU_MEMCPY(&this->memoryBuffer[this->writeOffset], buffer, numBytesWritten);
 
 	this->writeOffset += numBytesWritten;
 	return numBytesWritten;
@@ -48,8 +99,7 @@ MemoryBufferStream::MemoryBufferStream(char* memoryBuffer, unsigned int memoryBu
 	unsigned int numBytesCanBeRead = this->GetSize();
 	unsigned int numBytesRead = bufferSize <= numBytesCanBeRead ? bufferSize : numBytesCanBeRead;
 
-	for (unsigned int i = 0; i < numBytesRead; i++)
-		buffer[i] = this->memoryBuffer[this->readOffset + i];
+	UU_MEMCPY(buffer, &this->memoryBuffer[this->readOffset], numBytesRead);
 
 	this->readOffset += numBytesRead;
 	return numBytesRead;
@@ -65,14 +115,45 @@ MemoryBufferStream::MemoryBufferStream(char* memoryBuffer, unsigned int memoryBu
 	return &this->memoryBuffer[this->readOffset];
 }
 
+/*virtual*/ const char* MemoryBufferStream::Peek(unsigned int& size)
+{
+	size = this->GetSize();
+	return (size > 0) ? &this->memoryBuffer[this->readOffset] : nullptr;
+}
+
+/*virtual*/ bool MemoryBufferStream::Consume(unsigned int size)
+{
+	if (size > this->GetSize())
+		return false;
+
+	this->readOffset += size;
+	return true;
+}
+
+/*virtual*/ char* MemoryBufferStream::Reserve(unsigned int& size)
+{
+	size = this->memoryBufferSize - this->writeOffset;
+	return (size > 0) ? &this->memoryBuffer[this->writeOffset] : nullptr;
+}
+
+/*virtual*/ bool MemoryBufferStream::Commit(unsigned int size)
+{
+	if (size > this->memoryBufferSize - this->writeOffset)
+		return false;
+
+	this->writeOffset += size;
+	return true;
+}
+
 //---------------------------------- RingBufferStream ----------------------------------
 
 RingBufferStream::RingBufferStream(unsigned int size)
 {
-	this->ringBufferSize = size;
-	this->ringBuffer = new char[size];
-	this->readOffset = 0;
-	this->writeOffset = 0;
+	this->ringBufferSize = RoundUpToPowerOfTwo(size);
+	this->ringBufferMask = this->ringBufferSize - 1;
+	this->ringBuffer = new char[this->ringBufferSize];
+	this->readPosition = 0;
+	this->writePosition = 0;
 }
 
 /*virtual*/ RingBufferStream::~RingBufferStream()
@@ -82,47 +163,124 @@ RingBufferStream::RingBufferStream(unsigned int size)
 
 /*virtual*/ unsigned int RingBufferStream::WriteBytes(const char* buffer, unsigned int bufferSize)
 {
+	ByteSegment segmentArray[2];
+	unsigned int numSegments = this->GetWritableSegments(segmentArray);
 	unsigned int numBytesWritten = 0;
 
-	while (numBytesWritten < bufferSize)
+	for (unsigned int i = 0; i < numSegments && numBytesWritten < bufferSize; i++)
 	{
-		unsigned int numBytesFree = this->ringBufferSize - this->GetSize();
-		if (numBytesFree == 0)
-			break;
-
-		this->ringBuffer[this->writeOffset] = buffer[numBytesWritten++];
-		this->writeOffset = (this->writeOffset + 1) % this->ringBufferSize;
+		unsigned int numBytes = UU_MIN(segmentArray[i].bufferSize, bufferSize - numBytesWritten);
+		UU_MEMCPY(segmentArray[i].buffer, &buffer[numBytesWritten], numBytes);
+		numBytesWritten += numBytes;
 	}
 
+	this->writePosition += numBytesWritten;
 	return numBytesWritten;
 }
 
 /*virtual*/ unsigned int RingBufferStream::ReadBytes(char* buffer, unsigned int bufferSize)
 {
+	ByteSegment segmentArray[2];
+	unsigned int numSegments = this->GetReadableSegments(segmentArray);
 	unsigned int numBytesRead = 0;
 
-	while (numBytesRead < bufferSize)
+	for (unsigned int i = 0; i < numSegments && numBytesRead < bufferSize; i++)
 	{
-		unsigned int numBytesUsed = this->GetSize();
-		if (numBytesUsed == 0)
-			break;
-
-		buffer[numBytesRead++] = this->ringBuffer[this->readOffset];
-		this->readOffset = (this->readOffset + 1) % this->ringBufferSize;
+		unsigned int numBytes = UU_MIN(segmentArray[i].bufferSize, bufferSize - numBytesRead);
+		UU_MEMCPY(&buffer[numBytesRead], segmentArray[i].buffer, numBytes);
+		numBytesRead += numBytes;
 	}
 
+	this->readPosition += numBytesRead;
 	return numBytesRead;
 }
 
 /*virtual*/ unsigned int RingBufferStream::GetSize()
 {
-	if (this->readOffset <= this->writeOffset)
-		return this->writeOffset - this->readOffset;
-
-	return this->ringBufferSize - this->readOffset + this->writeOffset;
+	// The positions only ever count up, so this is right even after they overflow.
+	return this->writePosition - this->readPosition;
 }
 
 /*virtual*/ const char* RingBufferStream::GetBuffer() const
 {
 	return nullptr;
+}
+
+/*virtual*/ const char* RingBufferStream::Peek(unsigned int& size)
+{
+	ByteSegment segmentArray[2];
+	if (this->GetReadableSegments(segmentArray) == 0)
+	{
+		size = 0;
+		return nullptr;
+	}
+
+	size = segmentArray[0].bufferSize;
+	return segmentArray[0].buffer;
+}
+
+/*virtual*/ bool RingBufferStream::Consume(unsigned int size)
+{
+	if (size > this->GetSize())
+		return false;
+
+	this->readPosition += size;
+	return true;
+}
+
+/*virtual*/ char* RingBufferStream::Reserve(unsigned int& size)
+{
+	ByteSegment segmentArray[2];
+	if (this->GetWritableSegments(segmentArray) == 0)
+	{
+		size = 0;
+		return nullptr;
+	}
+
+	size = segmentArray[0].bufferSize;
+	return segmentArray[0].buffer;
+}
+
+/*virtual*/ bool RingBufferStream::Commit(unsigned int size)
+{
+	if (size > this->ringBufferSize - this->GetSize())
+		return false;
+
+	this->writePosition += size;
+	return true;
+}
+
+unsigned int RingBufferStream::GetCapacity() const
+{
+	return this->ringBufferSize;
+}
+
+unsigned int RingBufferStream::GetReadableSegments(ByteSegment* segmentArray)
+{
+	unsigned int size = this->GetSize();
+	unsigned int offset = this->readPosition & this->ringBufferMask;
+	return this->GetSegments(segmentArray, offset, size);
+}
+
+unsigned int RingBufferStream::GetWritableSegments(ByteSegment* segmentArray)
+{
+	unsigned int size = this->ringBufferSize - this->GetSize();
+	unsigned int offset = this->writePosition & this->ringBufferMask;
+	return this->GetSegments(segmentArray, offset, size);
+}
+
+unsigned int RingBufferStream::GetSegments(ByteSegment* segmentArray, unsigned int offset, unsigned int size)
+{
+	if (size == 0)
+		return 0;
+
+	// The first piece runs to the end of the ring, and whatever's left over wraps around to the start.
+	segmentArray[0].buffer = &this->ringBuffer[offset];
+	segmentArray[0].bufferSize = UU_MIN(size, this->ringBufferSize - offset);
+	if (segmentArray[0].bufferSize == size)
+		return 1;
+
+	segmentArray[1].buffer = this->ringBuffer;
+	segmentArray[1].bufferSize = size - segmentArray[0].bufferSize;
+	return 2;
 }
\ No newline at end of file
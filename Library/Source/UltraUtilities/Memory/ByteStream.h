@@ -4,6 +4,16 @@
 
 namespace UU
 {
+	/**
+	 * This is one of several buffers read or written together by @ref ByteStream::ReadBytesV
+	 * or @ref ByteStream::WriteBytesV.  For writes, the buffer is only read from.
+	 */
+	struct ByteSegment
+	{
+		char* buffer;
+		unsigned int bufferSize;
+	};
+
 	/**
 	 * This is the base class for any type of byte stream.  It could be an in-memory stream,
 	 * a network stream, a file stream, etc.  They can be input-only, output-only, bidirectional.
@@ -45,6 +55,54 @@ namespace UU
 		 * This does not have to be supported by the stream.
 		 */
 		virtual const char* GetBuffer() const;
+
+		/**
+		 * Return a pointer to the next bytes to be read, without reading them, so that they can be
+		 * used where they are instead of being copied out.  They stay put until they're consumed with
+		 * @ref Consume, and nothing else should be read from this stream in the meantime.  This does
+		 * not have to be supported by the stream, in which case @ref ReadBytes must be used instead.
+		 *
+		 * @param[out] size This is given the number of bytes that can be read at the returned pointer.  There may be more past them that aren't contiguous with them.
+		 * @return A pointer to the next bytes to be read is returned, or null if there are none or this isn't supported.
+		 */
+		virtual const char* Peek(unsigned int& size);
+
+		/**
+		 * Move past the given number of bytes, as if they had been read.  This is usually done after
+		 * @ref Peek, and must not be more than is in the stream.
+		 */
+		virtual bool Consume(unsigned int size);
+
+		/**
+		 * Return a pointer to where the next bytes written will go, so that they can be put there
+		 * directly instead of being copied in.  They aren't part of the stream until they're committed
+		 * with @ref Commit, and nothing else should be written to this stream in the meantime.  This does
+		 * not have to be supported by the stream, in which case @ref WriteBytes must be used instead.
+		 *
+		 * @param[out] size This is given the number of bytes that can be written at the returned pointer.
+		 * @return A pointer to where the next bytes go is returned, or null if there's no room or this isn't supported.
+		 */
+		virtual char* Reserve(unsigned int& size);
+
+		/**
+		 * Add the given number of bytes, which were written where @ref Reserve said, to the stream.
+		 * This must not be more than was reserved.
+		 */
+		virtual bool Commit(unsigned int size);
+
+		/**
+		 * Write the given buffers to this stream one after another, as if by a call to @ref WriteBytes for each.
+		 *
+		 * @return The total number of bytes written is returned.  This stops at the first buffer that is not written in full.
+		 */
+		virtual unsigned int WriteBytesV(const ByteSegment* segmentArray, unsigned int numSegments);
+
+		/**
+		 * Fill the given buffers from this stream one after another, as if by a call to @ref ReadBytes for each.
+		 *
+		 * @return The total number of bytes read is returned.  This stops at the first buffer that is not filled.
+		 */
+		virtual unsigned int ReadBytesV(const ByteSegment* segmentArray, unsigned int numSegments);
 	};
 
 	/**
@@ -61,6 +119,10 @@ namespace UU
 		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
 		virtual unsigned int GetSize() override;
 		virtual const char* GetBuffer() const override;
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
 
 	private:
 		char* memoryBuffer;
@@ -74,6 +136,12 @@ namespace UU
 	 * and from which you can perpetually read, provided the amount of
 	 * data in the stream at any one given time never goes over a pre-
 	 * determined size limit.
+	 *
+	 * The size is rounded up to a power of two, so that positions wrap
+	 * around with a mask, and the read and write positions count up without
+	 * wrapping, so that a full ring can be told apart from an empty one and
+	 * every byte of it can be used.  Data goes in and out with at most two
+	 * copies, one for each side of the point where the ring wraps around.
 	 */
 	class UU_API RingBufferStream : public ByteStream
 	{
@@ -85,11 +153,41 @@ namespace UU
 		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
 		virtual unsigned int GetSize() override;
 		virtual const char* GetBuffer() const override;
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
+
+		/**
+		 * Return the most bytes this stream can hold at once.
+		 */
+		unsigned int GetCapacity() const;
+
+		/**
+		 * Give the bytes there are to read as up to two contiguous pieces, in the order
+		 * they're to be read.  Follow this with @ref Consume once they've been used.
+		 *
+		 * @param[out] segmentArray This must have room for two segments.  Their buffers point into this stream.
+		 * @return The number of segments given, from zero to two, is returned.
+		 */
+		unsigned int GetReadableSegments(ByteSegment* segmentArray);
+
+		/**
+		 * Give the free space there is to write as up to two contiguous pieces, in the order
+		 * they're to be written.  Follow this with @ref Commit once they've been filled.
+		 *
+		 * @param[out] segmentArray This must have room for two segments.  Their buffers point into this stream.
+		 * @return The number of segments given, from zero to two, is returned.
+		 */
+		unsigned int GetWritableSegments(ByteSegment* segmentArray);
 
 	private:
+		unsigned int GetSegments(ByteSegment* segmentArray, unsigned int offset, unsigned int size);
+
 		char* ringBuffer;
 		unsigned int ringBufferSize;
-		unsigned int readOffset;
-		unsigned int writeOffset;
+		unsigned int ringBufferMask;
+		unsigned int readPosition;
+		unsigned int writePosition;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "UltraUtilities/Memory/ConcurrentRingBufferStream.h"
+
+using namespace UU;
+
+//---------------------------------- SPSCRingBufferStream ----------------------------------
+
+SPSCRingBufferStream::SPSCRingBufferStream(unsigned int size)
+{
+	this->ringBufferSize = RoundUpToPowerOfTwo(size);
+	this->ringBufferMask = this->ringBufferSize - 1;
+	this->ringBuffer = new char[this->ringBufferSize];
+	this->cachedReadPosition = 0;
+	this->cachedWritePosition = 0;
+}
+
+/*virtual*/ SPSCRingBufferStream::~SPSCRingBufferStream()
+{
+	delete[] this->ringBuffer;
+}
+
+/*virtual*/ unsigned int SPSCRingBufferStream::WriteBytes(const char* buffer, unsigned int bufferSize)
+{
+	unsigned int writePosition = this->writePosition.Load(MemoryOrder::RELAXED);
+	unsigned int freeSize = this->GetFreeSize(writePosition, bufferSize);
+	unsigned int numBytesWritten = UU_MIN(bufferSize, freeSize);
+	if (numBytesWritten == 0)
+		return 0;
+
+	unsigned int offset = writePosition & this->ringBufferMask;
+	unsigned int firstSize = UU_MIN(numBytesWritten, this->ringBufferSize - offset);
+	UU_MEMCPY(&this->ringBuffer[offset], buffer, firstSize);
+	UU_MEMCPY(this->ringBuffer, &buffer[firstSize], numBytesWritten - firstSize);
+
+	this->writePosition.Store(writePosition + numBytesWritten, MemoryOrder::RELEASE);
+	return numBytesWritten;
+}
+
+/*virtual*/ unsigned int SPSCRingBufferStream::ReadBytes(char* buffer, unsigned int bufferSize)
+{
+	unsigned int readPosition = this->readPosition.Load(MemoryOrder::RELAXED);
+	unsigned int usedSize = this->GetUsedSize(readPosition, bufferSize);
+	unsigned int numBytesRead = UU_MIN(bufferSize, usedSize);
+	if (numBytesRead == 0)
+		return 0;
+
+	unsigned int offset = readPosition & this->ringBufferMask;
+	unsigned int firstSize = UU_MIN(numBytesRead, this->ringBufferSize - offset);
+	UU_MEMCPY(buffer, &this->ringBuffer[offset], firstSize);
+	UU_MEMCPY(&buffer[firstSize], this->ringBuffer, numBytesRead - firstSize);
+
+	this->readPosition.Store(readPosition + numBytesRead, MemoryOrder::RELEASE);
+	return numBytesRead;
+}
+
+/*virtual*/ unsigned int SPSCRingBufferStream::GetSize()
+{
+	// The read position is loaded first.  The write position can only have moved further ahead of it since.
+	unsigned int readPosition = this->readPosition.Load(MemoryOrder::ACQUIRE);
+	unsigned int writePosition = this->writePosition.Load(MemoryOrder::ACQUIRE);
+	return writePosition - readPosition;
+}
+
+/*virtual*/ const char* SPSCRingBufferStream::Peek(unsigned int& size)
+{
+	unsigned int readPosition = this->readPosition.Load(MemoryOrder::RELAXED);
+	unsigned int offset = readPosition & this->ringBufferMask;
+	unsigned int usedSize = this->GetUsedSize(readPosition, this->ringBufferSize - offset);
+	size = UU_MIN(usedSize, this->ringBufferSize - offset);
+	return (size > 0) ? &this->ringBuffer[offset] : nullptr;
+}
+
+/*virtual*/ bool SPSCRingBufferStream::Consume(unsigned int size)
+{
+	unsigned int readPosition = this->readPosition.Load(MemoryOrder::RELAXED);
+	if (size > this->GetUsedSize(readPosition, size))
+		return false;
+
+	this->readPosition.Store(readPosition + size, MemoryOrder::RELEASE);
+	return true;
+}
+
+/*virtual*/ char* SPSCRingBufferStream::Reserve(unsigned int& size)
+{
+	unsigned int writePosition = this->writePosition.Load(MemoryOrder::RELAXED);
+	unsigned int offset = writePosition & this->ringBufferMask;
+	unsigned int freeSize = this->GetFreeSize(writePosition, this->ringBufferSize - offset);
+	size = UU_MIN(freeSize, this->ringBufferSize - offset);
+	return (size > 0) ? &this->ringBuffer[offset] : nullptr;
+}
+
+/*virtual*/ bool SPSCRingBufferStream::Commit(unsigned int size)
+{
+	unsigned int writePosition = this->writePosition.Load(MemoryOrder::RELAXED);
+	if (size > this->GetFreeSize(writePosition, size))
+		return false;
+
+	this->writePosition.Store(writePosition + size, MemoryOrder::RELEASE);
+	return true;
+}
+
+unsigned int SPSCRingBufferStream::GetCapacity() const
+{
+	return this->ringBufferSize;
+}
+
+unsigned int SPSCRingBufferStream::GetFreeSize(unsigned int writePosition, unsigned int wantedSize)
+{
+	// Only go and look at where the reader is if what we last saw of it isn't enough.
+	unsigned int freeSize = this->ringBufferSize - (writePosition - this->cachedReadPosition);
+	if (freeSize < wantedSize)
+	{
+		this->cachedReadPosition = this->readPosition.Load(MemoryOrder::ACQUIRE);
+		freeSize = this->ringBufferSize - (writePosition - this->cachedReadPosition);
+	}
+
+	return freeSize;
+}
+
+unsigned int SPSCRingBufferStream::GetUsedSize(unsigned int readPosition, unsigned int wantedSize)
+{
+	unsigned int usedSize = this->cachedWritePosition - readPosition;
+	if (usedSize < wantedSize)
+	{
+		this->cachedWritePosition = this->writePosition.Load(MemoryOrder::ACQUIRE);
+		usedSize = this->cachedWritePosition - readPosition;
+	}
+
+	return usedSize;
+}
+
+//---------------------------------- MPMCRingBufferStream ----------------------------------
+
+MPMCRingBufferStream::MPMCRingBufferStream(unsigned int numMessages, unsigned int maxMessageSize /*= UU_MPMC_RING_BUFFER_STREAM_MESSAGE_SIZE*/)
+	: freeBlockQueue(numMessages), messageQueue(numMessages)
+{
+	// Every block is always in one queue or the other, or held by a thread on its way from one to the other, so neither queue can overflow.
+	unsigned int numBlocks = this->freeBlockQueue.GetCapacity();
+	this->maxMessageSize = UU_MAX(maxMessageSize, 1);
+	this->blockBuffer = new char[(unsigned long long)numBlocks * this->maxMessageSize];
+	for (unsigned int i = 0; i < numBlocks; i++)
+		this->freeBlockQueue.TryPush(i);
+}
+
+/*virtual*/ MPMCRingBufferStream::~MPMCRingBufferStream()
+{
+	delete[] this->blockBuffer;
+}
+
+/*virtual*/ unsigned int MPMCRingBufferStream::WriteBytes(const char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesWritten = 0;
+
+	while (numBytesWritten < bufferSize)
+	{
+		Message message;
+		if (!this->freeBlockQueue.TryPop(message.blockNumber))
+			break;
+
+		message.size = UU_MIN(bufferSize - numBytesWritten, this->maxMessageSize);
+		UU_MEMCPY(&this->blockBuffer[(unsigned long long)message.blockNumber * this->maxMessageSize], &buffer[numBytesWritten], message.size);
+		this->size.FetchAdd(message.size, MemoryOrder::RELAXED);
+		this->messageQueue.TryPush(message);
+		numBytesWritten += message.size;
+	}
+
+	return numBytesWritten;
+}
+
+/*virtual*/ unsigned int MPMCRingBufferStream::ReadBytes(char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesRead = 0;
+
+	// A message can't be put back once it's taken, so only take one when there's room for the biggest there could be.
+	while (bufferSize - numBytesRead >= this->maxMessageSize)
+	{
+		Message message;
+		if (!this->messageQueue.TryPop(message))
+			break;
+
+		UU_MEMCPY(&buffer[numBytesRead], &this->blockBuffer[(unsigned long long)message.blockNumber * this->maxMessageSize], message.size);
+		this->size.FetchSub(message.size, MemoryOrder::RELAXED);
+		this->freeBlockQueue.TryPush(message.blockNumber);
+		numBytesRead += message.size;
+	}
+
+	return numBytesRead;
+}
+
+/*virtual*/ unsigned int MPMCRingBufferStream::GetSize()
+{
+	return this->size.Load(MemoryOrder::RELAXED);
+}
+
+unsigned int MPMCRingBufferStream::GetMaxMessageSize() const
+{
+	return this->maxMessageSize;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "UltraUtilities/Memory/ByteStream.h"
+#include "UltraUtilities/Containers/MPMCQueue.hpp"
+
+#define UU_MPMC_RING_BUFFER_STREAM_MESSAGE_SIZE			256
+
+namespace UU
+{
+	/**
+	 * This is a ring buffer through which exactly one thread can send bytes to exactly
+	 * one other thread, without any locking.  Only the sending thread may call
+	 * @ref WriteBytes, @ref Reserve and @ref Commit, and only the receiving thread may call
+	 * @ref ReadBytes, @ref Peek and @ref Consume.  Neither ever waits on the other; they
+	 * just write or read less than was asked for.
+	 *
+	 * As with @ref RingBufferStream, the size is rounded up to a power of two, and bytes go
+	 * in and out with at most two copies.  The write and read positions are kept on cache
+	 * lines of their own, each with a copy of the other side's position that is only
+	 * brought up to date when it looks like there isn't enough room or data.
+	 */
+	class UU_API SPSCRingBufferStream : public ByteStream
+	{
+	public:
+		SPSCRingBufferStream(unsigned int size);
+		virtual ~SPSCRingBufferStream();
+
+		SPSCRingBufferStream(const SPSCRingBufferStream&) = delete;
+		void operator=(const SPSCRingBufferStream&) = delete;
+
+		virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
+
+		/**
+		 * Return the number of bytes in the stream.  Unless called from one of its two
+		 * threads while the other is idle, this may be out of date by the time it's returned.
+		 */
+		virtual unsigned int GetSize() override;
+
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
+
+		/**
+		 * Return the most bytes this stream can hold at once.
+		 */
+		unsigned int GetCapacity() const;
+
+	private:
+		unsigned int GetFreeSize(unsigned int writePosition, unsigned int wantedSize);
+		unsigned int GetUsedSize(unsigned int readPosition, unsigned int wantedSize);
+
+		char* ringBuffer;
+		unsigned int ringBufferSize;
+		unsigned int ringBufferMask;
+
+		// These belong to the sender.
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> writePosition;
+		unsigned int cachedReadPosition;
+
+		// These belong to the receiver.
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> readPosition;
+		unsigned int cachedWritePosition;
+	};
+
+	/**
+	 * This is a stream of messages that any number of threads can write to and read from at
+	 * once, without any locking.  Each write of up to @ref GetMaxMessageSize bytes is one
+	 * message, which is read back whole and is never mixed up with bytes from other writes.
+	 * Longer writes are broken up into several messages, which other threads' messages may
+	 * come between.  A read takes whole messages for as long as there's room for any
+	 * message, so it must be given room for at least one.
+	 *
+	 * Messages are kept in fixed-size blocks.  Free blocks and full ones are passed around
+	 * through two @ref MPMCQueue, so a write takes a free block and gives it back full, and
+	 * a read takes a full block and gives it back free.
+	 */
+	class UU_API MPMCRingBufferStream : public ByteStream
+	{
+	public:
+		/**
+		 * @param[in] numMessages This is the most messages the stream can hold at once.  It is rounded up to a power of two.
+		 * @param[in] maxMessageSize This is the most bytes a single message can have.
+		 */
+		MPMCRingBufferStream(unsigned int numMessages, unsigned int maxMessageSize = UU_MPMC_RING_BUFFER_STREAM_MESSAGE_SIZE);
+		virtual ~MPMCRingBufferStream();
+
+		MPMCRingBufferStream(const MPMCRingBufferStream&) = delete;
+		void operator=(const MPMCRingBufferStream&) = delete;
+
+		virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
+
+		/**
+		 * Return the number of bytes in the stream.  With other threads at work,
+		 * this may be out of date by the time it's returned.
+		 */
+		virtual unsigned int GetSize() override;
+
+		/**
+		 * Return the most bytes that a single write is kept together as one message.
+		 */
+		unsigned int GetMaxMessageSize() const;
+
+	private:
+		struct Message
+		{
+			unsigned int blockNumber;
+			unsigned int size;
+		};
+
+		char* blockBuffer;
+		unsigned int maxMessageSize;
+		MPMCQueue<unsigned int> freeBlockQueue;
+		MPMCQueue<Message> messageQueue;
+		alignas(UU_CACHE_LINE_SIZE) Atomic<unsigned int> size;
+	};
+}
\ No newline at end of file
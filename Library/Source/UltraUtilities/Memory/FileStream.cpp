@@ -0,0 +1,463 @@
+#include "UltraUtilities/Memory/FileStream.h"
+#include "UltraUtilities/Threading/Thread.h"
+
+#if !defined _WIN32
+#	include <errno.h>
+#	include <fcntl.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using namespace UU;
+
+namespace UU
+{
+	/**
+	 * This reads the next buffer's worth of a file while the stream is busy with the current one.
+	 */
+	class FileStream::ReadAheadThread : public Thread
+	{
+	public:
+		ReadAheadThread(FileStream* fileStream)
+		{
+			this->fileStream = fileStream;
+			this->buffer = nullptr;
+			this->fileOffset = 0;
+			this->numBytesRead = 0;
+			this->succeeded = false;
+		}
+
+		virtual ~ReadAheadThread()
+		{
+			if (this->IsRunning())
+				this->Join();
+		}
+
+		bool Start(char* buffer, unsigned long long fileOffset)
+		{
+			this->buffer = buffer;
+			this->fileOffset = fileOffset;
+			this->numBytesRead = 0;
+			this->succeeded = false;
+			return Thread::Start();
+		}
+
+		unsigned int numBytesRead;
+		bool succeeded;
+
+	protected:
+		virtual void Run() override
+		{
+			this->succeeded = this->fileStream->ReadFromFile(this->buffer, this->fileOffset, this->numBytesRead);
+		}
+
+	private:
+		FileStream* fileStream;
+		char* buffer;
+		unsigned long long fileOffset;
+	};
+}
+
+FileStream::FileStream(unsigned int bufferSize /*= UU_FILE_STREAM_BUFFER_SIZE*/)
+{
+	this->bufferSize = UU_MAX((bufferSize + UU_FILE_STREAM_ALIGNMENT - 1) & ~(UU_FILE_STREAM_ALIGNMENT - 1), UU_FILE_STREAM_ALIGNMENT);
+	this->mode = Mode::READ;
+	this->directIO = false;
+	this->bufferIndex = 0;
+	this->bufferOffset = 0;
+	this->bufferFill = 0;
+	this->fileSize = 0;
+	this->fileOffset = 0;
+	this->readAheadThread = nullptr;
+#if defined _WIN32
+	this->fileHandle = INVALID_HANDLE_VALUE;
+#else
+	this->fileDescriptor = -1;
+#endif
+
+	for (int i = 0; i < 2; i++)
+	{
+		this->bufferMemory[i] = nullptr;
+		this->bufferArray[i] = nullptr;
+	}
+}
+
+/*virtual*/ FileStream::~FileStream()
+{
+	this->Close();
+}
+
+bool FileStream::Open(const char* filePath, Mode mode, bool directIO /*= false*/, bool readAhead /*= false*/)
+{
+	if (this->IsOpen())
+		return false;
+
+	this->mode = mode;
+	this->directIO = directIO;
+
+#if defined _WIN32
+	DWORD desiredAccess = (mode == Mode::READ) ? GENERIC_READ : GENERIC_WRITE;
+	DWORD creationDisposition = (mode == Mode::READ) ? OPEN_EXISTING : CREATE_ALWAYS;
+	DWORD flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+	this->fileHandle = CreateFileA(filePath, desiredAccess, FILE_SHARE_READ, NULL, creationDisposition, flags | (directIO ? FILE_FLAG_NO_BUFFERING : 0), NULL);
+	if (this->fileHandle == INVALID_HANDLE_VALUE && directIO)
+	{
+		this->directIO = false;
+		this->fileHandle = CreateFileA(filePath, desiredAccess, FILE_SHARE_READ, NULL, creationDisposition, flags, NULL);
+	}
+
+	if (this->fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(this->fileHandle, &fileSize))
+	{
+		this->Close();
+		return false;
+	}
+
+	this->fileSize = fileSize.QuadPart;
+#else
+	int flags = (mode == Mode::READ) ? O_RDONLY : (O_WRONLY | O_CREAT | O_TRUNC);
+#	if defined O_DIRECT
+	this->fileDescriptor = directIO ? ::open(filePath, flags | O_DIRECT, 0644) : -1;
+	if (this->fileDescriptor < 0)
+	{
+		// Some file systems don't do direct I/O at all.
+		this->directIO = false;
+		this->fileDescriptor = ::open(filePath, flags, 0644);
+	}
+#	else
+	this->fileDescriptor = ::open(filePath, flags, 0644);
+#		if defined F_NOCACHE
+	if (this->fileDescriptor >= 0 && directIO)
+		this->directIO = (::fcntl(this->fileDescriptor, F_NOCACHE, 1) == 0);
+#		else
+	this->directIO = false;
+#		endif
+#	endif
+
+	if (this->fileDescriptor < 0)
+		return false;
+
+	struct stat fileStatus;
+	if (::fstat(this->fileDescriptor, &fileStatus) != 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->fileSize = fileStatus.st_size;
+#endif
+
+	// Direct I/O needs the memory it goes to and from to be aligned, not just the file offsets.
+	int numBuffers = (mode == Mode::READ && readAhead) ? 2 : 1;
+	for (int i = 0; i < numBuffers; i++)
+	{
+		this->bufferMemory[i] = new char[this->bufferSize + UU_FILE_STREAM_ALIGNMENT];
+		this->bufferArray[i] = (char*)(((unsigned long long)this->bufferMemory[i] + UU_FILE_STREAM_ALIGNMENT - 1) & ~(unsigned long long)(UU_FILE_STREAM_ALIGNMENT - 1));
+	}
+
+	this->bufferIndex = 0;
+	this->bufferOffset = 0;
+	this->bufferFill = 0;
+	this->fileOffset = 0;
+
+	if (numBuffers == 2)
+	{
+		// Get the first buffer's worth coming right away.
+		this->readAheadThread = new ReadAheadThread(this);
+		if (this->fileSize > 0 && !this->readAheadThread->Start(this->bufferArray[1], 0))
+		{
+			this->Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool FileStream::Close()
+{
+	bool success = true;
+
+	if (this->readAheadThread)
+	{
+		delete this->readAheadThread;
+		this->readAheadThread = nullptr;
+	}
+
+	if (this->IsOpen() && this->mode == Mode::WRITE)
+		success = this->FlushBuffer();
+
+#if defined _WIN32
+	if (this->fileHandle != INVALID_HANDLE_VALUE)
+	{
+		// Direct writes are padded out to the alignment, so the file may have to be cut back to size.
+		if (this->mode == Mode::WRITE && this->directIO)
+		{
+			LARGE_INTEGER fileSize;
+			fileSize.QuadPart = this->fileSize;
+			success = SetFilePointerEx(this->fileHandle, fileSize, NULL, FILE_BEGIN) && SetEndOfFile(this->fileHandle) && success;
+		}
+
+		CloseHandle(this->fileHandle);
+	}
+
+	this->fileHandle = INVALID_HANDLE_VALUE;
+#else
+	if (this->fileDescriptor >= 0)
+	{
+		if (this->mode == Mode::WRITE && this->directIO)
+			success = (::ftruncate(this->fileDescriptor, this->fileSize) == 0) && success;
+
+		::close(this->fileDescriptor);
+	}
+
+	this->fileDescriptor = -1;
+#endif
+
+	for (int i = 0; i < 2; i++)
+	{
+		delete[] this->bufferMemory[i];
+		this->bufferMemory[i] = nullptr;
+		this->bufferArray[i] = nullptr;
+	}
+
+	this->bufferIndex = 0;
+	this->bufferOffset = 0;
+	this->bufferFill = 0;
+	this->fileSize = 0;
+	this->fileOffset = 0;
+	return success;
+}
+
+bool FileStream::IsOpen() const
+{
+#if defined _WIN32
+	return this->fileHandle != INVALID_HANDLE_VALUE;
+#else
+	return this->fileDescriptor >= 0;
+#endif
+}
+
+/*virtual*/ unsigned int FileStream::WriteBytes(const char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesWritten = 0;
+
+	while (numBytesWritten < bufferSize)
+	{
+		unsigned int size = 0;
+		char* reservedBuffer = this->Reserve(size);
+		if (!reservedBuffer)
+			break;
+
+		unsigned int numBytes = UU_MIN(size, bufferSize - numBytesWritten);
+		UU_MEMCPY(reservedBuffer, &buffer[numBytesWritten], numBytes);
+		this->bufferFill += numBytes;
+		numBytesWritten += numBytes;
+	}
+
+	return numBytesWritten;
+}
+
+/*virtual*/ unsigned int FileStream::ReadBytes(char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesRead = 0;
+
+	while (numBytesRead < bufferSize)
+	{
+		unsigned int size = 0;
+		const char* peekedBuffer = this->Peek(size);
+		if (!peekedBuffer)
+			break;
+
+		unsigned int numBytes = UU_MIN(size, bufferSize - numBytesRead);
+		UU_MEMCPY(&buffer[numBytesRead], peekedBuffer, numBytes);
+		this->bufferOffset += numBytes;
+		numBytesRead += numBytes;
+	}
+
+	return numBytesRead;
+}
+
+/*virtual*/ unsigned int FileStream::GetSize()
+{
+	if (!this->IsOpen() || this->mode != Mode::READ)
+		return 0;
+
+	unsigned long long size = (this->fileSize - this->fileOffset) + (this->bufferFill - this->bufferOffset);
+	return (unsigned int)UU_MIN(size, 0xFFFFFFFF);
+}
+
+/*virtual*/ const char* FileStream::Peek(unsigned int& size)
+{
+	size = 0;
+
+	if (!this->IsOpen() || this->mode != Mode::READ)
+		return nullptr;
+
+	if (this->bufferOffset == this->bufferFill && !this->FillBuffer())
+		return nullptr;
+
+	size = this->bufferFill - this->bufferOffset;
+	return &this->bufferArray[this->bufferIndex][this->bufferOffset];
+}
+
+/*virtual*/ bool FileStream::Consume(unsigned int size)
+{
+	while (size > 0)
+	{
+		unsigned int peekedSize = 0;
+		if (!this->Peek(peekedSize))
+			return false;
+
+		unsigned int numBytes = UU_MIN(size, peekedSize);
+		this->bufferOffset += numBytes;
+		size -= numBytes;
+	}
+
+	return true;
+}
+
+/*virtual*/ char* FileStream::Reserve(unsigned int& size)
+{
+	size = 0;
+
+	if (!this->IsOpen() || this->mode != Mode::WRITE)
+		return nullptr;
+
+	if (this->bufferFill == this->bufferSize && !this->FlushBuffer())
+		return nullptr;
+
+	size = this->bufferSize - this->bufferFill;
+	return &this->bufferArray[0][this->bufferFill];
+}
+
+/*virtual*/ bool FileStream::Commit(unsigned int size)
+{
+	if (!this->IsOpen() || this->mode != Mode::WRITE || size > this->bufferSize - this->bufferFill)
+		return false;
+
+	this->bufferFill += size;
+	return true;
+}
+
+bool FileStream::FillBuffer()
+{
+	this->bufferOffset = 0;
+	this->bufferFill = 0;
+
+	if (this->fileOffset >= this->fileSize)
+		return false;
+
+	if (!this->readAheadThread)
+	{
+		if (!this->ReadFromFile(this->bufferArray[0], this->fileOffset, this->bufferFill))
+			return false;
+	}
+	else
+	{
+		// Take the buffer that was read ahead, and start on the one after it in the buffer we're done with.
+		this->readAheadThread->Join();
+		if (!this->readAheadThread->succeeded)
+			return false;
+
+		this->bufferIndex = 1 - this->bufferIndex;
+		this->bufferFill = this->readAheadThread->numBytesRead;
+
+		unsigned long long nextFileOffset = this->fileOffset + this->bufferFill;
+		if (nextFileOffset < this->fileSize && !this->readAheadThread->Start(this->bufferArray[1 - this->bufferIndex], nextFileOffset))
+			return false;
+	}
+
+	this->fileOffset += this->bufferFill;
+	return this->bufferFill > 0;
+}
+
+bool FileStream::FlushBuffer()
+{
+	if (this->bufferFill == 0)
+		return true;
+
+	// Only the last write can be short of a whole buffer.  Direct I/O still needs it padded out to the alignment.
+	unsigned int size = this->bufferFill;
+	if (this->directIO)
+	{
+		size = (size + UU_FILE_STREAM_ALIGNMENT - 1) & ~(UU_FILE_STREAM_ALIGNMENT - 1);
+		UU_MEMSET(&this->bufferArray[0][this->bufferFill], 0, size - this->bufferFill);
+	}
+
+	if (!this->WriteToFile(this->bufferArray[0], this->fileOffset, size))
+		return false;
+
+	this->fileOffset += this->bufferFill;
+	this->fileSize = this->fileOffset;
+	this->bufferFill = 0;
+	return true;
+}
+
+bool FileStream::ReadFromFile(char* buffer, unsigned long long fileOffset, unsigned int& numBytesRead)
+{
+	// Always ask for a whole buffer, so that direct reads stay aligned, but stop once the end of the file is reached.
+	unsigned long long expectedSize = UU_MIN(this->fileSize - fileOffset, (unsigned long long)this->bufferSize);
+	numBytesRead = 0;
+
+	while (numBytesRead < expectedSize)
+	{
+		unsigned long long offset = fileOffset + numBytesRead;
+#if defined _WIN32
+		OVERLAPPED overlapped{};
+		overlapped.Offset = (DWORD)offset;
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD result = 0;
+		if (!ReadFile(this->fileHandle, &buffer[numBytesRead], this->bufferSize - numBytesRead, &result, &overlapped))
+			return GetLastError() == ERROR_HANDLE_EOF;
+#else
+		ssize_t result = ::pread(this->fileDescriptor, &buffer[numBytesRead], this->bufferSize - numBytesRead, (off_t)offset);
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result < 0)
+			return false;
+#endif
+		if (result == 0)
+			break;
+
+		numBytesRead += (unsigned int)result;
+	}
+
+	numBytesRead = (unsigned int)UU_MIN((unsigned long long)numBytesRead, expectedSize);
+	return true;
+}
+
+bool FileStream::WriteToFile(const char* buffer, unsigned long long fileOffset, unsigned int size)
+{
+	unsigned int numBytesWritten = 0;
+
+	while (numBytesWritten < size)
+	{
+		unsigned long long offset = fileOffset + numBytesWritten;
+#if defined _WIN32
+		OVERLAPPED overlapped{};
+		overlapped.Offset = (DWORD)offset;
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+		DWORD result = 0;
+		if (!WriteFile(this->fileHandle, &buffer[numBytesWritten], size - numBytesWritten, &result, &overlapped))
+			return false;
+#else
+		ssize_t result = ::pwrite(this->fileDescriptor, &buffer[numBytesWritten], size - numBytesWritten, (off_t)offset);
+		if (result < 0 && errno == EINTR)
+			continue;
+
+		if (result < 0)
+			return false;
+#endif
+		if (result == 0)
+			return false;
+
+		numBytesWritten += (unsigned int)result;
+	}
+
+	return true;
+}
\ No newline at end of file
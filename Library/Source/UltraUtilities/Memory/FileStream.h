@@ -0,0 +1,103 @@
+#pragma once
+
+#include "UltraUtilities/Memory/ByteStream.h"
+
+#define UU_FILE_STREAM_BUFFER_SIZE			(1024 * 1024)
+#define UU_FILE_STREAM_ALIGNMENT			4096
+
+namespace UU
+{
+	/**
+	 * This stream reads or writes a file through a buffer of its own, so that
+	 * however small the reads and writes made of it are, the file only ever sees
+	 * large ones, each a whole buffer at a time, starting on a buffer boundary.
+	 * The buffer is aligned, and sized as a multiple of @ref UU_FILE_STREAM_ALIGNMENT,
+	 * so that the file can be opened for direct I/O, bypassing the operating
+	 * system's cache.  @ref Peek and @ref Reserve hand out the buffer itself,
+	 * so a @ref BitStream over one of these doesn't have to copy anything.
+	 *
+	 * When reading, a thread can be used to read the next buffer's worth of the file
+	 * while the current one is being used.
+	 */
+	class UU_API FileStream : public ByteStream
+	{
+	public:
+		enum class Mode
+		{
+			READ,			///< Read an existing file from start to finish.
+			WRITE			///< Write a new file, emptying it if it already exists.
+		};
+
+		/**
+		 * @param[in] bufferSize This is how much of the file is read or written at once.  It is rounded up to a multiple of @ref UU_FILE_STREAM_ALIGNMENT.
+		 */
+		FileStream(unsigned int bufferSize = UU_FILE_STREAM_BUFFER_SIZE);
+		virtual ~FileStream();
+
+		FileStream(const FileStream&) = delete;
+		void operator=(const FileStream&) = delete;
+
+		/**
+		 * Open the given file.
+		 *
+		 * @param[in] filePath This is the path of the file to open.
+		 * @param[in] mode This says whether the file is to be read or written.
+		 * @param[in] directIO If true, the operating system's cache is bypassed where that's allowed.  The file is opened normally where it isn't.
+		 * @param[in] readAhead If true, and the file is being read, the next buffer's worth of it is read on a thread of its own.
+		 * @return True is returned on success; false otherwise, in which case this stream is left closed.
+		 */
+		bool Open(const char* filePath, Mode mode, bool directIO = false, bool readAhead = false);
+
+		/**
+		 * Write out whatever is still buffered, then close the file.
+		 * This is done for you when this stream is destroyed.
+		 *
+		 * @return False is returned if anything couldn't be written.
+		 */
+		bool Close();
+
+		/**
+		 * Tell the caller if a file is open.
+		 */
+		bool IsOpen() const;
+
+		virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
+
+		/**
+		 * When reading, this is the number of bytes left to be read from the file, or 0xFFFFFFFF if there are more than that.
+		 * Nothing can be read back when writing, so this is then zero.
+		 */
+		virtual unsigned int GetSize() override;
+
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
+
+	private:
+		class ReadAheadThread;
+
+		bool FillBuffer();
+		bool FlushBuffer();
+		bool ReadFromFile(char* buffer, unsigned long long fileOffset, unsigned int& numBytesRead);
+		bool WriteToFile(const char* buffer, unsigned long long fileOffset, unsigned int size);
+
+		Mode mode;
+		bool directIO;
+		unsigned int bufferSize;
+		char* bufferMemory[2];
+		char* bufferArray[2];
+		unsigned int bufferIndex;
+		unsigned int bufferOffset;
+		unsigned int bufferFill;
+		unsigned long long fileSize;
+		unsigned long long fileOffset;
+		ReadAheadThread* readAheadThread;
+#if defined _WIN32
+		HANDLE fileHandle;
+#else
+		int fileDescriptor;
+#endif
+	};
+}
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "UltraUtilities/Memory/MappedFileStream.h"
+
+#if !defined _WIN32
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+using namespace UU;
+
+MappedFileStream::MappedFileStream()
+{
+	this->mode = Mode::READ_ONLY;
+	this->mapping = nullptr;
+	this->mappingSize = 0;
+	this->readOffset = 0;
+	this->writeOffset = 0;
+#if defined _WIN32
+	this->fileHandle = INVALID_HANDLE_VALUE;
+	this->mappingHandle = NULL;
+#else
+	this->fileDescriptor = -1;
+#endif
+}
+
+/*virtual*/ MappedFileStream::~MappedFileStream()
+{
+	this->Close();
+}
+
+bool MappedFileStream::Open(const char* filePath, Mode mode, unsigned int maxSize /*= 0*/)
+{
+	if (this->IsOpen())
+		return false;
+
+	// Until the file's size checks out, closing must not cut the file back to our (empty) write offset.
+	this->mode = Mode::READ_ONLY;
+	bool readOnly = (mode == Mode::READ_ONLY);
+	unsigned long long fileSize = 0;
+
+#if defined _WIN32
+	DWORD desiredAccess = readOnly ? GENERIC_READ : (GENERIC_READ | GENERIC_WRITE);
+	DWORD creationDisposition = readOnly ? OPEN_EXISTING : ((mode == Mode::CREATE) ? CREATE_ALWAYS : OPEN_ALWAYS);
+	this->fileHandle = CreateFileA(filePath, desiredAccess, FILE_SHARE_READ, NULL, creationDisposition, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (this->fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSizeInteger;
+	if (!GetFileSizeEx(this->fileHandle, &fileSizeInteger))
+	{
+		this->Close();
+		return false;
+	}
+
+	fileSize = fileSizeInteger.QuadPart;
+#else
+	int flags = readOnly ? O_RDONLY : (O_RDWR | O_CREAT | ((mode == Mode::CREATE) ? O_TRUNC : 0));
+	this->fileDescriptor = ::open(filePath, flags, 0644);
+	if (this->fileDescriptor < 0)
+		return false;
+
+	struct stat fileStatus;
+	if (::fstat(this->fileDescriptor, &fileStatus) != 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	fileSize = fileStatus.st_size;
+#endif
+
+	if (fileSize > 0xFFFFFFFF)
+	{
+		this->Close();
+		return false;
+	}
+
+	// If we fail from here on, closing puts the file back to the size it was.
+	this->mode = mode;
+	this->readOffset = 0;
+	this->writeOffset = (unsigned int)fileSize;
+
+	unsigned int mappingSize = readOnly ? this->writeOffset : UU_MAX(this->writeOffset, maxSize);
+	if (mappingSize == 0)
+		return true;		// There's nothing to map.  Empty files can't be mapped anyway.
+
+#if defined _WIN32
+	// Mapping more than is in the file grows the file to fit.
+	this->mappingHandle = CreateFileMappingA(this->fileHandle, NULL, readOnly ? PAGE_READONLY : PAGE_READWRITE, 0, mappingSize, NULL);
+	if (this->mappingHandle == NULL)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->mapping = (char*)MapViewOfFile(this->mappingHandle, readOnly ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, mappingSize);
+	if (!this->mapping)
+	{
+		this->Close();
+		return false;
+	}
+#else
+	if (mappingSize > this->writeOffset && ::ftruncate(this->fileDescriptor, mappingSize) != 0)
+	{
+		this->Close();
+		return false;
+	}
+
+	void* mapping = ::mmap(nullptr, mappingSize, readOnly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, this->fileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		this->Close();
+		return false;
+	}
+
+	this->mapping = (char*)mapping;
+	::madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+#endif
+
+	this->mappingSize = mappingSize;
+	return true;
+}
+
+bool MappedFileStream::Close()
+{
+	bool success = true;
+
+#if defined _WIN32
+	if (this->mapping)
+		UnmapViewOfFile(this->mapping);
+
+	if (this->mappingHandle != NULL)
+		CloseHandle(this->mappingHandle);
+
+	if (this->fileHandle != INVALID_HANDLE_VALUE)
+	{
+		if (this->mode != Mode::READ_ONLY)
+		{
+			LARGE_INTEGER fileSize;
+			fileSize.QuadPart = this->writeOffset;
+			success = SetFilePointerEx(this->fileHandle, fileSize, NULL, FILE_BEGIN) && SetEndOfFile(this->fileHandle);
+		}
+
+		CloseHandle(this->fileHandle);
+	}
+
+	this->fileHandle = INVALID_HANDLE_VALUE;
+	this->mappingHandle = NULL;
+#else
+	if (this->mapping)
+		::munmap(this->mapping, this->mappingSize);
+
+	if (this->fileDescriptor >= 0)
+	{
+		if (this->mode != Mode::READ_ONLY)
+			success = (::ftruncate(this->fileDescriptor, this->writeOffset) == 0);
+
+		::close(this->fileDescriptor);
+	}
+
+	this->fileDescriptor = -1;
+#endif
+
+	this->mapping = nullptr;
+	this->mappingSize = 0;
+	this->readOffset = 0;
+	this->writeOffset = 0;
+	return success;
+}
+
+bool MappedFileStream::IsOpen() const
+{
+#if defined _WIN32
+	return this->fileHandle != INVALID_HANDLE_VALUE;
+#else
+	return this->fileDescriptor >= 0;
+#endif
+}
+
+/*virtual*/ unsigned int MappedFileStream::WriteBytes(const char* buffer, unsigned int bufferSize)
+{
+	unsigned int size = 0;
+	char* reservedBuffer = this->Reserve(size);
+	unsigned int numBytesWritten = UU_MIN(bufferSize, size);
+	if (numBytesWritten == 0)
+		return 0;
+
+	UU_MEMCPY(reservedBuffer, buffer, numBytesWritten);
+	this->writeOffset += numBytesWritten;
+	return numBytesWritten;
+}
+
+/*virtual*/ unsigned int MappedFileStream::ReadBytes(char* buffer, unsigned int bufferSize)
+{
+	unsigned int numBytesRead = UU_MIN(bufferSize, this->GetSize());
+	if (numBytesRead == 0)
+		return 0;
+
+	UU_MEMCPY(buffer, &this->mapping[this->readOffset], numBytesRead);
+	this->readOffset += numBytesRead;
+	return numBytesRead;
+}
+
+/*virtual*/ unsigned int MappedFileStream::GetSize()
+{
+	return this->writeOffset - this->readOffset;
+}
+
+/*virtual*/ const char* MappedFileStream::GetBuffer() const
+{
+	return this->mapping ? &this->mapping[this->readOffset] : nullptr;
+}
+
+/*virtual*/ const char* MappedFileStream::Peek(unsigned int& size)
+{
+	size = this->GetSize();
+	return (size > 0) ? &this->mapping[this->readOffset] : nullptr;
+}
+
+/*virtual*/ bool MappedFileStream::Consume(unsigned int size)
+{
+	if (size > this->GetSize())
+		return false;
+
+	this->readOffset += size;
+	return true;
+}
+
+/*virtual*/ char* MappedFileStream::Reserve(unsigned int& size)
+{
+	size = (this->mode == Mode::READ_ONLY) ? 0 : (this->mappingSize - this->writeOffset);
+	return (size > 0) ? &this->mapping[this->writeOffset] : nullptr;
+}
+
+/*virtual*/ bool MappedFileStream::Commit(unsigned int size)
+{
+	if (this->mode == Mode::READ_ONLY || size > this->mappingSize - this->writeOffset)
+		return false;
+
+	this->writeOffset += size;
+	return true;
+}
\ No newline at end of file
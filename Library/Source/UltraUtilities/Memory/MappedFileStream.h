@@ -0,0 +1,80 @@
+#pragma once
+
+#include "UltraUtilities/Memory/ByteStream.h"
+
+namespace UU
+{
+	/**
+	 * This stream reads and writes a file through a memory mapping of it, so that
+	 * the file's contents can be used where they are instead of being copied onto
+	 * the heap.  @ref GetBuffer, @ref Peek and @ref Reserve all hand out pointers
+	 * into the mapping, so a codec given one of these compresses straight out of
+	 * the file, or decompresses straight into it.
+	 *
+	 * Like @ref MemoryBufferStream, reading starts at the front of the file and
+	 * writing starts at the end of it.  Since the size of a stream is counted in
+	 * an unsigned int, files of 4 GB or more can't be opened.
+	 */
+	class UU_API MappedFileStream : public ByteStream
+	{
+	public:
+		enum class Mode
+		{
+			READ_ONLY,		///< Map an existing file that can only be read.
+			READ_WRITE,		///< Map a file to be added to, creating it if need be.  What's already in it can be read.
+			CREATE			///< Map a new file to be written, emptying it if it already exists.
+		};
+
+		MappedFileStream();
+		virtual ~MappedFileStream();
+
+		MappedFileStream(const MappedFileStream&) = delete;
+		void operator=(const MappedFileStream&) = delete;
+
+		/**
+		 * Open and map the given file.  The operating system is told that it will be gone through
+		 * sequentially, so that it can read ahead and let go of pages once they've been passed.
+		 *
+		 * @param[in] filePath This is the path of the file to map.
+		 * @param[in] mode This says how the file is to be opened.
+		 * @param[in] maxSize When writing, this is the most bytes the file can grow to.  The file is grown to this size while it's open, then cut back to what was written when it's closed.
+		 * @return True is returned on success; false otherwise, in which case this stream is left closed.
+		 */
+		bool Open(const char* filePath, Mode mode, unsigned int maxSize = 0);
+
+		/**
+		 * Unmap and close the file, cutting it down to the bytes that were written to it.
+		 * This is done for you when this stream is destroyed.
+		 *
+		 * @return False is returned if the file couldn't be cut down to size.
+		 */
+		bool Close();
+
+		/**
+		 * Tell the caller if a file is open.
+		 */
+		bool IsOpen() const;
+
+		virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override;
+		virtual unsigned int GetSize() override;
+		virtual const char* GetBuffer() const override;
+		virtual const char* Peek(unsigned int& size) override;
+		virtual bool Consume(unsigned int size) override;
+		virtual char* Reserve(unsigned int& size) override;
+		virtual bool Commit(unsigned int size) override;
+
+	private:
+		Mode mode;
+		char* mapping;
+		unsigned int mappingSize;
+		unsigned int readOffset;
+		unsigned int writeOffset;
+#if defined _WIN32
+		HANDLE fileHandle;
+		HANDLE mappingHandle;
+#else
+		int fileDescriptor;
+#endif
+	};
+}
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "UltraUtilities/Defines.h"
+#include "UltraUtilities/Threading/Mutex.h"
+#include <new>
 
 namespace UU
 {
@@ -91,4 +93,500 @@ namespace UU
 		unsigned int freeObjectStackSize;
 		unsigned int freeObjectStackTop;
 	};
+
+	/**
+	 * Slab heaps have O(1) time allocation and deallocation, like object pools,
+	 * but there is no limit to the number of allocations.  Objects are carved out
+	 * of large slabs of memory that are allocated as needed, and freed objects are
+	 * kept on an intrusive free list per slab, so there is no allocation from the
+	 * built-in free-store except once per slab.  Each slab is aligned to its own
+	 * size, so the slab of any object can be found by masking its address, and a
+	 * slab is given back once all of its objects are freed.  One empty slab is
+	 * kept in reserve so that a heap hovering around a slab boundary doesn't thrash.
+	 *
+	 * This is a good choice for the node and key heaps of containers like
+	 * @ref HashMap and @ref RBMap.  Note that a slab heap is not thread-safe.
+	 *
+	 * @tparam SlabSize This is the size of each slab in bytes, which must be a power of two.
+	 */
+	template<typename T, unsigned int SlabSize = 64 * 1024>
+	class UU_API SlabObjectHeap : public ObjectHeap<T>
+	{
+	public:
+		SlabObjectHeap()
+		{
+			static_assert((SlabSize & (SlabSize - 1)) == 0, "The slab size must be a power of two.");
+			static_assert(GetObjectsPerSlab() > 0, "The slab size is too small for the object type.");
+
+			this->availableSlabList = nullptr;
+			this->fullSlabList = nullptr;
+			this->spareSlab = nullptr;
+			this->numSlabs = 0;
+		}
+
+		SlabObjectHeap(const SlabObjectHeap&) = delete;
+		void operator=(const SlabObjectHeap&) = delete;
+
+		/**
+		 * Note that objects still allocated from this heap are not destructed here.
+		 * Their memory is simply given back.
+		 */
+		virtual ~SlabObjectHeap()
+		{
+			FreeSlabList(this->availableSlabList);
+			FreeSlabList(this->fullSlabList);
+			if (this->spareSlab)
+				FreeSlab(this->spareSlab);
+		}
+
+		virtual T* Allocate() override
+		{
+			Slab* slab = this->availableSlabList;
+			if (!slab)
+			{
+				if (this->spareSlab)
+				{
+					slab = this->spareSlab;
+					this->spareSlab = nullptr;
+				}
+				else
+				{
+					slab = this->NewSlab();
+					if (!slab)
+						return nullptr;
+				}
+
+				LinkSlab(this->availableSlabList, slab);
+			}
+
+			// Freed slots are reused first.  Otherwise we take the next slot never used.
+			Slot* slot = slab->freeSlotList;
+			if (slot)
+				slab->freeSlotList = slot->nextFreeSlot;
+			else
+				slot = &slab->GetSlots()[slab->numSlotsUsed++];
+
+			if (++slab->numObjects == GetObjectsPerSlab())
+			{
+				UnlinkSlab(this->availableSlabList, slab);
+				LinkSlab(this->fullSlabList, slab);
+			}
+
+			return new (slot) T();
+		}
+
+		virtual bool Deallocate(T* object) override
+		{
+			if (!object)
+				return false;
+
+			Slab* slab = FindSlab(object);
+			UU_ASSERT(slab->heap == this);
+			if (slab->heap != this)
+				return false;
+
+			object->~T();
+
+			auto slot = reinterpret_cast<Slot*>(object);
+			slot->nextFreeSlot = slab->freeSlotList;
+			slab->freeSlotList = slot;
+
+			if (slab->numObjects-- == GetObjectsPerSlab())
+			{
+				UnlinkSlab(this->fullSlabList, slab);
+				LinkSlab(this->availableSlabList, slab);
+			}
+
+			if (slab->numObjects == 0)
+			{
+				UnlinkSlab(this->availableSlabList, slab);
+				if (this->spareSlab)
+					FreeSlab(slab);
+				else
+				{
+					slab->freeSlotList = nullptr;
+					slab->numSlotsUsed = 0;
+					this->spareSlab = slab;
+				}
+			}
+
+			return true;
+		}
+
+		/**
+		 * Return the number of slabs currently allocated by this heap, including the spare, if any.
+		 */
+		unsigned int GetNumSlabs() const
+		{
+			return this->numSlabs;
+		}
+
+		/**
+		 * Return the number of objects that fit in a single slab.
+		 */
+		static constexpr unsigned int GetObjectsPerSlab()
+		{
+			return (SlabSize - FirstSlotOffset()) / sizeof(Slot);
+		}
+
+	private:
+		union Slot
+		{
+			Slot* nextFreeSlot;
+			alignas(T) unsigned char memory[sizeof(T)];
+		};
+
+		// This header lives at the start of each slab and is followed by the slots.
+		struct Slab
+		{
+			Slot* GetSlots()
+			{
+				return reinterpret_cast<Slot*>(reinterpret_cast<unsigned char*>(this) + FirstSlotOffset());
+			}
+
+			SlabObjectHeap* heap;
+			Slab* prevSlab;
+			Slab* nextSlab;
+			Slot* freeSlotList;
+			unsigned int numObjects;
+			unsigned int numSlotsUsed;
+		};
+
+		static constexpr unsigned int FirstSlotOffset()
+		{
+			return (unsigned int)((sizeof(Slab) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot));
+		}
+
+		static Slab* FindSlab(T* object)
+		{
+			auto address = reinterpret_cast<unsigned long long>(object);
+			return reinterpret_cast<Slab*>(address & ~(unsigned long long)(SlabSize - 1));
+		}
+
+		Slab* NewSlab()
+		{
+			void* memory = ::operator new(SlabSize, std::align_val_t(SlabSize), std::nothrow);
+			if (!memory)
+				return nullptr;
+
+			auto slab = static_cast<Slab*>(memory);
+			slab->heap = this;
+			slab->prevSlab = nullptr;
+			slab->nextSlab = nullptr;
+			slab->freeSlotList = nullptr;
+			slab->numObjects = 0;
+			slab->numSlotsUsed = 0;
+			this->numSlabs++;
+			return slab;
+		}
+
+		void FreeSlab(Slab* slab)
+		{
+			::operator delete(slab, std::align_val_t(SlabSize));
+			this->numSlabs--;
+		}
+
+		void FreeSlabList(Slab* slab)
+		{
+			while (slab)
+			{
+				Slab* nextSlab = slab->nextSlab;
+				FreeSlab(slab);
+				slab = nextSlab;
+			}
+		}
+
+		static void LinkSlab(Slab*& slabList, Slab* slab)
+		{
+			slab->prevSlab = nullptr;
+			slab->nextSlab = slabList;
+			if (slabList)
+				slabList->prevSlab = slab;
+			slabList = slab;
+		}
+
+		static void UnlinkSlab(Slab*& slabList, Slab* slab)
+		{
+			if (slab->prevSlab)
+				slab->prevSlab->nextSlab = slab->nextSlab;
+			else
+				slabList = slab->nextSlab;
+
+			if (slab->nextSlab)
+				slab->nextSlab->prevSlab = slab->prevSlab;
+
+			slab->prevSlab = nullptr;
+			slab->nextSlab = nullptr;
+		}
+
+		Slab* availableSlabList;
+		Slab* fullSlabList;
+		Slab* spareSlab;
+		unsigned int numSlabs;
+	};
+
+	/**
+	 * Thread-caching heaps can be allocated from and deallocated to by any number of
+	 * threads at once, and most of the time, no locking is involved at all.  Each
+	 * thread caches free objects in a pair of magazines, which are just arrays of
+	 * pointers.  Only when both of a thread's magazines are empty (when allocating)
+	 * or full (when deallocating) does the thread go to a shared depot, under a lock,
+	 * to trade a whole magazine at once.  The depot gets new objects in batches from
+	 * a @ref SlabObjectHeap, and gives objects back to it when it's holding more
+	 * full magazines than it needs.  Objects can be freed by a thread other than the
+	 * one that allocated them.
+	 *
+	 * The caches and the depot are shared by all instances of this class for a given
+	 * type, so an instance has no state of its own, and the class can be given as the
+	 * node or key heap of a container like @ref HashMap or @ref RBMap even when a
+	 * different container is being populated on each thread.  A thread's cache goes back
+	 * to the depot when the thread exits.  The depot itself lives for the life of the process,
+	 * and objects freed on a thread after its cache is gone (say, by a static container being
+	 * destroyed at exit) go straight to the depot, under its lock.
+	 *
+	 * See: "Magazines and Vmem" by Bonwick and Adams.
+	 *
+	 * @tparam MagazineSize This is the number of free objects in a full magazine.
+	 * @tparam MaxDepotMagazines This is the number of full magazines the depot will hold before it gives objects back to the slabs.
+	 */
+	template<typename T, unsigned int MagazineSize = 64, unsigned int MaxDepotMagazines = 16>
+	class UU_API ThreadCachingObjectHeap : public ObjectHeap<T>
+	{
+	public:
+		virtual T* Allocate() override
+		{
+			if (IsThreadCacheDestroyed())
+			{
+				void* memory = GetDepot()->Allocate();
+				return memory ? new (memory) T() : nullptr;
+			}
+
+			ThreadCache& cache = GetThreadCache();
+
+			if (cache.loadedMagazine->numObjects == 0)
+			{
+				if (cache.previousMagazine->numObjects > 0)
+					Exchange(cache.loadedMagazine, cache.previousMagazine);
+				else if (!GetDepot()->Reload(cache.loadedMagazine))
+					return nullptr;
+			}
+
+			void* memory = cache.loadedMagazine->objectArray[--cache.loadedMagazine->numObjects];
+			return new (memory) T();
+		}
+
+		virtual bool Deallocate(T* object) override
+		{
+			if (!object)
+				return false;
+
+			object->~T();
+
+			if (IsThreadCacheDestroyed())
+			{
+				GetDepot()->Deallocate(object);
+				return true;
+			}
+
+			ThreadCache& cache = GetThreadCache();
+
+			if (cache.loadedMagazine->numObjects == MagazineSize)
+			{
+				if (cache.previousMagazine->numObjects < MagazineSize)
+					Exchange(cache.loadedMagazine, cache.previousMagazine);
+				else
+				{
+					// Both are full, so trade the previous one for an empty one and start filling that.
+					Magazine* fullMagazine = cache.previousMagazine;
+					cache.previousMagazine = cache.loadedMagazine;
+					cache.loadedMagazine = GetDepot()->TradeFullMagazine(fullMagazine);
+				}
+			}
+
+			cache.loadedMagazine->objectArray[cache.loadedMagazine->numObjects++] = object;
+			return true;
+		}
+
+	private:
+		// This is a slot big enough and aligned enough for an object, but nothing is constructed in it.
+		struct RawObject
+		{
+			RawObject()
+			{
+			}
+
+			alignas(T) unsigned char memory[sizeof(T)];
+		};
+
+		struct Magazine
+		{
+			Magazine* nextMagazine;
+			unsigned int numObjects;
+			void* objectArray[MagazineSize];
+		};
+
+		class Depot
+		{
+		public:
+			Depot()
+			{
+				this->fullMagazineList = nullptr;
+				this->emptyMagazineList = nullptr;
+				this->numFullMagazines = 0;
+			}
+
+			Magazine* NewMagazine()
+			{
+				MutexLocker locker(this->mutex);
+				return this->PopEmptyMagazine();
+			}
+
+			// Refill the given empty magazine, preferably by trading it for a full one.
+			bool Reload(Magazine*& magazine)
+			{
+				MutexLocker locker(this->mutex);
+
+				if (this->fullMagazineList)
+				{
+					Magazine* fullMagazine = this->fullMagazineList;
+					this->fullMagazineList = fullMagazine->nextMagazine;
+					this->numFullMagazines--;
+					this->PushEmptyMagazine(magazine);
+					magazine = fullMagazine;
+					return true;
+				}
+
+				while (magazine->numObjects < MagazineSize)
+				{
+					RawObject* object = this->slabHeap.Allocate();
+					if (!object)
+						break;
+					magazine->objectArray[magazine->numObjects++] = object;
+				}
+
+				return magazine->numObjects > 0;
+			}
+
+			// Take the given full magazine and give back an empty one.
+			Magazine* TradeFullMagazine(Magazine* fullMagazine)
+			{
+				MutexLocker locker(this->mutex);
+
+				if (this->numFullMagazines < MaxDepotMagazines)
+				{
+					this->PushFullMagazine(fullMagazine);
+					return this->PopEmptyMagazine();
+				}
+
+				this->Drain(fullMagazine);
+				return fullMagazine;
+			}
+
+			// These bypass the magazines, for threads that no longer have a cache.
+			void* Allocate()
+			{
+				MutexLocker locker(this->mutex);
+				return this->slabHeap.Allocate();
+			}
+
+			void Deallocate(void* object)
+			{
+				MutexLocker locker(this->mutex);
+				this->slabHeap.Deallocate(static_cast<RawObject*>(object));
+			}
+
+			// Take back whatever a thread had cached when it exits.
+			void Return(Magazine* magazine)
+			{
+				MutexLocker locker(this->mutex);
+
+				if (magazine->numObjects > 0 && this->numFullMagazines < MaxDepotMagazines)
+					this->PushFullMagazine(magazine);
+				else
+				{
+					this->Drain(magazine);
+					this->PushEmptyMagazine(magazine);
+				}
+			}
+
+		private:
+			void Drain(Magazine* magazine)
+			{
+				while (magazine->numObjects > 0)
+					this->slabHeap.Deallocate(static_cast<RawObject*>(magazine->objectArray[--magazine->numObjects]));
+			}
+
+			void PushFullMagazine(Magazine* magazine)
+			{
+				magazine->nextMagazine = this->fullMagazineList;
+				this->fullMagazineList = magazine;
+				this->numFullMagazines++;
+			}
+
+			void PushEmptyMagazine(Magazine* magazine)
+			{
+				magazine->nextMagazine = this->emptyMagazineList;
+				this->emptyMagazineList = magazine;
+			}
+
+			Magazine* PopEmptyMagazine()
+			{
+				Magazine* magazine = this->emptyMagazineList;
+				if (magazine)
+					this->emptyMagazineList = magazine->nextMagazine;
+				else
+					magazine = new Magazine;
+				magazine->nextMagazine = nullptr;
+				magazine->numObjects = 0;
+				return magazine;
+			}
+
+			Mutex mutex;
+			Magazine* fullMagazineList;
+			Magazine* emptyMagazineList;
+			unsigned int numFullMagazines;
+			SlabObjectHeap<RawObject> slabHeap;
+		};
+
+		class ThreadCache
+		{
+		public:
+			ThreadCache()
+			{
+				this->loadedMagazine = GetDepot()->NewMagazine();
+				this->previousMagazine = GetDepot()->NewMagazine();
+			}
+
+			~ThreadCache()
+			{
+				GetDepot()->Return(this->loadedMagazine);
+				GetDepot()->Return(this->previousMagazine);
+				IsThreadCacheDestroyed() = true;
+			}
+
+			Magazine* loadedMagazine;
+			Magazine* previousMagazine;
+		};
+
+		// The depot is never destroyed, so that it outlives every thread's cache, and any static object that frees to it during exit.
+		static Depot* GetDepot()
+		{
+			static Depot* depot = new Depot();
+			return depot;
+		}
+
+		static ThreadCache& GetThreadCache()
+		{
+			static thread_local ThreadCache cache;
+			return cache;
+		}
+
+		// A thread's cache is destroyed before other thread-locals made ahead of it, and before any statics.  Those can still
+		// free objects from their destructors, so this flag, which has no destructor of its own, sends them to the depot instead.
+		static bool& IsThreadCacheDestroyed()
+		{
+			static thread_local bool destroyed = false;
+			return destroyed;
+		}
+	};
 }
\ No newline at end of file
@@ -1,20 +1,43 @@
 #include "UltraUtilities/Memory/Pointer.hpp"
 
-namespace UU
+using namespace UU;
+
+ControlBlock::ControlBlock()
 {
-	Reference::Reference(void* pointer)
+	this->strongCount.Store(1, MemoryOrder::RELAXED);
+
+	// This one weak reference belongs to all the strong references together.
+	this->weakCount.Store(1, MemoryOrder::RELAXED);
+}
+
+/*virtual*/ ControlBlock::~ControlBlock()
+{
+}
+
+bool ControlBlock::TryAddStrongRef()
+{
+	unsigned int count = this->strongCount.Load(MemoryOrder::RELAXED);
+	while (count != 0)
 	{
-		this->pointer = pointer;
-		this->count = 1;
-		this->handle = nextHandle++;
-		refMap.Insert(this->handle, this);
+		if (this->strongCount.CompareExchange(count, count + 1, MemoryOrder::ACQ_REL))
+			return true;
 	}
 
-	/*virtual*/ Reference::~Reference()
+	return false;
+}
+
+void ControlBlock::ReleaseStrongRef()
+{
+	// The release makes our writes to the object visible to whoever destroys it, and the acquire lets that be us.
+	if (this->strongCount.FetchSub(1, MemoryOrder::ACQ_REL) == 1)
 	{
-		refMap.Remove(this->handle);
+		this->DestroyObject();
+		this->ReleaseWeakRef();
 	}
+}
 
-	unsigned long long Reference::nextHandle = 1;
-	HashMap<unsigned long long, Reference*> Reference::refMap;
+void ControlBlock::ReleaseWeakRef()
+{
+	if (this->weakCount.FetchSub(1, MemoryOrder::ACQ_REL) == 1)
+		delete this;
 }
\ No newline at end of file
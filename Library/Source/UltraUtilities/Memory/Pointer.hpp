@@ -1,7 +1,8 @@
 #pragma once
 
 #include "UltraUtilities/Defines.h"
-#include "UltraUtilities/Containers/HashMap.hpp"
+#include "UltraUtilities/Threading/Atomic.h"
+#include <new>
 
 namespace UU
 {
@@ -70,169 +71,251 @@ namespace UU
 
 	/**
 	 * This class is used internally and is not meant to be instantiated by the user.
+	 * It keeps the reference counts for an object shared by @ref SharedPtr instances.
+	 * The object is destroyed when the last strong reference is released, and the block
+	 * itself when the last weak reference is released.  The strong references collectively
+	 * hold one weak reference, so the block outlives the object.  The counts are atomic, so
+	 * pointers to the same object can be copied and released on different threads at once.
 	 */
-	class UU_API Reference
+	class UU_API ControlBlock
 	{
 	public:
-		Reference(void* pointer);
-		virtual ~Reference();
+		ControlBlock();
+		virtual ~ControlBlock();
 
+		void AddStrongRef()
+		{
+			// Whoever is adding a reference already has one, so no ordering is needed here.
+			this->strongCount.FetchAdd(1, MemoryOrder::RELAXED);
+		}
+
+		void AddWeakRef()
+		{
+			this->weakCount.FetchAdd(1, MemoryOrder::RELAXED);
+		}
+
+		/**
+		 * Add a strong reference unless the object is already gone, and tell the caller if we did.
+		 */
+		bool TryAddStrongRef();
+
+		void ReleaseStrongRef();
+		void ReleaseWeakRef();
+
+		unsigned int GetStrongCount() const
+		{
+			return this->strongCount.Load(MemoryOrder::RELAXED);
+		}
+
+	protected:
+		virtual void DestroyObject() = 0;
+
+	private:
+		Atomic<unsigned int> strongCount;
+		Atomic<unsigned int> weakCount;
+	};
+
+	/**
+	 * This class is used internally and is not meant to be instantiated by the user.
+	 * The object lives inside the control block, so that making a shared object takes
+	 * only one allocation and the object and its counts share cache lines.
+	 */
+	template<typename T>
+	class UU_API InlineControlBlock : public ControlBlock
+	{
 	public:
-		static unsigned long long nextHandle;
-		static HashMap<unsigned long long, Reference*> refMap;
+		template<typename... Args>
+		InlineControlBlock(Args&&... args)
+		{
+			new (this->memory) T(static_cast<Args&&>(args)...);
+		}
+
+		T* GetObject()
+		{
+			return reinterpret_cast<T*>(this->memory);
+		}
 
-		void* pointer;
-		unsigned int count;
-		unsigned long long handle;
+	protected:
+		virtual void DestroyObject() override
+		{
+			this->GetObject()->~T();
+		}
+
+	private:
+		alignas(T) unsigned char memory[sizeof(T)];
 	};
 
 	/**
-	 * This is my attempt to make a shared pointer.  It's probably dumb.
+	 * This is a reference-counted pointer to a shared object, which is destroyed when the
+	 * last shared pointer to it goes away.  Use @ref Make to create the object.  A shared
+	 * pointer can be converted to a shared pointer to any base class of its object.
+	 * Different shared pointers to the same object can be used on different threads,
+	 * but a single shared pointer instance is no more thread-safe than a raw pointer.
 	 */
 	template<typename T>
 	class UU_API SharedPtr
 	{
-		template<typename T>
+		template<typename>
 		friend class WeakPtr;
 
 		template<typename>
 		friend class SharedPtr;
 
 	private:
-		SharedPtr(Reference* ref)
+		// This takes over a strong reference the caller has already added.
+		SharedPtr(T* pointer, ControlBlock* block)
 		{
-			this->ref = ref;
+			this->pointer = pointer;
+			this->block = block;
 		}
 
 	public:
 		SharedPtr()
 		{
-			this->ref = nullptr;
-		}
-
-		SharedPtr(SharedPtr<T>& sharedPtr)
-		{
-			this->ref = sharedPtr.ref;
-			this->ref->count++;
+			this->pointer = nullptr;
+			this->block = nullptr;
 		}
 
 		SharedPtr(const SharedPtr<T>& sharedPtr)
 		{
-			this->ref = sharedPtr.ref;
-			this->ref->count++;
+			this->pointer = sharedPtr.pointer;
+			this->block = sharedPtr.block;
+			if (this->block)
+				this->block->AddStrongRef();
 		}
 
 		SharedPtr(SharedPtr<T>&& sharedPtr)
 		{
-			this->ref = sharedPtr.ref;
-			sharedPtr.ref = nullptr;
-		}
-
-		template<typename T2>
-		SharedPtr(SharedPtr<T2>& sharedPtr)
-		{
-			this->ref = nullptr;
-			if (sharedPtr.ref)
-			{
-				const T* pointer = sharedPtr.Get();	// This line is only here to make sure that the cast is valid at compile-time.
-				this->ref = sharedPtr.ref;
-				this->ref->count++;
-			}
+			this->pointer = sharedPtr.pointer;
+			this->block = sharedPtr.block;
+			sharedPtr.pointer = nullptr;
+			sharedPtr.block = nullptr;
 		}
 
 		template<typename T2>
 		SharedPtr(const SharedPtr<T2>& sharedPtr)
 		{
-			this->ref = nullptr;
-			if (sharedPtr.ref)
-			{
-				const T* pointer = sharedPtr.Get();	// This line is only here to make sure that the cast is valid at compile-time.
-				this->ref = sharedPtr.ref;
-				this->ref->count++;
-			}
+			this->pointer = sharedPtr.pointer;		// This only compiles if the cast is valid.
+			this->block = sharedPtr.block;
+			if (this->block)
+				this->block->AddStrongRef();
 		}
 
-		virtual ~SharedPtr()
+		template<typename T2>
+		SharedPtr(SharedPtr<T2>&& sharedPtr)
 		{
-			if (this->ref && --this->ref->count == 0)
-				delete this->ref;
+			this->pointer = sharedPtr.pointer;		// This only compiles if the cast is valid.
+			this->block = sharedPtr.block;
+			sharedPtr.pointer = nullptr;
+			sharedPtr.block = nullptr;
 		}
 
-		void operator=(SharedPtr<T>& sharedPtr)
+		~SharedPtr()
 		{
-			this->ref = sharedPtr.ref;
-			this->ref->count++;
+			this->Reset();
 		}
 
-		void operator=(const SharedPtr<T>& sharedPtr) const
+		SharedPtr<T>& operator=(const SharedPtr<T>& sharedPtr)
 		{
-			this->ref = sharedPtr.ref;
-			this->ref->count++;
+			// Take the new reference before letting go of the old one in case they're the same.
+			T* newPointer = sharedPtr.pointer;
+			ControlBlock* newBlock = sharedPtr.block;
+			if (newBlock)
+				newBlock->AddStrongRef();
+			this->Reset();
+			this->pointer = newPointer;
+			this->block = newBlock;
+			return *this;
 		}
 
-		template<typename T2>
-		void operator=(SharedPtr<T2>& sharedPtr)
+		SharedPtr<T>& operator=(SharedPtr<T>&& sharedPtr)
 		{
-			this->ref = nullptr;
-			if (sharedPtr.ref)
+			if (this != &sharedPtr)
 			{
-				const T* pointer = sharedPtr.Get();	// This line is only here to make sure that the cast is valid at compile-time.
-				this->ref = sharedPtr.ref;
-				this->ref->count++;
+				this->Reset();
+				this->pointer = sharedPtr.pointer;
+				this->block = sharedPtr.block;
+				sharedPtr.pointer = nullptr;
+				sharedPtr.block = nullptr;
 			}
+			return *this;
 		}
 
 		template<typename T2>
-		void operator=(const SharedPtr<T2>& sharedPtr)
+		SharedPtr<T>& operator=(const SharedPtr<T2>& sharedPtr)
+		{
+			T* newPointer = sharedPtr.pointer;		// This only compiles if the cast is valid.
+			ControlBlock* newBlock = sharedPtr.block;
+			if (newBlock)
+				newBlock->AddStrongRef();
+			this->Reset();
+			this->pointer = newPointer;
+			this->block = newBlock;
+			return *this;
+		}
+
+		/**
+		 * Make a new object, passing the given arguments to its constructor, and return
+		 * the only shared pointer to it.  The object and its reference counts are
+		 * allocated together in a single allocation.
+		 */
+		template<class... Args>
+		static SharedPtr<T> Make(Args&&... args)
 		{
-			this->ref = nullptr;
-			if (sharedPtr.ref)
-			{
-				const T* pointer = sharedPtr.Get();	// This line is only here to make sure that the cast is valid at compile-time.
-				this->ref = sharedPtr.ref;
-				this->ref->count++;
-			}
+			auto block = new InlineControlBlock<T>(static_cast<Args&&>(args)...);
+			return SharedPtr<T>(block->GetObject(), block);
 		}
 
-		static SharedPtr<T> Make()
+		/**
+		 * Let go of the object, if any, making this a null pointer.
+		 */
+		void Reset()
 		{
-			Reference* ref = new Reference(new T());
-			return SharedPtr<T>(ref);
+			if (this->block)
+				this->block->ReleaseStrongRef();
+			this->pointer = nullptr;
+			this->block = nullptr;
 		}
 
-		template<class... Args>
-		static SharedPtr<T> Make(Args&&... args)
+		/**
+		 * Return the number of shared pointers to our object, or zero if this is null.
+		 * Note that by the time the caller looks at it, it may have changed on another thread.
+		 */
+		unsigned int GetRefCount() const
 		{
-			Reference* ref = new Reference(new T(args...));
-			return SharedPtr<T>(ref);
+			return this->block ? this->block->GetStrongCount() : 0;
 		}
 
 		T* Get()
 		{
-			return this->ref ? static_cast<T*>(this->ref->pointer) : nullptr;
+			return this->pointer;
 		}
 
 		const T* Get() const
 		{
-			return this->ref ? static_cast<const T*>(this->ref->pointer) : nullptr;
+			return this->pointer;
 		}
 
 		T* operator->()
 		{
-			return this->ref ? static_cast<T*>(this->ref->pointer) : nullptr;
+			return this->pointer;
 		}
 
 		const T* operator->() const
 		{
-			return this->ref ? static_cast<const T*>(this->ref->pointer) : nullptr;
+			return this->pointer;
 		}
 
 	private:
-		Reference* ref;
+		T* pointer;
+		ControlBlock* block;
 	};
 
 	/**
-	 * This is my attempt to make a weak pointer.  It's probably dumb.
+	 * This is a pointer to an object owned by one or more @ref SharedPtr instances that
+	 * doesn't keep the object alive.  It can be turned back into a shared pointer for as
+	 * long as the object exists, which is safe to do even as the last shared pointer is
+	 * being released on another thread.
 	 */
 	template<typename T>
 	class UU_API WeakPtr
@@ -240,32 +323,93 @@ namespace UU
 	public:
 		WeakPtr()
 		{
-			this->handle = 0;
+			this->pointer = nullptr;
+			this->block = nullptr;
 		}
 
-		WeakPtr(WeakPtr<T>& weakPtr)
+		WeakPtr(const WeakPtr<T>& weakPtr)
 		{
-			this->handle = weakPtr.handle;
+			this->pointer = weakPtr.pointer;
+			this->block = weakPtr.block;
+			if (this->block)
+				this->block->AddWeakRef();
 		}
 
-		WeakPtr(SharedPtr<T>& sharedPtr)
+		WeakPtr(WeakPtr<T>&& weakPtr)
 		{
-			this->handle = sharedPtr.ref ? sharedPtr.ref->handle : 0;
+			this->pointer = weakPtr.pointer;
+			this->block = weakPtr.block;
+			weakPtr.pointer = nullptr;
+			weakPtr.block = nullptr;
 		}
 
-		virtual ~WeakPtr()
+		WeakPtr(const SharedPtr<T>& sharedPtr)
 		{
+			this->pointer = sharedPtr.pointer;
+			this->block = sharedPtr.block;
+			if (this->block)
+				this->block->AddWeakRef();
 		}
 
-		SharedPtr<T> Get()
+		~WeakPtr()
 		{
-			Reference* ref = nullptr;
-			Reference::refMap.Find(this->handle, &ref);
-			ref->count++;
-			return SharedPtr<T>(ref);
+			this->Reset();
+		}
+
+		WeakPtr<T>& operator=(const WeakPtr<T>& weakPtr)
+		{
+			T* newPointer = weakPtr.pointer;
+			ControlBlock* newBlock = weakPtr.block;
+			if (newBlock)
+				newBlock->AddWeakRef();
+			this->Reset();
+			this->pointer = newPointer;
+			this->block = newBlock;
+			return *this;
+		}
+
+		WeakPtr<T>& operator=(const SharedPtr<T>& sharedPtr)
+		{
+			T* newPointer = sharedPtr.pointer;
+			ControlBlock* newBlock = sharedPtr.block;
+			if (newBlock)
+				newBlock->AddWeakRef();
+			this->Reset();
+			this->pointer = newPointer;
+			this->block = newBlock;
+			return *this;
+		}
+
+		/**
+		 * Return a shared pointer to our object, or a null shared pointer if the object is gone.
+		 */
+		SharedPtr<T> Get() const
+		{
+			if (this->block && this->block->TryAddStrongRef())
+				return SharedPtr<T>(this->pointer, this->block);
+
+			return SharedPtr<T>();
+		}
+
+		/**
+		 * Tell the caller if our object is gone.  Note that if this returns false,
+		 * the object could still be gone by the time the caller calls @ref Get.
+		 */
+		bool IsExpired() const
+		{
+			return !this->block || this->block->GetStrongCount() == 0;
+		}
+
+		void Reset()
+		{
+			if (this->block)
+				this->block->ReleaseWeakRef();
+			this->pointer = nullptr;
+			this->block = nullptr;
 		}
 
 	private:
-		unsigned long long handle;
+		T* pointer;
+		ControlBlock* block;
 	};
 }
\ No newline at end of file
@@ -135,6 +135,11 @@ int String::CompareWith(const String& string) const
 			return 1;
 	}
 
+	if (lengthA < lengthB)
+		return -1;
+	if (lengthA > lengthB)
+		return 1;
+
 	return 0;
 }
 
@@ -2,6 +2,7 @@
 
 #include "UltraUtilities/Defines.h"
 #include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Hash.h"
 
 namespace UU
 {
@@ -54,25 +55,17 @@ namespace UU
 		 */
 		static bool Equal(const String& stringA, const String& stringB)
 		{
-			return stringA == stringB;
+			return stringA.CompareWith(stringB) == 0;
 		}
 
 		/**
 		 * This is provided for compatabillity with the @ref HashSet and @ref HashMap
-		 * classes so that string keys can be hashed.
+		 * classes so that string keys can be hashed.  The given table size must be a
+		 * power of two.
 		 */
 		static unsigned int Hash(const String& string, unsigned int tableSize)
 		{
-			unsigned int hash = 0;
-			for (unsigned int i = 0; i < string.Length(); i++)
-			{
-				auto j = (unsigned int)(string[i]);
-
-				// I made this up and it's probably stupid.
-				hash += j;
-				hash *= 0xFFFFFFFF - j;
-			}
-			return hash;
+			return HashToIndex(HashBytes(string.charArray->GetBuffer(), string.Length()), tableSize);
 		}
 
 		// TODO: Add split and combine, each with a delimeter.
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+#if defined _MSC_VER
+#	include <intrin.h>
+#endif
+
+namespace UU
+{
+	/**
+	 * These are the memory orderings an atomic operation can be given.  They mean
+	 * the same thing as they do in C++11.  Acquire only applies to loads and release
+	 * only applies to stores.  Read-modify-write operations can be given any of them.
+	 */
+	enum class MemoryOrder
+	{
+		RELAXED,
+		ACQUIRE,
+		RELEASE,
+		ACQ_REL,
+		SEQ_CST
+	};
+
+	/**
+	 * This is a 32-bit or 64-bit integer (or pointer) whose operations are atomic.
+	 * With GCC and Clang these are the __atomic builtins.  With MSVC these are the
+	 * interlocked intrinsics, which are all full barriers, plus volatile loads and
+	 * stores, which have acquire and release semantics on x86 and x64.
+	 */
+	template<typename T>
+	class Atomic
+	{
+	public:
+		Atomic(T value = T(0)) : value(value)
+		{
+			static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Only 32-bit and 64-bit atomics are supported.");
+		}
+
+		Atomic(const Atomic&) = delete;
+		void operator=(const Atomic&) = delete;
+
+		T Load(MemoryOrder order = MemoryOrder::SEQ_CST) const
+		{
+#if defined _MSC_VER
+			T result = this->value;
+			if (order == MemoryOrder::SEQ_CST)
+				_ReadWriteBarrier();
+			return result;
+#else
+			return __atomic_load_n(&this->value, GetOrder(order));
+#endif
+		}
+
+		void Store(T newValue, MemoryOrder order = MemoryOrder::SEQ_CST)
+		{
+#if defined _MSC_VER
+			if (order == MemoryOrder::SEQ_CST)
+				this->Exchange(newValue);
+			else
+				this->value = newValue;
+#else
+			__atomic_store_n(&this->value, newValue, GetOrder(order));
+#endif
+		}
+
+		/**
+		 * Store the given value and return the value that was there before.
+		 */
+		T Exchange(T newValue, MemoryOrder order = MemoryOrder::SEQ_CST)
+		{
+#if defined _MSC_VER
+			if constexpr (sizeof(T) == 4)
+				return (T)_InterlockedExchange(reinterpret_cast<volatile long*>(&this->value), (long)newValue);
+			else
+				return (T)_InterlockedExchange64(reinterpret_cast<volatile __int64*>(&this->value), (__int64)newValue);
+#else
+			return __atomic_exchange_n(&this->value, newValue, GetOrder(order));
+#endif
+		}
+
+		/**
+		 * If the value is the expected value, replace it with the desired value and return true.
+		 * Otherwise, load the value into the expected value and return false.
+		 */
+		bool CompareExchange(T& expected, T desired, MemoryOrder order = MemoryOrder::SEQ_CST)
+		{
+#if defined _MSC_VER
+			T previous;
+			if constexpr (sizeof(T) == 4)
+				previous = (T)_InterlockedCompareExchange(reinterpret_cast<volatile long*>(&this->value), (long)desired, (long)expected);
+			else
+				previous = (T)_InterlockedCompareExchange64(reinterpret_cast<volatile __int64*>(&this->value), (__int64)desired, (__int64)expected);
+			if (previous == expected)
+				return true;
+			expected = previous;
+			return false;
+#else
+			return __atomic_compare_exchange_n(&this->value, &expected, desired, false, GetOrder(order), GetFailureOrder(order));
+#endif
+		}
+
+		/**
+		 * Add the given amount and return the value from before the addition.
+		 */
+		T FetchAdd(T amount, MemoryOrder order = MemoryOrder::SEQ_CST)
+		{
+#if defined _MSC_VER
+			if constexpr (sizeof(T) == 4)
+				return (T)_InterlockedExchangeAdd(reinterpret_cast<volatile long*>(&this->value), (long)amount);
+			else
+				return (T)_InterlockedExchangeAdd64(reinterpret_cast<volatile __int64*>(&this->value), (__int64)amount);
+#else
+			return __atomic_fetch_add(&this->value, amount, GetOrder(order));
+#endif
+		}
+
+		/**
+		 * Subtract the given amount and return the value from before the subtraction.
+		 */
+		T FetchSub(T amount, MemoryOrder order = MemoryOrder::SEQ_CST)
+		{
+			return this->FetchAdd(T(0) - amount, order);
+		}
+
+	private:
+#if !defined _MSC_VER
+		static constexpr int GetOrder(MemoryOrder order)
+		{
+			switch (order)
+			{
+			case MemoryOrder::RELAXED:
+				return __ATOMIC_RELAXED;
+			case MemoryOrder::ACQUIRE:
+				return __ATOMIC_ACQUIRE;
+			case MemoryOrder::RELEASE:
+				return __ATOMIC_RELEASE;
+			case MemoryOrder::ACQ_REL:
+				return __ATOMIC_ACQ_REL;
+			default:
+				return __ATOMIC_SEQ_CST;
+			}
+		}
+
+		// A failed compare-exchange is only a load, so it can't have release semantics.
+		static constexpr int GetFailureOrder(MemoryOrder order)
+		{
+			switch (order)
+			{
+			case MemoryOrder::RELAXED:
+			case MemoryOrder::RELEASE:
+				return __ATOMIC_RELAXED;
+			case MemoryOrder::ACQUIRE:
+			case MemoryOrder::ACQ_REL:
+				return __ATOMIC_ACQUIRE;
+			default:
+				return __ATOMIC_SEQ_CST;
+			}
+		}
+#endif
+
+		alignas(sizeof(T)) volatile T value;
+	};
+}
\ No newline at end of file
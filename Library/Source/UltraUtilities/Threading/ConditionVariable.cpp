@@ -0,0 +1,46 @@
+#include "UltraUtilities/Threading/ConditionVariable.h"
+
+using namespace UU;
+
+ConditionVariable::ConditionVariable()
+{
+#if defined _WIN32
+	InitializeConditionVariable(&this->condition);
+#else
+	pthread_cond_init(&this->condition, nullptr);
+#endif
+}
+
+/*virtual*/ ConditionVariable::~ConditionVariable()
+{
+#if !defined _WIN32
+	pthread_cond_destroy(&this->condition);
+#endif
+}
+
+void ConditionVariable::Wait(Mutex& mutex)
+{
+#if defined _WIN32
+	SleepConditionVariableSRW(&this->condition, &mutex.lock, INFINITE, 0);
+#else
+	pthread_cond_wait(&this->condition, &mutex.mutex);
+#endif
+}
+
+void ConditionVariable::Signal()
+{
+#if defined _WIN32
+	WakeConditionVariable(&this->condition);
+#else
+	pthread_cond_signal(&this->condition);
+#endif
+}
+
+void ConditionVariable::Broadcast()
+{
+#if defined _WIN32
+	WakeAllConditionVariable(&this->condition);
+#else
+	pthread_cond_broadcast(&this->condition);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "UltraUtilities/Threading/Mutex.h"
+
+namespace UU
+{
+	/**
+	 * This lets threads sleep until another thread tells them that something they're
+	 * waiting on may have changed.  It's always used together with a @ref Mutex that
+	 * guards whatever is being waited on.  Since a waiting thread can wake up for no
+	 * reason, it should check what it's waiting on in a loop.
+	 */
+	class UU_API ConditionVariable
+	{
+	public:
+		ConditionVariable();
+		virtual ~ConditionVariable();
+
+		ConditionVariable(const ConditionVariable&) = delete;
+		void operator=(const ConditionVariable&) = delete;
+
+		/**
+		 * Give up the given mutex, which this thread must hold, and sleep until woken up.
+		 * The mutex is held again by the time this returns.
+		 */
+		void Wait(Mutex& mutex);
+
+		/**
+		 * Wake up one of the threads waiting on this, if there are any.
+		 */
+		void Signal();
+
+		/**
+		 * Wake up all of the threads waiting on this.
+		 */
+		void Broadcast();
+
+	private:
+#if defined _WIN32
+		CONDITION_VARIABLE condition;
+#else
+		pthread_cond_t condition;
+#endif
+	};
+}
\ No newline at end of file
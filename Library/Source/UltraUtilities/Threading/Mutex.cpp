@@ -0,0 +1,46 @@
+#include "UltraUtilities/Threading/Mutex.h"
+
+using namespace UU;
+
+Mutex::Mutex()
+{
+#if defined _WIN32
+	InitializeSRWLock(&this->lock);
+#else
+	pthread_mutex_init(&this->mutex, nullptr);
+#endif
+}
+
+/*virtual*/ Mutex::~Mutex()
+{
+#if !defined _WIN32
+	pthread_mutex_destroy(&this->mutex);
+#endif
+}
+
+void Mutex::Lock()
+{
+#if defined _WIN32
+	AcquireSRWLockExclusive(&this->lock);
+#else
+	pthread_mutex_lock(&this->mutex);
+#endif
+}
+
+bool Mutex::TryLock()
+{
+#if defined _WIN32
+	return TryAcquireSRWLockExclusive(&this->lock) != 0;
+#else
+	return pthread_mutex_trylock(&this->mutex) == 0;
+#endif
+}
+
+void Mutex::Unlock()
+{
+#if defined _WIN32
+	ReleaseSRWLockExclusive(&this->lock);
+#else
+	pthread_mutex_unlock(&this->mutex);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+#if !defined _WIN32
+#	include <pthread.h>
+#endif
+
+namespace UU
+{
+	/**
+	 * This is a non-recursive mutual exclusion lock.  Use @ref MutexLocker
+	 * to hold it for the duration of a scope.
+	 */
+	class UU_API Mutex
+	{
+	public:
+		Mutex();
+		virtual ~Mutex();
+
+		Mutex(const Mutex&) = delete;
+		void operator=(const Mutex&) = delete;
+
+		/**
+		 * Block until this thread holds the lock.
+		 */
+		void Lock();
+
+		/**
+		 * Take the lock if nobody else holds it, and tell the caller if we got it.
+		 */
+		bool TryLock();
+
+		/**
+		 * Give up the lock, which this thread must hold.
+		 */
+		void Unlock();
+
+	private:
+		friend class ConditionVariable;
+
+#if defined _WIN32
+		SRWLOCK lock;
+#else
+		pthread_mutex_t mutex;
+#endif
+	};
+
+	/**
+	 * This holds the given mutex for as long as it's in scope.
+	 */
+	class UU_API MutexLocker
+	{
+	public:
+		MutexLocker(Mutex& mutex) : mutex(mutex)
+		{
+			this->mutex.Lock();
+		}
+
+		~MutexLocker()
+		{
+			this->mutex.Unlock();
+		}
+
+	private:
+		Mutex& mutex;
+	};
+}
\ No newline at end of file
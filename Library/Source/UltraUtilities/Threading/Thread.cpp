@@ -0,0 +1,96 @@
+#include "UltraUtilities/Threading/Thread.h"
+
+#if !defined _WIN32
+#	include <unistd.h>
+#endif
+
+using namespace UU;
+
+Thread::Thread()
+{
+#if defined _WIN32
+	this->handle = NULL;
+#endif
+	this->running = false;
+}
+
+/*virtual*/ Thread::~Thread()
+{
+	// Note that a derived class should join before its own members are destroyed.
+	if (this->running)
+		this->Join();
+}
+
+bool Thread::Start()
+{
+	if (this->running)
+		return false;
+
+#if defined _WIN32
+	this->handle = CreateThread(NULL, 0, &Thread::ThreadMain, this, 0, NULL);
+	if (this->handle == NULL)
+		return false;
+#else
+	if (pthread_create(&this->handle, nullptr, &Thread::ThreadMain, this) != 0)
+		return false;
+#endif
+
+	this->running = true;
+	return true;
+}
+
+bool Thread::Join()
+{
+	if (!this->running)
+		return false;
+
+#if defined _WIN32
+	WaitForSingleObject(this->handle, INFINITE);
+	CloseHandle(this->handle);
+	this->handle = NULL;
+#else
+	pthread_join(this->handle, nullptr);
+#endif
+
+	this->running = false;
+	return true;
+}
+
+bool Thread::IsRunning() const
+{
+	return this->running;
+}
+
+/*static*/ unsigned int Thread::GetNumProcessors()
+{
+#if defined _WIN32
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	unsigned int numProcessors = systemInfo.dwNumberOfProcessors;
+#else
+	long result = sysconf(_SC_NPROCESSORS_ONLN);
+	unsigned int numProcessors = (result > 0) ? (unsigned int)result : 1;
+#endif
+
+	return (numProcessors > 0) ? numProcessors : 1;
+}
+
+#if defined _WIN32
+
+/*static*/ DWORD WINAPI Thread::ThreadMain(LPVOID param)
+{
+	auto thread = static_cast<Thread*>(param);
+	thread->Run();
+	return 0;
+}
+
+#else
+
+/*static*/ void* Thread::ThreadMain(void* param)
+{
+	auto thread = static_cast<Thread*>(param);
+	thread->Run();
+	return nullptr;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "UltraUtilities/Defines.h"
+
+#if !defined _WIN32
+#	include <pthread.h>
+#endif
+
+namespace UU
+{
+	/**
+	 * This is the base class for an operating system thread.  Override the
+	 * @ref Run method with the work to be done, then call @ref Start to run
+	 * it on a new thread, and @ref Join to wait for it to finish.
+	 */
+	class UU_API Thread
+	{
+	public:
+		Thread();
+		virtual ~Thread();
+
+		/**
+		 * Begin running this thread.  This fails if the thread is already running.
+		 */
+		bool Start();
+
+		/**
+		 * Block until this thread is done running.  This fails if the thread was never started.
+		 */
+		bool Join();
+
+		/**
+		 * Tell the caller if this thread has been started and not yet joined.
+		 */
+		bool IsRunning() const;
+
+		/**
+		 * Return the number of processors that threads can be scheduled on, which is at least one.
+		 */
+		static unsigned int GetNumProcessors();
+
+	protected:
+		/**
+		 * This is called on the new thread once it has started.
+		 */
+		virtual void Run() = 0;
+
+	private:
+#if defined _WIN32
+		static DWORD WINAPI ThreadMain(LPVOID param);
+		HANDLE handle;
+#else
+		static void* ThreadMain(void* param);
+		pthread_t handle;
+#endif
+		bool running;
+	};
+
+	/**
+	 * This is a thread that just calls the given functor, which is usually a lambda.
+	 */
+	template<typename F>
+	class LambdaThread : public Thread
+	{
+	public:
+		LambdaThread(F functor) : functor(functor)
+		{
+		}
+
+		virtual ~LambdaThread()
+		{
+			// The thread must not outlive the functor it's calling.
+			if (this->IsRunning())
+				this->Join();
+		}
+
+	protected:
+		virtual void Run() override
+		{
+			this->functor();
+		}
+
+	private:
+		F functor;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "UltraUtilities/Containers/BPlusTree.hpp"
+#include "UltraUtilities/Containers/BTree.h"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+using namespace UU;
+
+namespace
+{
+	// This visits every number below the given power of two exactly once, in a scrambled order.
+	unsigned int Scramble(unsigned int i, unsigned int count)
+	{
+		return (i * 2654435761U + 12345U) & (count - 1);
+	}
+
+	class IntegerKey : public BTreeKey
+	{
+	public:
+		IntegerKey(int value) : value(value) {}
+
+		virtual bool IsEqualTo(const BTreeKey* key) const override { return this->value == static_cast<const IntegerKey*>(key)->value; }
+		virtual bool IsLessThan(const BTreeKey* key) const override { return this->value < static_cast<const IntegerKey*>(key)->value; }
+		virtual bool IsGreaterThan(const BTreeKey* key) const override { return this->value > static_cast<const IntegerKey*>(key)->value; }
+
+		int value;
+	};
+}
+
+TEST_CASE("B+ Trees", "[bplustree]")
+{
+	// Small nodes give deep trees, which exercises the splitting and merging far more than the default size would.
+	BPlusTree<int, int, 32> tree;
+	REQUIRE(tree.GetMaxKeysPerNode() == 6);
+
+	SECTION("Test tree insertion and lookup.")
+	{
+		unsigned int numKeys = 1024;
+		for (unsigned int i = 0; i < numKeys; i++)
+		{
+			int key = (int)Scramble(i, numKeys);
+			REQUIRE(tree.Insert(key, key * 10));
+			REQUIRE(tree.IsValid());
+			REQUIRE(tree.GetNumPairs() == i + 1);
+		}
+
+		for (int i = 0; i < (int)numKeys; i++)
+		{
+			int value = 0;
+			REQUIRE(tree.Find(i, &value));
+			REQUIRE(value == i * 10);
+			REQUIRE(tree[i] == i * 10);
+		}
+
+		REQUIRE(!tree.Find(-1));
+		REQUIRE(!tree.Find((int)numKeys));
+
+		// Inserting at an existing key replaces its value.
+		REQUIRE(tree.Insert(7, 77));
+		REQUIRE(tree.GetNumPairs() == numKeys);
+		REQUIRE(tree[7] == 77);
+
+		tree.Clear();
+		REQUIRE(tree.GetNumPairs() == 0);
+		REQUIRE(!tree.Find(7));
+		REQUIRE(tree.IsValid());
+	}
+
+	SECTION("Test tree removal.")
+	{
+		unsigned int numKeys = 1024;
+		for (int i = 0; i < (int)numKeys; i++)
+			tree.Insert(i, -i);
+
+		REQUIRE(!tree.Remove((int)numKeys));
+
+		for (unsigned int i = 0; i < numKeys; i++)
+		{
+			int key = (int)Scramble(i * 3, numKeys);
+			int value = 0;
+			REQUIRE(tree.Remove(key, &value));
+			REQUIRE(value == -key);
+			REQUIRE(!tree.Find(key));
+			REQUIRE(!tree.Remove(key));
+			REQUIRE(tree.IsValid());
+			REQUIRE(tree.GetNumPairs() == numKeys - i - 1);
+		}
+
+		REQUIRE(tree.begin() == tree.end());
+
+		// The tree should work just as well after being emptied out.
+		for (int i = 0; i < 100; i++)
+			tree.Insert(i, i);
+		REQUIRE(tree.IsValid());
+		REQUIRE(tree.GetNumPairs() == 100);
+	}
+
+	SECTION("Test ordered iteration and range scans.")
+	{
+		REQUIRE(tree.begin() == tree.end());
+		REQUIRE(tree.LowerBound(0) == tree.end());
+
+		// Only even keys, so that scans can start between keys.
+		unsigned int numKeys = 512;
+		for (unsigned int i = 0; i < numKeys; i++)
+		{
+			int key = (int)Scramble(i, numKeys) * 2;
+			tree.Insert(key, key + 1);
+		}
+
+		int expectedKey = 0;
+		for (auto pair : tree)
+		{
+			REQUIRE(pair.key == expectedKey);
+			REQUIRE(pair.value == expectedKey + 1);
+			expectedKey += 2;
+		}
+		REQUIRE(expectedKey == (int)numKeys * 2);
+
+		for (int first = -3; first < 40; first++)
+		{
+			int last = first + 25;
+			int expectedFirstKey = (first < 0) ? 0 : (first + 1) & ~1;
+			int numPairsScanned = 0;
+			for (auto iter = tree.LowerBound(first); iter != tree.end() && (*iter).key <= last; ++iter)
+			{
+				REQUIRE((*iter).key == expectedFirstKey + numPairsScanned * 2);
+				numPairsScanned++;
+			}
+			REQUIRE(numPairsScanned == (last - expectedFirstKey) / 2 + 1);
+		}
+
+		REQUIRE(tree.LowerBound((int)numKeys * 2 - 2) != tree.end());
+		REQUIRE(tree.LowerBound((int)numKeys * 2 - 1) == tree.end());
+
+		// Removal keeps the leaves linked in order.
+		for (int key = 0; key < (int)numKeys * 2; key += 4)
+			tree.Remove(key);
+		REQUIRE(tree.IsValid());
+
+		expectedKey = 2;
+		for (auto pair : tree)
+		{
+			REQUIRE(pair.key == expectedKey);
+			expectedKey += 4;
+		}
+		REQUIRE(expectedKey == (int)numKeys * 2 + 2);
+	}
+
+	SECTION("Test a tree with cache-line nodes and wide keys.")
+	{
+		BPlusTree<unsigned long long, double> wideTree;
+		REQUIRE(wideTree.GetMaxKeysPerNode() == 7);
+
+		unsigned int numKeys = 4096;
+		for (unsigned int i = 0; i < numKeys; i++)
+		{
+			unsigned long long key = (unsigned long long)Scramble(i, numKeys) << 32;
+			wideTree.Insert(key, (double)i);
+		}
+		REQUIRE(wideTree.IsValid());
+		REQUIRE(wideTree.GetNumPairs() == numKeys);
+
+		for (unsigned int i = 0; i < numKeys; i += 2)
+			REQUIRE(wideTree.Remove((unsigned long long)Scramble(i, numKeys) << 32));
+		REQUIRE(wideTree.IsValid());
+		REQUIRE(wideTree.GetNumPairs() == numKeys / 2);
+
+		for (unsigned int i = 0; i < numKeys; i++)
+			REQUIRE(wideTree.Find((unsigned long long)Scramble(i, numKeys) << 32) == (i % 2 == 1));
+	}
+}
+
+// This is hidden by default.  Run it with the "[benchmark]" tag, preferably in a release build.
+TEST_CASE("B+ Tree Lookup", "[bplustree][benchmark][.]")
+{
+	unsigned int numKeys = 1 << 20;
+
+	BTree tree(16);
+	BPlusTree<int, int> flatTree;
+	for (unsigned int i = 0; i < numKeys; i++)
+	{
+		int key = (int)Scramble(i, numKeys);
+		tree.InsertKey(new IntegerKey(key));
+		flatTree.Insert(key, key);
+	}
+
+	BENCHMARK("Find with the B-tree")
+	{
+		unsigned int numFound = 0;
+		for (unsigned int i = 0; i < numKeys; i += 16)
+		{
+			IntegerKey key((int)Scramble(i * 7, numKeys));
+			if (tree.FindKey(&key))
+				numFound++;
+		}
+		return numFound;
+	};
+
+	BENCHMARK("Find with the B+ tree")
+	{
+		unsigned int numFound = 0;
+		for (unsigned int i = 0; i < numKeys; i += 16)
+			if (flatTree.Find((int)Scramble(i * 7, numKeys)))
+				numFound++;
+		return numFound;
+	};
+
+	BENCHMARK("Scan with the B+ tree")
+	{
+		long long sum = 0;
+		for (auto pair : flatTree)
+			sum += pair.value;
+		return sum;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "UltraUtilities/Memory/BitStream.hpp"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+using namespace UU;
+
+// This hides the memory of a stream, so that it can only be copied to and from.
+class CopyOnlyStream : public ByteStream
+{
+public:
+	CopyOnlyStream(ByteStream* byteStream) : byteStream(byteStream)
+	{
+	}
+
+	virtual unsigned int WriteBytes(const char* buffer, unsigned int bufferSize) override
+	{
+		return this->byteStream->WriteBytes(buffer, bufferSize);
+	}
+
+	virtual unsigned int ReadBytes(char* buffer, unsigned int bufferSize) override
+	{
+		return this->byteStream->ReadBytes(buffer, bufferSize);
+	}
+
+	virtual unsigned int GetSize() override
+	{
+		return this->byteStream->GetSize();
+	}
+
+private:
+	ByteStream* byteStream;
+};
+
+TEST_CASE("Bit Streams", "[bitstream]")
+{
+	// Widths and values from a simple LCG so that runs are repeatable.
+	DArray<unsigned int> widthArray;
+	DArray<unsigned long long> valueArray;
+	unsigned long long state = 12345;
+	for (unsigned int i = 0; i < 5000; i++)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		unsigned int width = (unsigned int)(state >> 58) + 1;
+		widthArray.Push(width);
+		valueArray.Push((width < 64) ? (state & ((1ULL << width) - 1)) : state);
+	}
+
+	SECTION("Bits are packed LSB-first.")
+	{
+		char buffer[4];
+		MemoryBufferStream byteStream(buffer, sizeof(buffer), false);
+
+		{
+			BitStream bitStream(&byteStream);
+			REQUIRE(bitStream.WriteBits(1, 1));
+			REQUIRE(bitStream.WriteBits(0, 1));
+			REQUIRE(bitStream.WriteBits(5, 3));
+			REQUIRE(bitStream.WriteBits(0xABC, 12));
+			REQUIRE(bitStream.Flush());
+		}
+
+		REQUIRE(byteStream.GetSize() == 3);
+		REQUIRE((unsigned char)buffer[0] == 0x95);
+		REQUIRE((unsigned char)buffer[1] == 0x57);
+		REQUIRE((unsigned char)buffer[2] == 0x01);
+	}
+
+	SECTION("Values of every width round-trip.")
+	{
+		unsigned int chunkSizeArray[] = { 16, 100, UU_BIT_STREAM_CHUNK_SIZE };
+		for (unsigned int chunkSize : chunkSizeArray)
+		{
+			DArray<char> buffer;
+			buffer.SetSize(valueArray.GetSize() * 8 + 8);
+			MemoryBufferStream byteStream(buffer.GetBuffer(), buffer.GetSize(), false);
+
+			BitStream writeStream(&byteStream, chunkSize);
+			for (unsigned int i = 0; i < valueArray.GetSize(); i++)
+				REQUIRE(writeStream.WriteBits(valueArray[i], widthArray[i]));
+			REQUIRE(writeStream.Flush());
+
+			BitStream readStream(&byteStream, chunkSize);
+			for (unsigned int i = 0; i < valueArray.GetSize(); i++)
+			{
+				unsigned long long value = 0;
+				REQUIRE(readStream.ReadBits(value, widthArray[i]));
+				REQUIRE(value == valueArray[i]);
+			}
+		}
+	}
+
+	SECTION("Values round-trip through streams that can only be copied to and from.")
+	{
+		unsigned int chunkSizeArray[] = { 16, 100, UU_BIT_STREAM_CHUNK_SIZE };
+		for (unsigned int chunkSize : chunkSizeArray)
+		{
+			DArray<char> buffer;
+			buffer.SetSize(valueArray.GetSize() * 8 + 8);
+			MemoryBufferStream memoryStream(buffer.GetBuffer(), buffer.GetSize(), false);
+			CopyOnlyStream byteStream(&memoryStream);
+
+			BitStream writeStream(&byteStream, chunkSize);
+			for (unsigned int i = 0; i < valueArray.GetSize(); i++)
+				REQUIRE(writeStream.WriteBits(valueArray[i], widthArray[i]));
+			REQUIRE(writeStream.Flush());
+
+			BitStream readStream(&byteStream, chunkSize);
+			for (unsigned int i = 0; i < valueArray.GetSize(); i++)
+			{
+				unsigned long long value = 0;
+				REQUIRE(readStream.ReadBits(value, widthArray[i]));
+				REQUIRE(value == valueArray[i]);
+			}
+		}
+	}
+
+	SECTION("Values round-trip in place through a ring buffer as it wraps around.")
+	{
+		RingBufferStream byteStream(1000);
+
+		for (unsigned int i = 0; i < valueArray.GetSize(); i += 50)
+		{
+			{
+				BitStream writeStream(&byteStream);
+				for (unsigned int j = i; j < i + 50; j++)
+					REQUIRE(writeStream.WriteBits(valueArray[j], widthArray[j]));
+			}
+
+			BitStream readStream(&byteStream);
+			for (unsigned int j = i; j < i + 50; j++)
+			{
+				unsigned long long value = 0;
+				REQUIRE(readStream.ReadBits(value, widthArray[j]));
+				REQUIRE(value == valueArray[j]);
+			}
+		}
+
+		REQUIRE(byteStream.GetSize() == 0);
+	}
+
+	SECTION("Narrow and signed types round-trip.")
+	{
+		RingBufferStream byteStream(64);
+
+		BitStream writeStream(&byteStream);
+		REQUIRE(writeStream.WriteAllBits(char(-3)));
+		REQUIRE(writeStream.WriteBits(short(-1), 9));
+		REQUIRE(writeStream.WriteAllBits(0xDEADBEEFCAFEF00DULL));
+		REQUIRE(!writeStream.WriteBits(char(0), 9));
+		REQUIRE(writeStream.Flush());
+
+		BitStream readStream(&byteStream);
+		char c = 0;
+		short s = 0;
+		unsigned long long l = 0;
+		REQUIRE(readStream.ReadAllBits(c));
+		REQUIRE(c == -3);
+		REQUIRE(readStream.ReadBits(s, 9));
+		REQUIRE(s == 0x1FF);
+		REQUIRE(readStream.ReadAllBits(l));
+		REQUIRE(l == 0xDEADBEEFCAFEF00DULL);
+	}
+
+	SECTION("Reading past the end fails.")
+	{
+		RingBufferStream byteStream(64);
+
+		BitStream writeStream(&byteStream);
+		REQUIRE(writeStream.WriteBits(0x3F, 6));
+		REQUIRE(writeStream.Flush());
+
+		BitStream readStream(&byteStream);
+		unsigned int value = 0;
+		REQUIRE(readStream.ReadBits(value, 6));
+		REQUIRE(value == 0x3F);
+		REQUIRE(readStream.ReadBits(value, 2));
+		REQUIRE(value == 0);
+		REQUIRE(!readStream.ReadBits(value, 1));
+	}
+
+	SECTION("Unflushed bits are flushed on destruction.")
+	{
+		RingBufferStream byteStream(64);
+
+		{
+			BitStream bitStream(&byteStream);
+			REQUIRE(bitStream.WriteBits(0x7, 3));
+		}
+
+		REQUIRE(byteStream.GetSize() == 1);
+	}
+}
+
+TEST_CASE("Bit Stream Performance", "[bitstream][benchmark][.]")
+{
+	const unsigned int numValues = 1 << 20;
+	DArray<char> buffer;
+	buffer.SetSize(numValues * 2);
+
+	BENCHMARK("Write 13-bit values")
+	{
+		MemoryBufferStream byteStream(buffer.GetBuffer(), buffer.GetSize(), false);
+		BitStream bitStream(&byteStream);
+		for (unsigned int i = 0; i < numValues; i++)
+			bitStream.WriteBits(i & 0x1FFF, 13);
+		return bitStream.Flush();
+	};
+
+	BENCHMARK("Read 13-bit values")
+	{
+		MemoryBufferStream byteStream(buffer.GetBuffer(), buffer.GetSize(), true);
+		BitStream bitStream(&byteStream);
+		unsigned int sum = 0;
+		for (unsigned int i = 0; i < numValues; i++)
+		{
+			unsigned int value = 0;
+			bitStream.ReadBits(value, 13);
+			sum += value;
+		}
+		return sum;
+	};
+}
\ No newline at end of file
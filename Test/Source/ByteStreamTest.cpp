@@ -0,0 +1,397 @@
+#include "UltraUtilities/Memory/AsyncStream.h"
+#include "UltraUtilities/Memory/ByteStream.h"
+#include "UltraUtilities/Memory/FileStream.h"
+#include "UltraUtilities/Memory/MappedFileStream.h"
+#include <catch2/catch_test_macros.hpp>
+#include <stdio.h>
+#if defined _WIN32
+#	include <winioctl.h>
+#endif
+
+using namespace UU;
+
+TEST_CASE("Byte Streams", "[bytestream]")
+{
+	SECTION("Memory buffers can be read and written in place.")
+	{
+		char memoryBuffer[16];
+		MemoryBufferStream byteStream(memoryBuffer, sizeof(memoryBuffer), false);
+
+		unsigned int size = 0;
+		REQUIRE(byteStream.Peek(size) == nullptr);
+		REQUIRE(size == 0);
+
+		char* reservedBuffer = byteStream.Reserve(size);
+		REQUIRE(reservedBuffer == memoryBuffer);
+		REQUIRE(size == 16);
+		::memcpy(reservedBuffer, "abcdef", 6);
+		REQUIRE(byteStream.Commit(6));
+		REQUIRE(!byteStream.Commit(11));
+		REQUIRE(byteStream.GetSize() == 6);
+
+		const char* peekedBuffer = byteStream.Peek(size);
+		REQUIRE(peekedBuffer == memoryBuffer);
+		REQUIRE(size == 6);
+		REQUIRE(byteStream.Consume(2));
+		REQUIRE(!byteStream.Consume(5));
+
+		peekedBuffer = byteStream.Peek(size);
+		REQUIRE(size == 4);
+		REQUIRE(::memcmp(peekedBuffer, "cdef", 4) == 0);
+
+		reservedBuffer = byteStream.Reserve(size);
+		REQUIRE(reservedBuffer == memoryBuffer + 6);
+		REQUIRE(size == 10);
+	}
+
+	SECTION("Ring buffers can be read and written in place, a piece at a time where they wrap around.")
+	{
+		RingBufferStream byteStream(8);
+
+		REQUIRE(byteStream.WriteBytes("abcdef", 6) == 6);
+		char buffer[8];
+		REQUIRE(byteStream.ReadBytes(buffer, 5) == 5);
+
+		// Data now starts near the end of the ring, so room to write is split in two.
+		unsigned int size = 0;
+		char* reservedBuffer = byteStream.Reserve(size);
+		REQUIRE(reservedBuffer != nullptr);
+		REQUIRE(size == 2);
+		::memcpy(reservedBuffer, "gh", 2);
+		REQUIRE(byteStream.Commit(2));
+
+		reservedBuffer = byteStream.Reserve(size);
+		REQUIRE(reservedBuffer != nullptr);
+		REQUIRE(size == 5);
+		::memcpy(reservedBuffer, "ijklm", 5);
+		REQUIRE(byteStream.Commit(5));
+		REQUIRE(byteStream.Reserve(size) == nullptr);
+		REQUIRE(byteStream.GetSize() == 8);
+
+		const char* peekedBuffer = byteStream.Peek(size);
+		REQUIRE(size == 3);
+		REQUIRE(::memcmp(peekedBuffer, "fgh", 3) == 0);
+		REQUIRE(byteStream.Consume(3));
+
+		peekedBuffer = byteStream.Peek(size);
+		REQUIRE(size == 5);
+		REQUIRE(::memcmp(peekedBuffer, "ijklm", 5) == 0);
+		REQUIRE(byteStream.Consume(5));
+		REQUIRE(byteStream.Peek(size) == nullptr);
+		REQUIRE(byteStream.GetSize() == 0);
+	}
+
+	SECTION("Ring buffers round their capacity up to a power of two and can be filled all the way.")
+	{
+		RingBufferStream byteStream(12);
+		REQUIRE(byteStream.GetCapacity() == 16);
+
+		// Sizes too big to round up without overflowing are clamped rather than looping forever.
+		REQUIRE(RoundUpToPowerOfTwo(0) == 1);
+		REQUIRE(RoundUpToPowerOfTwo(UU_MAX_POWER_OF_TWO) == UU_MAX_POWER_OF_TWO);
+		REQUIRE(RoundUpToPowerOfTwo(UU_MAX_POWER_OF_TWO + 1) == UU_MAX_POWER_OF_TWO);
+		REQUIRE(RoundUpToPowerOfTwo(0xFFFFFFFF) == UU_MAX_POWER_OF_TWO);
+
+		char buffer[20];
+		for (int i = 0; i < 20; i++)
+			buffer[i] = 'a' + i;
+
+		REQUIRE(byteStream.WriteBytes(buffer, 20) == 16);
+		REQUIRE(byteStream.GetSize() == 16);
+		REQUIRE(byteStream.WriteBytes(buffer, 1) == 0);
+
+		char readBuffer[20];
+		REQUIRE(byteStream.ReadBytes(readBuffer, 10) == 10);
+		REQUIRE(::memcmp(readBuffer, buffer, 10) == 0);
+
+		// Writing across the end of the ring and reading back across it both take two pieces.
+		REQUIRE(byteStream.WriteBytes(&buffer[16], 4) == 4);
+		REQUIRE(byteStream.ReadBytes(readBuffer, 20) == 10);
+		REQUIRE(::memcmp(readBuffer, &buffer[10], 10) == 0);
+		REQUIRE(byteStream.GetSize() == 0);
+	}
+
+	SECTION("Ring buffers give their readable and writable regions as at most two pieces.")
+	{
+		RingBufferStream byteStream(8);
+
+		ByteSegment segmentArray[2];
+		REQUIRE(byteStream.GetReadableSegments(segmentArray) == 0);
+		REQUIRE(byteStream.GetWritableSegments(segmentArray) == 1);
+		REQUIRE(segmentArray[0].bufferSize == 8);
+
+		REQUIRE(byteStream.WriteBytes("abcdef", 6) == 6);
+		char buffer[8];
+		REQUIRE(byteStream.ReadBytes(buffer, 4) == 4);
+
+		REQUIRE(byteStream.GetWritableSegments(segmentArray) == 2);
+		REQUIRE(segmentArray[0].bufferSize == 2);
+		REQUIRE(segmentArray[1].bufferSize == 4);
+		::memcpy(segmentArray[0].buffer, "gh", 2);
+		::memcpy(segmentArray[1].buffer, "ijkl", 4);
+		REQUIRE(byteStream.Commit(6));
+		REQUIRE(!byteStream.Commit(1));
+		REQUIRE(byteStream.GetWritableSegments(segmentArray) == 0);
+
+		REQUIRE(byteStream.GetReadableSegments(segmentArray) == 2);
+		REQUIRE(segmentArray[0].bufferSize == 4);
+		REQUIRE(::memcmp(segmentArray[0].buffer, "efgh", 4) == 0);
+		REQUIRE(segmentArray[1].bufferSize == 4);
+		REQUIRE(::memcmp(segmentArray[1].buffer, "ijkl", 4) == 0);
+		REQUIRE(byteStream.Consume(8));
+		REQUIRE(byteStream.GetReadableSegments(segmentArray) == 0);
+	}
+
+	SECTION("Several buffers are read and written together.")
+	{
+		char memoryBuffer[10];
+		MemoryBufferStream byteStream(memoryBuffer, sizeof(memoryBuffer), false);
+
+		char header[] = "head";
+		char body[] = "body!";
+		char tail[] = "tail";
+		ByteSegment writeSegmentArray[] = { { header, 4 }, { body, 5 }, { tail, 4 } };
+		REQUIRE(byteStream.WriteBytesV(writeSegmentArray, 3) == 10);
+		REQUIRE(::memcmp(memoryBuffer, "headbody!t", 10) == 0);
+
+		char bufferA[3], bufferB[4], bufferC[5];
+		ByteSegment readSegmentArray[] = { { bufferA, 3 }, { bufferB, 4 }, { bufferC, 5 } };
+		REQUIRE(byteStream.ReadBytesV(readSegmentArray, 3) == 10);
+		REQUIRE(::memcmp(bufferA, "hea", 3) == 0);
+		REQUIRE(::memcmp(bufferB, "dbod", 4) == 0);
+		REQUIRE(::memcmp(bufferC, "y!t", 3) == 0);
+	}
+
+	SECTION("Files are written and read back through a memory mapping.")
+	{
+		const char* filePath = "MappedFileStreamTest.bin";
+
+		MappedFileStream byteStream;
+		REQUIRE(byteStream.Open(filePath, MappedFileStream::Mode::CREATE, 4096));
+		REQUIRE(byteStream.GetSize() == 0);
+		REQUIRE(byteStream.WriteBytes("hello ", 6) == 6);
+
+		unsigned int size = 0;
+		char* reservedBuffer = byteStream.Reserve(size);
+		REQUIRE(reservedBuffer != nullptr);
+		REQUIRE(size == 4090);
+		::memcpy(reservedBuffer, "world", 5);
+		REQUIRE(byteStream.Commit(5));
+		REQUIRE(!byteStream.Commit(4086));
+		REQUIRE(byteStream.Close());
+
+		// The file was cut back to what was written, and can't be written to when read-only.
+		REQUIRE(byteStream.Open(filePath, MappedFileStream::Mode::READ_ONLY));
+		REQUIRE(byteStream.GetSize() == 11);
+		REQUIRE(::memcmp(byteStream.GetBuffer(), "hello world", 11) == 0);
+		REQUIRE(byteStream.WriteBytes("!", 1) == 0);
+		REQUIRE(byteStream.Reserve(size) == nullptr);
+		REQUIRE(!byteStream.Open(filePath, MappedFileStream::Mode::READ_ONLY));
+
+		const char* peekedBuffer = byteStream.Peek(size);
+		REQUIRE(size == 11);
+		REQUIRE(peekedBuffer == byteStream.GetBuffer());
+		REQUIRE(byteStream.Consume(6));
+		char buffer[8];
+		REQUIRE(byteStream.ReadBytes(buffer, sizeof(buffer)) == 5);
+		REQUIRE(::memcmp(buffer, "world", 5) == 0);
+		REQUIRE(byteStream.Close());
+
+		// Opening for reading and writing keeps what's there and adds to the end of it.
+		REQUIRE(byteStream.Open(filePath, MappedFileStream::Mode::READ_WRITE, 64));
+		REQUIRE(byteStream.WriteBytes("!", 1) == 1);
+		REQUIRE(byteStream.GetSize() == 12);
+		REQUIRE(::memcmp(byteStream.GetBuffer(), "hello world!", 12) == 0);
+		REQUIRE(byteStream.Close());
+
+		REQUIRE(byteStream.Open(filePath, MappedFileStream::Mode::READ_ONLY));
+		REQUIRE(byteStream.GetSize() == 12);
+		REQUIRE(byteStream.Close());
+
+		REQUIRE(byteStream.Open(filePath, MappedFileStream::Mode::CREATE));
+		REQUIRE(byteStream.GetSize() == 0);
+		REQUIRE(byteStream.GetBuffer() == nullptr);
+		REQUIRE(byteStream.WriteBytes("!", 1) == 0);
+		REQUIRE(byteStream.Close());
+
+		REQUIRE(!byteStream.Open("NoSuchDirectory/NoSuchFile.bin", MappedFileStream::Mode::READ_ONLY));
+		REQUIRE(!byteStream.IsOpen());
+		::remove(filePath);
+	}
+
+	SECTION("Files too big to map are left alone when they fail to open.")
+	{
+		const char* filePath = "MappedFileStreamTooBigTest.bin";
+		long long fileSize = 5LL * 1024 * 1024 * 1024;
+
+		// The file has to be sparse, so that making it doesn't mean writing 5 GB of zeros.
+		// NTFS files are only sparse if marked so, and we don't bother on file systems that can't.
+#if defined _WIN32
+		HANDLE fileHandle = CreateFileA(filePath, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		REQUIRE(fileHandle != INVALID_HANDLE_VALUE);
+		DWORD numBytesReturned = 0;
+		bool sparse = DeviceIoControl(fileHandle, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &numBytesReturned, NULL) != 0;
+		if (sparse)
+		{
+			LARGE_INTEGER fileSizeInteger;
+			fileSizeInteger.QuadPart = fileSize;
+			REQUIRE(SetFilePointerEx(fileHandle, fileSizeInteger, NULL, FILE_BEGIN));
+			REQUIRE(SetEndOfFile(fileHandle));
+		}
+		CloseHandle(fileHandle);
+#else
+		// Writing one byte at the very end leaves a hole before it.
+		FILE* file = ::fopen(filePath, "wb");
+		REQUIRE(file != nullptr);
+		REQUIRE(::fseeko(file, fileSize - 1, SEEK_SET) == 0);
+		REQUIRE(::fputc('!', file) == '!');
+		REQUIRE(::fclose(file) == 0);
+		bool sparse = true;
+#endif
+
+		if (sparse)
+		{
+			MappedFileStream byteStream;
+			REQUIRE(!byteStream.Open(filePath, MappedFileStream::Mode::READ_WRITE, 1024));
+			REQUIRE(!byteStream.IsOpen());
+
+			FILE* sizeFile = ::fopen(filePath, "rb");
+			REQUIRE(sizeFile != nullptr);
+#if defined _WIN32
+			REQUIRE(::_fseeki64(sizeFile, 0, SEEK_END) == 0);
+			REQUIRE(::_ftelli64(sizeFile) == fileSize);
+#else
+			REQUIRE(::fseeko(sizeFile, 0, SEEK_END) == 0);
+			REQUIRE(::ftello(sizeFile) == fileSize);
+#endif
+			::fclose(sizeFile);
+		}
+
+		::remove(filePath);
+	}
+
+	SECTION("Files are written and read back through a buffer, a small piece at a time.")
+	{
+		const char* filePath = "FileStreamTest.bin";
+
+		// Write just over several buffers' worth, so that the last one is only partly full.
+		char data[3 * 4096 + 1000];
+		for (unsigned int i = 0; i < sizeof(data); i++)
+			data[i] = (char)(i * 7 + (i >> 8));
+
+		for (int i = 0; i < 4; i++)
+		{
+			bool directIO = (i & 1) != 0;
+			bool readAhead = (i & 2) != 0;
+
+			FileStream byteStream(4000);
+			REQUIRE(byteStream.Open(filePath, FileStream::Mode::WRITE, directIO));
+			REQUIRE(byteStream.ReadBytes(data, 1) == 0);
+			for (unsigned int offset = 0; offset < sizeof(data); offset += 13)
+				REQUIRE(byteStream.WriteBytes(&data[offset], UU_MIN(13, sizeof(data) - offset)) == UU_MIN(13, sizeof(data) - offset));
+
+			REQUIRE(byteStream.GetSize() == 0);
+			REQUIRE(byteStream.Close());
+
+			REQUIRE(byteStream.Open(filePath, FileStream::Mode::READ, directIO, readAhead));
+			REQUIRE(byteStream.GetSize() == sizeof(data));
+			REQUIRE(byteStream.WriteBytes(data, 1) == 0);
+
+			unsigned int size = 0;
+			const char* peekedBuffer = byteStream.Peek(size);
+			REQUIRE(size == 4096);
+			REQUIRE(::memcmp(peekedBuffer, data, size) == 0);
+			REQUIRE(byteStream.Consume(5000));
+			REQUIRE(byteStream.GetSize() == sizeof(data) - 5000);
+
+			char readData[sizeof(data)];
+			unsigned int readSize = 5000;
+			while (true)
+			{
+				unsigned int numBytesRead = byteStream.ReadBytes(&readData[readSize], 17);
+				readSize += numBytesRead;
+				if (numBytesRead < 17)
+					break;
+			}
+
+			REQUIRE(readSize == sizeof(data));
+			REQUIRE(::memcmp(&readData[5000], &data[5000], sizeof(data) - 5000) == 0);
+			REQUIRE(byteStream.GetSize() == 0);
+			REQUIRE(byteStream.Peek(size) == nullptr);
+			REQUIRE(!byteStream.Consume(1));
+			REQUIRE(byteStream.Close());
+		}
+
+		REQUIRE(!FileStream().Open("NoSuchDirectory/NoSuchFile.bin", FileStream::Mode::READ));
+		::remove(filePath);
+	}
+
+	SECTION("Streams are written and read on a thread of their own.")
+	{
+		char data[10000];
+		for (unsigned int i = 0; i < sizeof(data); i++)
+			data[i] = (char)(i * 13 + (i >> 7));
+
+		char memoryBuffer[sizeof(data)];
+		MemoryBufferStream memoryStream(memoryBuffer, sizeof(memoryBuffer), false);
+
+		{
+			AsyncStream asyncStream(&memoryStream, AsyncStream::Mode::WRITE, 64, 3);
+			REQUIRE(asyncStream.ReadBytes(memoryBuffer, 1) == 0);
+
+			// Write with copies and in place by turns.
+			unsigned int offset = 0;
+			while (offset < sizeof(data))
+			{
+				unsigned int size = UU_MIN(7, sizeof(data) - offset);
+				if ((offset / 7) % 2 == 0)
+					REQUIRE(asyncStream.WriteBytes(&data[offset], size) == size);
+				else
+				{
+					unsigned int reservedSize = 0;
+					char* reservedBuffer = asyncStream.Reserve(reservedSize);
+					REQUIRE(reservedBuffer != nullptr);
+					size = UU_MIN(size, reservedSize);
+					::memcpy(reservedBuffer, &data[offset], size);
+					REQUIRE(asyncStream.Commit(size));
+				}
+
+				offset += size;
+			}
+
+			REQUIRE(asyncStream.Flush());
+			REQUIRE(memoryStream.GetSize() == sizeof(data));
+			REQUIRE(::memcmp(memoryBuffer, data, sizeof(data)) == 0);
+
+			// The wrapped stream is full now.
+			REQUIRE(asyncStream.WriteBytes(data, 1) == 1);
+			REQUIRE(!asyncStream.Flush());
+		}
+
+		{
+			AsyncStream asyncStream(&memoryStream, AsyncStream::Mode::READ, 100, 2);
+			REQUIRE(asyncStream.WriteBytes(data, 1) == 0);
+
+			unsigned int size = 0;
+			const char* peekedBuffer = asyncStream.Peek(size);
+			REQUIRE(size == 100);
+			REQUIRE(::memcmp(peekedBuffer, data, size) == 0);
+			REQUIRE(asyncStream.Consume(250));
+
+			char readData[sizeof(data)];
+			unsigned int readSize = 250;
+			while (true)
+			{
+				unsigned int numBytesRead = asyncStream.ReadBytes(&readData[readSize], 33);
+				readSize += numBytesRead;
+				if (numBytesRead < 33)
+					break;
+			}
+
+			REQUIRE(readSize == sizeof(data));
+			REQUIRE(::memcmp(&readData[250], &data[250], sizeof(data) - 250) == 0);
+			REQUIRE(asyncStream.GetSize() == 0);
+			REQUIRE(asyncStream.Peek(size) == nullptr);
+		}
+	}
+}
\ No newline at end of file
@@ -1,10 +1,58 @@
+#include "UltraUtilities/Compression/DeflateCompression.h"
+#include "UltraUtilities/Compression/HuffmanCode.h"
 #include "UltraUtilities/Compression/HuffmanCompression.h"
+#include "UltraUtilities/Compression/HuffmanDecodeTable.h"
 #include "UltraUtilities/Compression/LZ77Compression.h"
+#include "UltraUtilities/Compression/ParallelCompression.h"
+#include "UltraUtilities/Memory/AsyncStream.h"
+#include "UltraUtilities/Memory/MappedFileStream.h"
 #include "UltraUtilities/Memory/Pointer.hpp"
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <stdio.h>
 
 using namespace UU;
 
+static bool RoundTrip(Compression* compression, DArray<char>& originalData)
+{
+	MemoryBufferStream originalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+
+	DArray<char> compressedData;
+	compressedData.SetSize(originalData.GetSize() * 2 + 4096);
+	MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+	if (!compression->Compress(&originalDataStream, &compressedDataStream))
+		return false;
+
+	DArray<char> decompressedData;
+	decompressedData.SetSize(originalData.GetSize() + 1);
+	MemoryBufferStream decompressedDataStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+	if (!compression->Decompress(&compressedDataStream, &decompressedDataStream))
+		return false;
+
+	if (decompressedDataStream.GetSize() != originalData.GetSize())
+		return false;
+
+	return ::memcmp(originalData.GetBuffer(), decompressedData.GetBuffer(), originalData.GetSize()) == 0;
+}
+
+// Make text-like data from a skewed distribution so that codes come in a wide range of lengths.
+static void MakeSkewedData(DArray<char>& data, unsigned int size)
+{
+	unsigned long long state = 42;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		unsigned int r = (unsigned int)(state >> 33);
+		unsigned int symbol = 0;
+		while ((r & 1) != 0 && symbol < 40)
+		{
+			symbol++;
+			r >>= 1;
+		}
+		data.Push((char)('A' + symbol + ((r >> 8) & 3) * 40));
+	}
+}
+
 TEST_CASE("Compression", "[compression]")
 {
 	SECTION("Simple compression/decompression tests.")
@@ -65,4 +113,549 @@ TEST_CASE("Compression", "[compression]")
 			}
 		}
 	}
+
+	SECTION("Huffman round trips on larger and degenerate data.")
+	{
+		HuffmanCompression compression;
+
+		DArray<char> skewedData;
+		MakeSkewedData(skewedData, 100000);
+		REQUIRE(RoundTrip(&compression, skewedData));
+
+		DArray<char> sameData;
+		for (unsigned int i = 0; i < 10000; i++)
+			sameData.Push('x');
+		REQUIRE(RoundTrip(&compression, sameData));
+
+		// Frequencies from the Fibonacci sequence give the deepest possible tree, which has to be cut down to size.
+		DArray<char> fibonacciData;
+		unsigned int a = 1, b = 1;
+		for (unsigned int i = 0; i < 26; i++)
+		{
+			for (unsigned int j = 0; j < a; j++)
+				fibonacciData.Push((char)i);
+
+			unsigned int c = a + b;
+			a = b;
+			b = c;
+		}
+		REQUIRE(RoundTrip(&compression, fibonacciData));
+
+		DArray<char> emptyData;
+		REQUIRE(RoundTrip(&compression, emptyData));
+	}
+
+	SECTION("Huffman streams through ring buffers a block at a time.")
+	{
+		DArray<char> originalData;
+		MakeSkewedData(originalData, 30000);
+
+		// The ring buffers can't give back a contiguous buffer, so everything must go through reads and writes.
+		RingBufferStream originalDataStream(65536);
+		REQUIRE(originalDataStream.WriteBytes(originalData.GetBuffer(), originalData.GetSize()) == originalData.GetSize());
+
+		HuffmanCompression compression(1000);
+
+		RingBufferStream compressedDataStream(65536);
+		REQUIRE(compression.Compress(&originalDataStream, &compressedDataStream));
+		REQUIRE(originalDataStream.GetSize() == 0);
+
+		RingBufferStream decompressedDataStream(65536);
+		REQUIRE(compression.Decompress(&compressedDataStream, &decompressedDataStream));
+		REQUIRE(decompressedDataStream.GetSize() == originalData.GetSize());
+
+		DArray<char> decompressedData;
+		decompressedData.SetSize(originalData.GetSize());
+		decompressedDataStream.ReadBytes(decompressedData.GetBuffer(), decompressedData.GetSize());
+		REQUIRE(::memcmp(originalData.GetBuffer(), decompressedData.GetBuffer(), originalData.GetSize()) == 0);
+	}
+
+	SECTION("LZ77 round trips at every level.")
+	{
+		// Repeated phrases with some noise between them give the match finder something to do.
+		DArray<char> originalData;
+		const char* phraseArray[] = { "the quick brown fox ", "jumps over ", "the lazy dog ", "and runs away " };
+		unsigned long long state = 7;
+		for (unsigned int i = 0; i < 2000; i++)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			for (const char* phrase = phraseArray[(state >> 40) & 3]; *phrase; phrase++)
+				originalData.Push(*phrase);
+			if (((state >> 50) & 7) == 0)
+				originalData.Push((char)(state >> 20));
+		}
+
+		for (unsigned int level = 1; level <= 9; level++)
+		{
+			LZ77Compression compression(32 * 1024, level);
+			REQUIRE(RoundTrip(&compression, originalData));
+		}
+
+		unsigned int windowSizeArray[] = { 16, 64, 4096 };
+		for (unsigned int windowSize : windowSizeArray)
+		{
+			LZ77Compression compression(windowSize);
+			REQUIRE(RoundTrip(&compression, originalData));
+		}
+
+		DArray<char> skewedData;
+		MakeSkewedData(skewedData, 50000);
+		LZ77Compression compression(32 * 1024, 9);
+		REQUIRE(RoundTrip(&compression, skewedData));
+
+		// Text made of only a few phrases should shrink to a small fraction of its size.
+		MemoryBufferStream originalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+		DArray<char> compressedData;
+		compressedData.SetSize(originalData.GetSize() * 2);
+		MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+		REQUIRE(compression.Compress(&originalDataStream, &compressedDataStream));
+		REQUIRE(compressedDataStream.GetSize() < originalData.GetSize() / 4);
+		// Input that isn't in one piece, as it is when it wraps around a ring buffer, gets copied out.
+		RingBufferStream ringInputStream(40000);
+		char ringOutputBuffer[40000];
+		REQUIRE(ringInputStream.WriteBytes(ringOutputBuffer, 20000) == 20000);
+		REQUIRE(ringInputStream.ReadBytes(ringOutputBuffer, 20000) == 20000);
+		REQUIRE(ringInputStream.WriteBytes(originalData.GetBuffer(), originalData.GetSize()) == originalData.GetSize());
+
+		RingBufferStream ringCompressedStream(40000);
+		REQUIRE(compression.Compress(&ringInputStream, &ringCompressedStream));
+		REQUIRE(ringInputStream.GetSize() == 0);
+
+		MemoryBufferStream ringDecompressedStream(ringOutputBuffer, sizeof(ringOutputBuffer), false);
+		REQUIRE(compression.Decompress(&ringCompressedStream, &ringDecompressedStream));
+		REQUIRE(ringDecompressedStream.GetSize() == originalData.GetSize());
+		REQUIRE(::memcmp(ringOutputBuffer, originalData.GetBuffer(), originalData.GetSize()) == 0);
+	}
+
+	SECTION("Files compress straight out of and into memory mappings.")
+	{
+		DArray<char> originalData;
+		MakeSkewedData(originalData, 100000);
+
+		MappedFileStream originalFileStream;
+		REQUIRE(originalFileStream.Open("CompressionTestOriginal.bin", MappedFileStream::Mode::CREATE, originalData.GetSize()));
+		REQUIRE(originalFileStream.WriteBytes(originalData.GetBuffer(), originalData.GetSize()) == originalData.GetSize());
+		REQUIRE(originalFileStream.Close());
+
+		LZ77Compression lz77Compression(32 * 1024);
+		HuffmanCompression huffmanCompression;
+		Compression* compressionArray[] = { &lz77Compression, &huffmanCompression };
+		for (Compression* compression : compressionArray)
+		{
+			REQUIRE(originalFileStream.Open("CompressionTestOriginal.bin", MappedFileStream::Mode::READ_ONLY));
+			MappedFileStream compressedFileStream;
+			REQUIRE(compressedFileStream.Open("CompressionTestCompressed.bin", MappedFileStream::Mode::CREATE, originalData.GetSize() * 2));
+			REQUIRE(compression->Compress(&originalFileStream, &compressedFileStream));
+			REQUIRE(originalFileStream.Close());
+
+			MappedFileStream decompressedFileStream;
+			REQUIRE(decompressedFileStream.Open("CompressionTestDecompressed.bin", MappedFileStream::Mode::CREATE, originalData.GetSize() + 4096));
+			REQUIRE(compression->Decompress(&compressedFileStream, &decompressedFileStream));
+			REQUIRE(decompressedFileStream.GetSize() == originalData.GetSize());
+			REQUIRE(::memcmp(decompressedFileStream.GetBuffer(), originalData.GetBuffer(), originalData.GetSize()) == 0);
+		}
+
+		::remove("CompressionTestOriginal.bin");
+		::remove("CompressionTestCompressed.bin");
+		::remove("CompressionTestDecompressed.bin");
+	}
+
+	SECTION("Compression overlaps with writing, and decompression with reading, on other threads.")
+	{
+		DArray<char> originalData;
+		MakeSkewedData(originalData, 100000);
+		MemoryBufferStream originalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+
+		DArray<char> compressedData;
+		compressedData.SetSize(originalData.GetSize() * 2);
+		MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+
+		DeflateCompression compression;
+		{
+			AsyncStream asyncStream(&compressedDataStream, AsyncStream::Mode::WRITE, 4096, 3);
+			REQUIRE(compression.Compress(&originalDataStream, &asyncStream));
+			REQUIRE(asyncStream.Flush());
+		}
+
+		DArray<char> decompressedData;
+		decompressedData.SetSize(originalData.GetSize());
+		MemoryBufferStream decompressedDataStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+		{
+			AsyncStream asyncStream(&compressedDataStream, AsyncStream::Mode::READ, 4096, 3);
+			REQUIRE(compression.Decompress(&asyncStream, &decompressedDataStream));
+		}
+
+		REQUIRE(decompressedDataStream.GetSize() == originalData.GetSize());
+		REQUIRE(::memcmp(decompressedData.GetBuffer(), originalData.GetBuffer(), originalData.GetSize()) == 0);
+	}
+
+	SECTION("LZ77 matches that overlap themselves.")
+	{
+		// Runs of every period up to 20 make matches closer than a word apart, and not much further.
+		DArray<char> originalData;
+		for (unsigned int period = 1; period <= 20; period++)
+			for (unsigned int i = 0; i < 500 + period; i++)
+				originalData.Push((char)('a' + (i % period) + period));
+
+		LZ77Compression compression(32 * 1024);
+		REQUIRE(RoundTrip(&compression, originalData));
+
+		// A run should come down to little more than a literal and a match.
+		DArray<char> runData;
+		for (unsigned int i = 0; i < 10000; i++)
+			runData.Push('z');
+
+		MemoryBufferStream runDataStream(runData.GetBuffer(), runData.GetSize(), true);
+		char compressedBuffer[64];
+		MemoryBufferStream compressedDataStream(compressedBuffer, sizeof(compressedBuffer), false);
+		REQUIRE(compression.Compress(&runDataStream, &compressedDataStream));
+		REQUIRE(compressedDataStream.GetSize() < 16);
+
+		char decompressedBuffer[10000];
+		MemoryBufferStream decompressedDataStream(decompressedBuffer, sizeof(decompressedBuffer), false);
+		REQUIRE(compression.Decompress(&compressedDataStream, &decompressedDataStream));
+		REQUIRE(decompressedDataStream.GetSize() == runData.GetSize());
+		REQUIRE(::memcmp(decompressedBuffer, runData.GetBuffer(), runData.GetSize()) == 0);
+	}
+
+	SECTION("DEFLATE round trips.")
+	{
+		DArray<char> phraseData;
+		const char* phraseArray[] = { "the quick brown fox ", "jumps over ", "the lazy dog ", "and runs away " };
+		unsigned long long state = 11;
+		for (unsigned int i = 0; i < 5000; i++)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			for (const char* phrase = phraseArray[(state >> 40) & 3]; *phrase; phrase++)
+				phraseData.Push(*phrase);
+			if (((state >> 50) & 7) == 0)
+				phraseData.Push((char)(state >> 20));
+		}
+
+		DArray<char> skewedData;
+		MakeSkewedData(skewedData, 100000);
+
+		DArray<char> runData;
+		for (unsigned int period = 1; period <= 20; period++)
+			for (unsigned int i = 0; i < 500 + period; i++)
+				runData.Push((char)('a' + (i % period) + period));
+
+		DArray<char> emptyData;
+
+		for (unsigned int level = 1; level <= 9; level++)
+		{
+			DeflateCompression compression(level);
+			REQUIRE(RoundTrip(&compression, phraseData));
+			REQUIRE(RoundTrip(&compression, skewedData));
+			REQUIRE(RoundTrip(&compression, runData));
+			REQUIRE(RoundTrip(&compression, emptyData));
+		}
+
+		// Small blocks make matches that reach back into the block before.
+		DeflateCompression smallBlockCompression(UU_DEFLATE_DEFAULT_LEVEL, 1000);
+		REQUIRE(RoundTrip(&smallBlockCompression, phraseData));
+		REQUIRE(RoundTrip(&smallBlockCompression, runData));
+
+		// Entropy coding the matches should beat both LZ77 and Huffman coding alone.
+		DeflateCompression deflateCompression;
+		LZ77Compression lz77Compression(32 * 1024);
+		HuffmanCompression huffmanCompression;
+		Compression* compressionArray[] = { &deflateCompression, &lz77Compression, &huffmanCompression };
+		unsigned int compressedSizeArray[3];
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			MemoryBufferStream originalDataStream(phraseData.GetBuffer(), phraseData.GetSize(), true);
+			DArray<char> compressedData;
+			compressedData.SetSize(phraseData.GetSize() * 2);
+			MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+			REQUIRE(compressionArray[i]->Compress(&originalDataStream, &compressedDataStream));
+			compressedSizeArray[i] = compressedDataStream.GetSize();
+		}
+		REQUIRE(compressedSizeArray[0] < compressedSizeArray[1]);
+		REQUIRE(compressedSizeArray[0] < compressedSizeArray[2]);
+
+		// Streaming through ring buffers, nothing can be looked at except through reads and writes.
+		RingBufferStream originalDataStream(65536);
+		REQUIRE(originalDataStream.WriteBytes(phraseData.GetBuffer(), 30000) == 30000);
+
+		RingBufferStream compressedDataStream(65536);
+		REQUIRE(smallBlockCompression.Compress(&originalDataStream, &compressedDataStream));
+
+		RingBufferStream decompressedDataStream(65536);
+		REQUIRE(smallBlockCompression.Decompress(&compressedDataStream, &decompressedDataStream));
+		REQUIRE(decompressedDataStream.GetSize() == 30000);
+
+		DArray<char> decompressedData;
+		decompressedData.SetSize(30000);
+		decompressedDataStream.ReadBytes(decompressedData.GetBuffer(), decompressedData.GetSize());
+		REQUIRE(::memcmp(phraseData.GetBuffer(), decompressedData.GetBuffer(), 30000) == 0);
+	}
+
+	SECTION("Block-parallel compression.")
+	{
+		DArray<char> originalData;
+		MakeSkewedData(originalData, 200000);
+
+		// Noise doesn't compress, so these blocks get stored as they are.
+		unsigned long long state = 3;
+		for (unsigned int i = 0; i < 50000; i++)
+		{
+			state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+			originalData.Push((char)(state >> 56));
+		}
+
+		HuffmanCompression huffmanCompression;
+		LZ77Compression lz77Compression(32 * 1024);
+		DeflateCompression deflateCompression;
+		Compression* blockCompressionArray[] = { &huffmanCompression, &lz77Compression, &deflateCompression };
+
+		for (Compression* blockCompression : blockCompressionArray)
+		{
+			ParallelCompression compression(blockCompression, 16 * 1024, 4);
+			REQUIRE(RoundTrip(&compression, originalData));
+
+			DArray<char> emptyData;
+			REQUIRE(RoundTrip(&compression, emptyData));
+
+			// Every block should come back on its own, just as it was.
+			MemoryBufferStream originalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+			DArray<char> compressedData;
+			compressedData.SetSize(originalData.GetSize() * 2);
+			MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+			REQUIRE(compression.Compress(&originalDataStream, &compressedDataStream));
+
+			DArray<ParallelCompression::BlockInfo> blockIndex;
+			REQUIRE(ParallelCompression::ReadBlockIndex(compressedData.GetBuffer(), compressedDataStream.GetSize(), blockIndex));
+			REQUIRE(blockIndex.GetSize() == (originalData.GetSize() + 16 * 1024 - 1) / (16 * 1024));
+
+			unsigned int originalOffset = 0;
+			for (unsigned int i = 0; i < blockIndex.GetSize(); i++)
+			{
+				char blockBuffer[16 * 1024];
+				MemoryBufferStream blockStream(blockBuffer, sizeof(blockBuffer), false);
+				REQUIRE(compression.DecompressBlock(compressedData.GetBuffer(), compressedDataStream.GetSize(), i, &blockStream));
+				REQUIRE(blockStream.GetSize() == blockIndex[i].originalSize);
+				REQUIRE(::memcmp(blockBuffer, originalData.GetBuffer() + originalOffset, blockStream.GetSize()) == 0);
+				originalOffset += blockIndex[i].originalSize;
+			}
+			REQUIRE(originalOffset == originalData.GetSize());
+
+			char blockBuffer[16];
+			MemoryBufferStream blockStream(blockBuffer, sizeof(blockBuffer), false);
+			REQUIRE(!compression.DecompressBlock(compressedData.GetBuffer(), compressedDataStream.GetSize(), blockIndex.GetSize(), &blockStream));
+
+			// A block that doesn't come out at the size its index entry gives is an error.  The original size is
+			// the last 4 bytes of each 16-byte entry, and the entries come just before the 8-byte trailer.
+			for (unsigned int i = 0; i < blockIndex.GetSize(); i++)
+			{
+				if (blockIndex[i].compressedSize == blockIndex[i].originalSize)
+					continue;
+
+				unsigned char* sizeBytes = (unsigned char*)compressedData.GetBuffer() + compressedDataStream.GetSize() - 8 - (blockIndex.GetSize() - i) * 16 + 12;
+				unsigned int wrongSize = blockIndex[i].originalSize + 1;
+				for (unsigned int j = 0; j < 4; j++)
+					sizeBytes[j] = (unsigned char)(wrongSize >> (8 * j));
+
+				char wrongBlockBuffer[16 * 1024 + 1];
+				MemoryBufferStream wrongBlockStream(wrongBlockBuffer, sizeof(wrongBlockBuffer), false);
+				REQUIRE(!compression.DecompressBlock(compressedData.GetBuffer(), compressedDataStream.GetSize(), i, &wrongBlockStream));
+				REQUIRE(wrongBlockStream.GetSize() == 0);
+				break;
+			}
+
+			REQUIRE(!ParallelCompression::ReadBlockIndex(compressedData.GetBuffer(), compressedDataStream.GetSize() - 1, blockIndex));
+		}
+
+		// Frames can also be streamed, in which case the index is just passed over.
+		ParallelCompression compression(&deflateCompression, 1000, 3);
+
+		RingBufferStream originalDataStream(65536);
+		REQUIRE(originalDataStream.WriteBytes(originalData.GetBuffer(), 30000) == 30000);
+
+		RingBufferStream compressedDataStream(65536);
+		REQUIRE(compression.Compress(&originalDataStream, &compressedDataStream));
+
+		RingBufferStream decompressedDataStream(65536);
+		REQUIRE(compression.Decompress(&compressedDataStream, &decompressedDataStream));
+		REQUIRE(decompressedDataStream.GetSize() == 30000);
+
+		DArray<char> decompressedData;
+		decompressedData.SetSize(30000);
+		decompressedDataStream.ReadBytes(decompressedData.GetBuffer(), decompressedData.GetSize());
+		REQUIRE(::memcmp(originalData.GetBuffer(), decompressedData.GetBuffer(), 30000) == 0);
+	}
+
+	SECTION("Length-limited canonical Huffman codes.")
+	{
+		unsigned int frequencyArray[40];
+		unsigned int a = 1, b = 1;
+		for (unsigned int i = 0; i < 40; i++)
+		{
+			frequencyArray[i] = (i < 30) ? a : 0;
+			unsigned int c = a + b;
+			a = b;
+			b = c;
+		}
+
+		unsigned char codeLengthArray[40];
+		REQUIRE(CalcHuffmanCodeLengths(frequencyArray, 40, UU_HUFFMAN_MAX_CODE_LENGTH, codeLengthArray));
+
+		// The code must be complete: every bit pattern starts with some code.
+		unsigned int totalUnits = 0;
+		for (unsigned int i = 0; i < 40; i++)
+		{
+			REQUIRE(codeLengthArray[i] <= UU_HUFFMAN_MAX_CODE_LENGTH);
+			REQUIRE((codeLengthArray[i] == 0) == (i >= 30));
+			if (codeLengthArray[i] > 0)
+				totalUnits += 1 << (UU_HUFFMAN_MAX_CODE_LENGTH - codeLengthArray[i]);
+		}
+		REQUIRE(totalUnits == 1 << UU_HUFFMAN_MAX_CODE_LENGTH);
+
+		// More frequent symbols never get longer codes.
+		for (unsigned int i = 1; i < 30; i++)
+			REQUIRE(codeLengthArray[i] <= codeLengthArray[i - 1]);
+
+		unsigned int codeArray[40];
+		REQUIRE(CalcCanonicalHuffmanCodes(codeLengthArray, 40, codeArray));
+
+		HuffmanDecodeTable decodeTable;
+		REQUIRE(decodeTable.Build(codeLengthArray, 40));
+		for (unsigned int i = 0; i < 30; i++)
+		{
+			REQUIRE(codeArray[i] >> 16 == codeLengthArray[i]);
+			unsigned int symbol = 0;
+			REQUIRE(decodeTable.Decode(codeArray[i] & 0xFFFF, symbol) == codeLengthArray[i]);
+			REQUIRE(symbol == i);
+		}
+
+		// Lengths that oversubscribe the code space are rejected.
+		codeLengthArray[0] = 1;
+		codeLengthArray[1] = 1;
+		codeLengthArray[2] = 1;
+		REQUIRE(!CalcCanonicalHuffmanCodes(codeLengthArray, 40, codeArray));
+	}
+
+	SECTION("Huffman decode tables.")
+	{
+		// Codes 0, 10, 110, ... in stream order, so that the last ones need secondary tables.
+		unsigned long long codeArray[30];
+		unsigned char codeLengthArray[30];
+		for (unsigned int i = 0; i < 30; i++)
+		{
+			codeLengthArray[i] = (unsigned char)((i < 29) ? i + 1 : 29);
+			codeArray[i] = (i < 29) ? ((1ULL << i) - 1) : ((1ULL << 29) - 1);
+		}
+
+		HuffmanDecodeTable decodeTable;
+		REQUIRE(decodeTable.Build(codeArray, codeLengthArray, 30));
+		REQUIRE(decodeTable.GetMaxCodeLength() == 29);
+
+		for (unsigned int i = 0; i < 30; i++)
+		{
+			unsigned int symbol = 0;
+			REQUIRE(decodeTable.Decode(codeArray[i] | (0x5ULL << codeLengthArray[i]), symbol) == codeLengthArray[i]);
+			REQUIRE(symbol == i);
+		}
+
+		// A code that isn't prefix-free is rejected.
+		codeArray[1] = 0;
+		REQUIRE(!decodeTable.Build(codeArray, codeLengthArray, 30));
+	}
+}
+
+TEST_CASE("Compression Performance", "[compression][benchmark][.]")
+{
+	DArray<char> originalData;
+	MakeSkewedData(originalData, 1 << 20);
+
+	DArray<char> compressedData;
+	compressedData.SetSize(originalData.GetSize() * 2);
+	DArray<char> decompressedData;
+	decompressedData.SetSize(originalData.GetSize());
+
+	HuffmanCompression huffmanCompression;
+	MemoryBufferStream originalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+	MemoryBufferStream compressedDataStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+	REQUIRE(huffmanCompression.Compress(&originalDataStream, &compressedDataStream));
+	unsigned int compressedSize = compressedDataStream.GetSize();
+
+	LZ77Compression lz77Compression(32 * 1024);
+	MemoryBufferStream lz77OriginalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+	DArray<char> lz77CompressedData;
+	lz77CompressedData.SetSize(originalData.GetSize() * 2);
+	MemoryBufferStream lz77CompressedDataStream(lz77CompressedData.GetBuffer(), lz77CompressedData.GetSize(), false);
+	REQUIRE(lz77Compression.Compress(&lz77OriginalDataStream, &lz77CompressedDataStream));
+	unsigned int lz77CompressedSize = lz77CompressedDataStream.GetSize();
+
+	DeflateCompression deflateCompression;
+	MemoryBufferStream deflateOriginalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+	DArray<char> deflateCompressedData;
+	deflateCompressedData.SetSize(originalData.GetSize() * 2);
+	MemoryBufferStream deflateCompressedDataStream(deflateCompressedData.GetBuffer(), deflateCompressedData.GetSize(), false);
+	REQUIRE(deflateCompression.Compress(&deflateOriginalDataStream, &deflateCompressedDataStream));
+	unsigned int deflateCompressedSize = deflateCompressedDataStream.GetSize();
+
+	BENCHMARK("Huffman compress 1 MB")
+	{
+		MemoryBufferStream inputStream(originalData.GetBuffer(), originalData.GetSize(), true);
+		MemoryBufferStream outputStream(compressedData.GetBuffer(), compressedData.GetSize(), false);
+		return huffmanCompression.Compress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("Huffman decompress 1 MB")
+	{
+		MemoryBufferStream inputStream(compressedData.GetBuffer(), compressedSize, true);
+		MemoryBufferStream outputStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+		return huffmanCompression.Decompress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("LZ77 compress 1 MB")
+	{
+		MemoryBufferStream inputStream(originalData.GetBuffer(), originalData.GetSize(), true);
+		MemoryBufferStream outputStream(lz77CompressedData.GetBuffer(), lz77CompressedData.GetSize(), false);
+		return lz77Compression.Compress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("LZ77 decompress 1 MB")
+	{
+		MemoryBufferStream inputStream(lz77CompressedData.GetBuffer(), lz77CompressedSize, true);
+		MemoryBufferStream outputStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+		return lz77Compression.Decompress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("DEFLATE compress 1 MB")
+	{
+		MemoryBufferStream inputStream(originalData.GetBuffer(), originalData.GetSize(), true);
+		MemoryBufferStream outputStream(deflateCompressedData.GetBuffer(), deflateCompressedData.GetSize(), false);
+		return deflateCompression.Compress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("DEFLATE decompress 1 MB")
+	{
+		MemoryBufferStream inputStream(deflateCompressedData.GetBuffer(), deflateCompressedSize, true);
+		MemoryBufferStream outputStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+		return deflateCompression.Decompress(&inputStream, &outputStream);
+	};
+
+	ParallelCompression parallelCompression(&deflateCompression, 64 * 1024);
+	MemoryBufferStream parallelOriginalDataStream(originalData.GetBuffer(), originalData.GetSize(), true);
+	DArray<char> parallelCompressedData;
+	parallelCompressedData.SetSize(originalData.GetSize() * 2);
+	MemoryBufferStream parallelCompressedDataStream(parallelCompressedData.GetBuffer(), parallelCompressedData.GetSize(), false);
+	REQUIRE(parallelCompression.Compress(&parallelOriginalDataStream, &parallelCompressedDataStream));
+	unsigned int parallelCompressedSize = parallelCompressedDataStream.GetSize();
+
+	BENCHMARK("Parallel DEFLATE compress 1 MB")
+	{
+		MemoryBufferStream inputStream(originalData.GetBuffer(), originalData.GetSize(), true);
+		MemoryBufferStream outputStream(parallelCompressedData.GetBuffer(), parallelCompressedData.GetSize(), false);
+		return parallelCompression.Compress(&inputStream, &outputStream);
+	};
+
+	BENCHMARK("Parallel DEFLATE decompress 1 MB")
+	{
+		MemoryBufferStream inputStream(parallelCompressedData.GetBuffer(), parallelCompressedSize, true);
+		MemoryBufferStream outputStream(decompressedData.GetBuffer(), decompressedData.GetSize(), false);
+		return parallelCompression.Decompress(&inputStream, &outputStream);
+	};
 }
\ No newline at end of file
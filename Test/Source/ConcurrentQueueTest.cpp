@@ -0,0 +1,285 @@
+#include "UltraUtilities/Containers/SPSCQueue.hpp"
+#include "UltraUtilities/Containers/MPMCQueue.hpp"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Memory/ConcurrentRingBufferStream.h"
+#include "UltraUtilities/Threading/Thread.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace UU;
+
+TEST_CASE("Concurrent Queues", "[concurrentqueue]")
+{
+	const int numThreads = 4;
+
+	SECTION("Single-producer single-consumer queues hand values over in order.")
+	{
+		SPSCQueue<int> queue(5);
+		REQUIRE(queue.GetCapacity() == 8);
+
+		int value = 0;
+		REQUIRE(!queue.TryPop(value));
+		for (int i = 0; i < 8; i++)
+			REQUIRE(queue.TryPush(i));
+		REQUIRE(!queue.TryPush(8));
+		REQUIRE(queue.GetSize() == 8);
+		for (int i = 0; i < 8; i++)
+		{
+			REQUIRE(queue.TryPop(value));
+			REQUIRE(value == i);
+		}
+		REQUIRE(!queue.TryPop(value));
+
+		// Keep the queue big so that the two threads don't spend all their time waiting on each other when there's only one processor.
+		SPSCQueue<int> bigQueue(4096);
+		const int numValues = 100000;
+		auto produce = [&bigQueue]()
+		{
+			for (int i = 0; i < numValues; i++)
+				while (!bigQueue.TryPush(i))
+				{
+				}
+		};
+
+		LambdaThread<decltype(produce)> producer(produce);
+		REQUIRE(producer.Start());
+
+		bool ok = true;
+		for (int i = 0; i < numValues; i++)
+		{
+			while (!bigQueue.TryPop(value))
+			{
+			}
+			ok = ok && value == i;
+		}
+
+		REQUIRE(producer.Join());
+		REQUIRE(ok);
+		REQUIRE(bigQueue.GetSize() == 0);
+	}
+
+	SECTION("Multiple-producer multiple-consumer queues hand every value to exactly one consumer.")
+	{
+		MPMCQueue<int> queue(1000);
+		REQUIRE(queue.GetCapacity() == 1024);
+
+		const int numValues = 10000;
+		DArray<int> countArray(numThreads * numValues);
+		for (int i = 0; i < numThreads * numValues; i++)
+			countArray[i] = 0;
+
+		bool ok[numThreads];
+		Atomic<int> numPopped(0);
+
+		auto produce = [&queue](int i)
+		{
+			for (int j = 0; j < numValues; j++)
+				while (!queue.TryPush(i * numValues + j))
+				{
+				}
+		};
+
+		// Values from any one producer have to come out in the order it pushed them.
+		auto consume = [&queue, &countArray, &ok, &numPopped](int i)
+		{
+			int lastValueArray[numThreads];
+			for (int k = 0; k < numThreads; k++)
+				lastValueArray[k] = -1;
+
+			ok[i] = true;
+			while (numPopped.Load() < numThreads * numValues)
+			{
+				int value = 0;
+				if (!queue.TryPop(value))
+					continue;
+
+				numPopped.FetchAdd(1);
+				int producer = value / numValues;
+				ok[i] = ok[i] && value > lastValueArray[producer];
+				lastValueArray[producer] = value;
+				countArray[value]++;
+			}
+		};
+
+		DArray<Thread*> threadArray;
+		for (int i = 0; i < numThreads; i++)
+		{
+			auto produceFunc = [&produce, i]() { produce(i); };
+			threadArray.Push(new LambdaThread<decltype(produceFunc)>(produceFunc));
+			auto consumeFunc = [&consume, i]() { consume(i); };
+			threadArray.Push(new LambdaThread<decltype(consumeFunc)>(consumeFunc));
+		}
+		for (Thread* thread : threadArray)
+			REQUIRE(thread->Start());
+		for (Thread* thread : threadArray)
+			delete thread;
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+
+		bool allOnce = true;
+		for (int i = 0; i < numThreads * numValues; i++)
+			allOnce = allOnce && countArray[i] == 1;
+		REQUIRE(allOnce);
+		REQUIRE(queue.GetSize() == 0);
+	}
+
+	SECTION("Single-producer single-consumer ring buffers stream bytes between two threads.")
+	{
+		SPSCRingBufferStream byteStream(60000);
+		REQUIRE(byteStream.GetCapacity() == 65536);
+
+		const unsigned int numBytes = 1000000;
+		auto makeByte = [](unsigned int i) -> char { return (char)(i * 31 + (i >> 9)); };
+
+		// Write with copies and in place by turns, in pieces of all different sizes.
+		auto produce = [&byteStream, &makeByte]()
+		{
+			char buffer[300];
+			unsigned int offset = 0;
+			for (unsigned int k = 0; offset < numBytes; k++)
+			{
+				unsigned int size = UU_MIN(k % 300 + 1, numBytes - offset);
+				if (k % 2 == 0)
+				{
+					for (unsigned int i = 0; i < size; i++)
+						buffer[i] = makeByte(offset + i);
+					unsigned int numBytesWritten = 0;
+					while (numBytesWritten < size)
+						numBytesWritten += byteStream.WriteBytes(&buffer[numBytesWritten], size - numBytesWritten);
+					offset += size;
+				}
+				else
+				{
+					unsigned int reservedSize = 0;
+					char* reservedBuffer = byteStream.Reserve(reservedSize);
+					size = UU_MIN(size, reservedSize);
+					for (unsigned int i = 0; i < size; i++)
+						reservedBuffer[i] = makeByte(offset + i);
+					byteStream.Commit(size);
+					offset += size;
+				}
+			}
+		};
+
+		LambdaThread<decltype(produce)> producer(produce);
+		REQUIRE(producer.Start());
+
+		bool ok = true;
+		unsigned int offset = 0;
+		char buffer[200];
+		for (unsigned int k = 0; offset < numBytes; k++)
+		{
+			if (k % 2 == 0)
+			{
+				unsigned int numBytesRead = byteStream.ReadBytes(buffer, k % 200 + 1);
+				for (unsigned int i = 0; i < numBytesRead; i++)
+					ok = ok && buffer[i] == makeByte(offset + i);
+				offset += numBytesRead;
+			}
+			else
+			{
+				unsigned int size = 0;
+				const char* peekedBuffer = byteStream.Peek(size);
+				for (unsigned int i = 0; i < size; i++)
+					ok = ok && peekedBuffer[i] == makeByte(offset + i);
+				ok = ok && byteStream.Consume(size);
+				offset += size;
+			}
+		}
+
+		REQUIRE(producer.Join());
+		REQUIRE(ok);
+		REQUIRE(offset == numBytes);
+		REQUIRE(byteStream.GetSize() == 0);
+	}
+
+	SECTION("Multiple-producer multiple-consumer ring buffers keep each message whole.")
+	{
+		MPMCRingBufferStream byteStream(16, 32);
+		REQUIRE(byteStream.GetMaxMessageSize() == 32);
+		MPMCRingBufferStream bigByteStream(1024, 32);
+
+		char buffer[100];
+		REQUIRE(byteStream.WriteBytes("one", 3) == 3);
+		REQUIRE(byteStream.WriteBytes("two", 3) == 3);
+		REQUIRE(byteStream.GetSize() == 6);
+		REQUIRE(byteStream.ReadBytes(buffer, 31) == 0);
+		REQUIRE(byteStream.ReadBytes(buffer, 32) == 3);
+		REQUIRE(::memcmp(buffer, "one", 3) == 0);
+		REQUIRE(byteStream.ReadBytes(buffer, sizeof(buffer)) == 3);
+		REQUIRE(::memcmp(buffer, "two", 3) == 0);
+
+		// Writes longer than a message are broken up, and stop when the stream is full.
+		for (int i = 0; i < (int)sizeof(buffer); i++)
+			buffer[i] = (char)i;
+		REQUIRE(byteStream.WriteBytes(buffer, 100) == 100);
+		REQUIRE(byteStream.GetSize() == 100);
+		char bigBuffer[16 * 32];
+		REQUIRE(byteStream.WriteBytes(bigBuffer, sizeof(bigBuffer)) == 12 * 32);
+		REQUIRE(byteStream.ReadBytes(bigBuffer, sizeof(bigBuffer)) == 100 + 12 * 32);
+		REQUIRE(::memcmp(bigBuffer, buffer, 100) == 0);
+		REQUIRE(byteStream.GetSize() == 0);
+
+		// Each message says who wrote it, its number, and is filled out to a length that varies with the number.
+		const int numMessages = 10000;
+		bool ok[numThreads];
+		Atomic<int> numRead(0);
+
+		auto produce = [&bigByteStream](int i)
+		{
+			char message[32];
+			for (int j = 0; j < numMessages; j++)
+			{
+				unsigned int size = 8 + j % 25;
+				*(int*)&message[0] = i;
+				*(int*)&message[4] = j;
+				for (unsigned int k = 8; k < size; k++)
+					message[k] = (char)(i + j + k);
+				while (bigByteStream.WriteBytes(message, size) == 0)
+				{
+				}
+			}
+		};
+
+		auto consume = [&bigByteStream, &ok, &numRead](int i)
+		{
+			int lastMessageArray[numThreads];
+			for (int k = 0; k < numThreads; k++)
+				lastMessageArray[k] = -1;
+
+			ok[i] = true;
+			char message[32];
+			while (numRead.Load() < numThreads * numMessages)
+			{
+				unsigned int size = bigByteStream.ReadBytes(message, sizeof(message));
+				if (size == 0)
+					continue;
+
+				numRead.FetchAdd(1);
+				int producer = *(int*)&message[0];
+				int j = *(int*)&message[4];
+				ok[i] = ok[i] && producer >= 0 && producer < numThreads && size == 8 + (unsigned int)(j % 25) && j > lastMessageArray[producer];
+				for (unsigned int k = 8; k < size && ok[i]; k++)
+					ok[i] = message[k] == (char)(producer + j + k);
+				lastMessageArray[producer] = j;
+			}
+		};
+
+		DArray<Thread*> threadArray;
+		for (int i = 0; i < numThreads; i++)
+		{
+			auto produceFunc = [&produce, i]() { produce(i); };
+			threadArray.Push(new LambdaThread<decltype(produceFunc)>(produceFunc));
+			auto consumeFunc = [&consume, i]() { consume(i); };
+			threadArray.Push(new LambdaThread<decltype(consumeFunc)>(consumeFunc));
+		}
+		for (Thread* thread : threadArray)
+			REQUIRE(thread->Start());
+		for (Thread* thread : threadArray)
+			delete thread;
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+		REQUIRE(bigByteStream.GetSize() == 0);
+	}
+}
\ No newline at end of file
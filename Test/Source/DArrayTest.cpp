@@ -1,10 +1,36 @@
 #include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Containers/DArrayParallelSort.hpp"
 #include "UltraUtilities/Containers/PriorityQueue.hpp"
 #include "UltraUtilities/Random.h"
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 
 using namespace UU;
 
+namespace
+{
+	// This keeps count of how many instances are alive and how many times they've been copied.
+	class Tracked
+	{
+	public:
+		Tracked(int value = 0) : value(value) { numAlive++; }
+		Tracked(const Tracked& tracked) : value(tracked.value) { numAlive++; numCopies++; }
+		Tracked(Tracked&& tracked) : value(tracked.value) { numAlive++; }
+		~Tracked() { numAlive--; }
+
+		void operator=(const Tracked& tracked) { this->value = tracked.value; numCopies++; }
+		void operator=(Tracked&& tracked) { this->value = tracked.value; }
+
+		int value;
+
+		static int numAlive;
+		static int numCopies;
+	};
+
+	int Tracked::numAlive = 0;
+	int Tracked::numCopies = 0;
+}
+
 TEST_CASE("Dynamic Arrays", "[darray]")
 {
 	DArray<int> array(10);
@@ -64,7 +90,47 @@ TEST_CASE("Dynamic Arrays", "[darray]")
 		REQUIRE(arrayD[4] == 5);
 	}
 
-	SECTION("Test bubble sort.")
+	SECTION("Test element lifetimes.")
+	{
+		Tracked::numAlive = 0;
+		Tracked::numCopies = 0;
+
+		{
+			DArray<Tracked> trackedArray;
+			REQUIRE(Tracked::numAlive == 0);
+
+			for (int i = 0; i < 100; i++)
+				trackedArray.Push(Tracked(i));
+
+			REQUIRE(trackedArray.GetCapacity() >= 100);
+			REQUIRE(Tracked::numAlive == 100);
+			REQUIRE(Tracked::numCopies == 0);
+
+			trackedArray.ShiftRemove(0);
+			trackedArray.QuickRemove(0);
+			trackedArray.ShiftInsert(5, Tracked(-1));
+			trackedArray.QuickInsert(0, Tracked(-2));
+			REQUIRE(Tracked::numAlive == 100);
+			REQUIRE(Tracked::numCopies == 0);
+			REQUIRE(trackedArray[0].value == -2);
+			REQUIRE(trackedArray[5].value == -1);
+			REQUIRE(trackedArray[trackedArray.GetSize() - 1].value == 99);
+
+			trackedArray.SetSize(10);
+			REQUIRE(Tracked::numAlive == 10);
+
+			DArray<Tracked> trackedArrayCopy(trackedArray);
+			REQUIRE(Tracked::numAlive == 20);
+			REQUIRE(Tracked::numCopies == 10);
+
+			trackedArrayCopy = DArray<Tracked>();
+			REQUIRE(Tracked::numAlive == 10);
+		}
+
+		REQUIRE(Tracked::numAlive == 0);
+	}
+
+	SECTION("Test sort.")
 	{
 		array.SetSize(0);
 		for (int i = 0; i < 10; i++)
@@ -85,6 +151,116 @@ TEST_CASE("Dynamic Arrays", "[darray]")
 		}
 	}
 
+	SECTION("Test sorting patterns.")
+	{
+		auto predicate = [](int intA, int intB) -> int
+		{
+			if (intA < intB)
+				return -1;
+			else if (intA > intB)
+				return 1;
+			return 0;
+		};
+
+		XorShiftRandom random;
+		random.SetSeed(1234);
+
+		for (int pattern = 0; pattern < 6; pattern++)
+		{
+			const int size = 10000;
+			array.SetSize(0);
+			for (int i = 0; i < size; i++)
+			{
+				switch (pattern)
+				{
+				case 0: array.Push(int(random.GetRandomInteger(0, 1000000))); break;
+				case 1: array.Push(i); break;
+				case 2: array.Push(size - i); break;
+				case 3: array.Push(7); break;
+				case 4: array.Push(int(random.GetRandomInteger(0, 3))); break;
+				case 5: array.Push(i < size / 2 ? i : size - i); break;
+				}
+			}
+
+			long long sum = 0;
+			for (int i = 0; i < size; i++)
+				sum += array[i];
+
+			DArray<int> stableArray(array);
+			array.Sort(predicate);
+			stableArray.StableSort(predicate);
+
+			for (int i = 0; i < size; i++)
+			{
+				sum -= array[i];
+				REQUIRE(array[i] == stableArray[i]);
+				if (i > 0)
+					REQUIRE(array[i - 1] <= array[i]);
+			}
+
+			REQUIRE(sum == 0);
+		}
+	}
+
+	SECTION("Test stable sort.")
+	{
+		Tracked::numAlive = 0;
+		Tracked::numCopies = 0;
+
+		{
+			DArray<Tracked> trackedArray;
+			for (int i = 0; i < 1000; i++)
+				trackedArray.Push(Tracked(i));
+
+			XorShiftRandom random;
+			random.SetSeed(4321);
+			random.Shuffle(trackedArray.GetBuffer(), trackedArray.GetSize());
+			Tracked::numCopies = 0;
+
+			// Sort only on the last digit, then check that the rest is still in its original relative order.
+			trackedArray.Sort([](const Tracked& trackedA, const Tracked& trackedB) -> int
+				{
+					return trackedA.value > trackedB.value;
+				});
+
+			trackedArray.StableSort([](const Tracked& trackedA, const Tracked& trackedB) -> int
+				{
+					return trackedA.value % 10 - trackedB.value % 10;
+				});
+
+			REQUIRE(Tracked::numAlive == 1000);
+			REQUIRE(Tracked::numCopies == 0);
+
+			for (int i = 0; i < 1000; i++)
+				REQUIRE(trackedArray[i].value == (i % 100) * 10 + i / 100);
+		}
+
+		REQUIRE(Tracked::numAlive == 0);
+	}
+
+	SECTION("Test parallel sort.")
+	{
+		XorShiftRandom random;
+		random.SetSeed(5678);
+
+		array.SetSize(0);
+		for (int i = 0; i < 1000000; i++)
+			array.Push(int(random.GetRandomInteger(0, 0x7FFFFFFF)));
+
+		DArray<int> sortedArray(array);
+
+		auto predicate = [](int intA, int intB) -> int
+		{
+			return intA > intB;
+		};
+
+		ParallelSort(array, predicate);
+		sortedArray.Sort(predicate);
+
+		for (unsigned int i = 0; i < array.GetSize(); i++)
+			REQUIRE(array[i] == sortedArray[i]);
+	}
+
 	SECTION("Test heap sort.")
 	{
 		array.SetSize(0);
@@ -125,4 +301,68 @@ TEST_CASE("Dynamic Arrays", "[darray]")
 			REQUIRE(i == array[i]);
 		}
 	}
+}
+
+// This is hidden by default.  Run it with the "[benchmark]" tag, preferably in a release build.
+TEST_CASE("Dynamic Array Indexing", "[darray][benchmark][.]")
+{
+	DArray<int> array;
+	for (int i = 0; i < 1 << 20; i++)
+		array.Push(i & 0xFF);
+
+	const DArray<int>& constArray = array;
+
+	BENCHMARK("Sum with modulo indexing (the old operator[])")
+	{
+		const int* buffer = constArray.GetBuffer();
+		unsigned int size = constArray.GetSize();
+		int sum = 0;
+		for (unsigned int i = 0; i < size; i++)
+			sum += buffer[i % size];
+		return sum;
+	};
+
+	BENCHMARK("Sum with operator[]")
+	{
+		int sum = 0;
+		for (unsigned int i = 0; i < constArray.GetSize(); i++)
+			sum += constArray[i];
+		return sum;
+	};
+}
+
+// This is hidden by default.  Run it with the "[benchmark]" tag, preferably in a release build.
+TEST_CASE("Dynamic Array Sorting", "[darray][benchmark][.]")
+{
+	DArray<int> randomArray;
+	XorShiftRandom random;
+	random.SetSeed(1234);
+	for (int i = 0; i < 1000000; i++)
+		randomArray.Push(int(random.GetRandomInteger(0, 0x7FFFFFFF)));
+
+	auto predicate = [](int intA, int intB) -> int
+	{
+		return intA > intB;
+	};
+
+	BENCHMARK("Sort 1M integers")
+	{
+		DArray<int> array(randomArray);
+		array.Sort(predicate);
+		return array[0];
+	};
+
+	BENCHMARK("Stable sort 1M integers")
+	{
+		DArray<int> array(randomArray);
+		array.StableSort(predicate);
+		return array[0];
+	};
+
+	BENCHMARK("Parallel sort 1M integers")
+	{
+		DArray<int> array(randomArray);
+		ParallelSort(array, predicate);
+		return array[0];
+	};
 }
\ No newline at end of file
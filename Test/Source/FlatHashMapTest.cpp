@@ -0,0 +1,101 @@
+#include "UltraUtilities/Containers/FlatHashMap.hpp"
+#include "UltraUtilities/Containers/HashSet.hpp"
+#include "UltraUtilities/String.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace UU;
+
+TEST_CASE("Flat Hash Maps", "[FlatHashMap]")
+{
+	FlatHashMap<int, int> map;
+
+	REQUIRE(map.GetNumPairs() == 0);
+
+	SECTION("Test basic insertion and clearing.")
+	{
+		for (unsigned int i = 0; i < 10; i++)
+		{
+			map.Insert(i, 2 * i);
+			REQUIRE(map.GetNumPairs() == i + 1);
+		}
+
+		map.Insert(3, 7);
+		REQUIRE(map.GetNumPairs() == 10);
+		REQUIRE(map[3] == 7);
+
+		map.Clear();
+		REQUIRE(map.GetNumPairs() == 0);
+		REQUIRE(!map.Find(3));
+	}
+
+	SECTION("Test search and removal with growth.")
+	{
+		unsigned int numPairs = 10000;
+		for (int i = 0; i < (int)numPairs; i++)
+			map.Insert(i * 7, i);
+
+		REQUIRE(map.GetNumPairs() == numPairs);
+		REQUIRE(map.GetCapacity() >= numPairs);
+
+		for (int i = 0; i < (int)numPairs; i++)
+		{
+			int j = -1;
+			REQUIRE(map.Find(i * 7, &j));
+			REQUIRE(j == i);
+			REQUIRE(!map.Find(i * 7 + 1));
+		}
+
+		for (int i = 0; i < (int)numPairs; i += 2)
+		{
+			int j = -1;
+			REQUIRE(map.Remove(i * 7, &j));
+			REQUIRE(j == i);
+		}
+
+		REQUIRE(map.GetNumPairs() == numPairs / 2);
+
+		for (int i = 0; i < (int)numPairs; i++)
+		{
+			int* value = nullptr;
+			bool found = map.FindPtr(i * 7, value);
+			REQUIRE(found == (i % 2 == 1));
+			if (found)
+				REQUIRE(*value == i);
+		}
+	}
+
+	SECTION("Ranged for-loop.")
+	{
+		for (int i = 0; i < 100; i++)
+			map.Insert(i, 2 * i);
+
+		HashSet<int> visitedSet;
+		for (auto pair : map)
+		{
+			REQUIRE(pair.value == pair.key * 2);
+			REQUIRE(!visitedSet.Find(pair.key));
+			visitedSet.Insert(pair.key);
+		}
+
+		REQUIRE(visitedSet.GetNumKeys() == 100);
+	}
+
+	SECTION("String keys and copying.")
+	{
+		FlatHashMap<String, int> stringMap;
+		stringMap.Insert("apple", 1);
+		stringMap.Insert("banana", 2);
+		stringMap.Insert("cherry", 3);
+		REQUIRE(stringMap.GetNumPairs() == 3);
+
+		FlatHashMap<String, int> stringMapCopy(stringMap);
+		REQUIRE(stringMap.Remove("banana"));
+		REQUIRE(!stringMap.Find("banana"));
+		REQUIRE(stringMapCopy.GetNumPairs() == 3);
+		REQUIRE(stringMapCopy["banana"] == 2);
+		REQUIRE(stringMapCopy["cherry"] == 3);
+
+		// Strings are hashed once, at full width.
+		REQUIRE(FlatHashMapHasher<String>::Hash("banana") == HashBytes("banana", 6));
+	}
+}
\ No newline at end of file
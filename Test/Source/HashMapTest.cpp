@@ -39,12 +39,68 @@ TEST_CASE("Hash Maps", "[HashMap]")
 		for (int i = 0; i < 10; i++)
 			map.Insert(i, 2 * i);
 
-		int i = 0;
+		// The table may be mid-rehash here, so iteration order is not key order.
+		HashMap<int, int> visitedMap;
 		for (auto pair : map)
 		{
-			REQUIRE(pair.key == i);
-			REQUIRE(pair.value == i * 2);
-			i++;
+			REQUIRE(pair.value == pair.key * 2);
+			REQUIRE(!visitedMap.Find(pair.key));
+			visitedMap.Insert(pair.key, pair.value);
 		}
+
+		REQUIRE(visitedMap.GetNumPairs() == 10);
+	}
+
+	SECTION("Test growing and shrinking.")
+	{
+		unsigned int numPairs = 10000;
+		for (int i = 0; i < (int)numPairs; i++)
+			map.Insert(i, 2 * i);
+
+		REQUIRE(map.GetNumPairs() == numPairs);
+		REQUIRE(map.GetHashTable().GetTableSize() >= numPairs / 2);
+		REQUIRE(map.GetHashTable().GetLoadFactor() <= map.GetHashTable().GetMaxLoadFactor());
+
+		for (int i = 0; i < (int)numPairs; i++)
+		{
+			int j = -1;
+			REQUIRE(map.Find(i, &j));
+			REQUIRE(j == 2 * i);
+		}
+
+		for (int i = 0; i < (int)numPairs - 10; i++)
+			REQUIRE(map.Remove(i));
+
+		REQUIRE(map.GetNumPairs() == 10);
+		REQUIRE(map.GetHashTable().GetTableSize() < 64);
+
+		for (int i = (int)numPairs - 10; i < (int)numPairs; i++)
+			REQUIRE(map.Find(i));
+	}
+
+	SECTION("Test reserving.")
+	{
+		map.SetMaxLoadFactor(0.5);
+		map.Reserve(1000);
+		unsigned int tableSize = map.GetHashTable().GetTableSize();
+		REQUIRE(tableSize >= 2000);
+
+		// The nearly empty table must not shrink away from the reserved size.
+		map.Insert(0, 0);
+		REQUIRE(map.GetHashTable().GetTableSize() == tableSize);
+		REQUIRE(!map.GetHashTable().IsRehashing());
+
+		for (int i = 1; i < 1000; i++)
+		{
+			map.Insert(i, i);
+			REQUIRE(map.GetHashTable().GetTableSize() == tableSize);
+			REQUIRE(!map.GetHashTable().IsRehashing());
+		}
+
+		// Removal may shrink the table, but not below the reserved size.
+		for (int i = 0; i < 1000; i++)
+			map.Remove(i);
+
+		REQUIRE(map.GetHashTable().GetTableSize() == tableSize);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,70 @@
+#include "UltraUtilities/Hash.h"
+#include "UltraUtilities/String.h"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace UU;
+
+TEST_CASE("Hashing", "[hash]")
+{
+	DArray<unsigned char> byteArray;
+	for (unsigned int i = 0; i < 1100; i++)
+		byteArray.Push((unsigned char)((i * 131) ^ (i >> 3)));
+
+	SECTION("Byte hashes do not depend on alignment.")
+	{
+		DArray<unsigned char> shiftedArray;
+		shiftedArray.Push(0);
+		for (unsigned int i = 0; i < byteArray.GetSize(); i++)
+			shiftedArray.Push(byteArray[i]);
+
+		for (unsigned int size = 0; size < 1024; size += 7)
+			REQUIRE(HashBytes(byteArray.GetBuffer(), size) == HashBytes(shiftedArray.GetBuffer() + 1, size));
+	}
+
+	SECTION("Byte hashes depend on every byte, the size and the seed.")
+	{
+		unsigned int sizeArray[] = { 1, 3, 4, 7, 8, 9, 16, 17, 31, 64, 128, 129, 200, 512, 513, 1100 };
+		for (unsigned int size : sizeArray)
+		{
+			unsigned long long hash = HashBytes(byteArray.GetBuffer(), size);
+			REQUIRE(hash != HashBytes(byteArray.GetBuffer(), size - 1));
+			REQUIRE(hash != HashBytes(byteArray.GetBuffer(), size, 1));
+
+			for (unsigned int i = 0; i < size; i++)
+			{
+				byteArray[i] ^= 0x10;
+				REQUIRE(hash != HashBytes(byteArray.GetBuffer(), size));
+				byteArray[i] ^= 0x10;
+			}
+
+			REQUIRE(hash == HashBytes(byteArray.GetBuffer(), size));
+		}
+	}
+
+	SECTION("Strided integer keys spread evenly over a power-of-two table.")
+	{
+		unsigned int tableSize = 1024;
+		DArray<unsigned int> countArray(tableSize);
+		for (unsigned int i = 0; i < tableSize; i++)
+			countArray[i] = 0;
+
+		for (unsigned int i = 0; i < tableSize * 16; i++)
+			countArray[HashToIndex(HashInteger(i * tableSize), tableSize)]++;
+
+		for (unsigned int i = 0; i < tableSize; i++)
+		{
+			REQUIRE(countArray[i] > 0);
+			REQUIRE(countArray[i] < 48);
+		}
+	}
+
+	SECTION("String hashes agree with the raw bytes.")
+	{
+		String stringA("The quick brown fox jumps over the lazy dog.");
+		String stringB(stringA);
+		REQUIRE(String::Hash(stringA, 4096) == String::Hash(stringB, 4096));
+		REQUIRE(HashString(stringA) == HashBytes((const char*)stringA, stringA.Length()));
+		REQUIRE(HashString("") != HashString("a"));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include "UltraUtilities/Memory/ObjectHeap.hpp"
+#include "UltraUtilities/Containers/HashMap.hpp"
+#include "UltraUtilities/Containers/HashSet.hpp"
+#include "UltraUtilities/Containers/RBMap.hpp"
+#include "UltraUtilities/Containers/RBSet.hpp"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Random.h"
+#include "UltraUtilities/Threading/Thread.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace UU;
+
+namespace
+{
+	class Thing
+	{
+	public:
+		Thing() : value(7) { numAlive++; }
+		~Thing() { numAlive--; }
+
+		double padding[3];
+		int value;
+
+		static int numAlive;
+	};
+
+	int Thing::numAlive = 0;
+
+	// This is like a thing, but doesn't keep count, so that it can be made on any thread.
+	class Piece
+	{
+	public:
+		Piece() : value(7) {}
+
+		double padding[3];
+		int value;
+	};
+
+	// This is made on a thread before the thread's heap cache, so it's destroyed after the cache is gone,
+	// and has to free its piece, and make and free another, without any cache.
+	class PieceHolder
+	{
+	public:
+		PieceHolder() : piece(nullptr) {}
+
+		~PieceHolder()
+		{
+			ThreadCachingObjectHeap<Piece> heap;
+			bool freed = heap.Deallocate(this->piece);
+			Piece* otherPiece = heap.Allocate();
+			freedWithoutCache = freed && otherPiece && otherPiece->value == 7 && heap.Deallocate(otherPiece);
+		}
+
+		Piece* piece;
+
+		static bool freedWithoutCache;
+	};
+
+	bool PieceHolder::freedWithoutCache = false;
+}
+
+TEST_CASE("Slab Object Heaps", "[ObjectHeap]")
+{
+	SECTION("Test allocation and deallocation.")
+	{
+		SlabObjectHeap<Thing, 4096> heap;
+		REQUIRE(heap.GetNumSlabs() == 0);
+
+		unsigned int numObjects = 10 * SlabObjectHeap<Thing, 4096>::GetObjectsPerSlab() + 3;
+		DArray<Thing*> thingArray;
+		for (unsigned int i = 0; i < numObjects; i++)
+		{
+			Thing* thing = heap.Allocate();
+			REQUIRE(thing != nullptr);
+			REQUIRE(thing->value == 7);
+			REQUIRE(((unsigned long long)thing % alignof(Thing)) == 0);
+			thing->value = int(i);
+			thingArray.Push(thing);
+		}
+
+		REQUIRE(Thing::numAlive == int(numObjects));
+		REQUIRE(heap.GetNumSlabs() == 11);
+
+		// Nothing should have been overwritten.
+		for (unsigned int i = 0; i < numObjects; i++)
+			REQUIRE(thingArray[i]->value == int(i));
+
+		XorShiftRandom random;
+		random.SetSeed(1234);
+		random.Shuffle(thingArray.GetBuffer(), thingArray.GetSize());
+
+		Thing* thing = nullptr;
+		for (unsigned int i = 0; i < numObjects / 2; i++)
+		{
+			REQUIRE(thingArray.Pop(&thing));
+			REQUIRE(heap.Deallocate(thing));
+		}
+
+		// Freed slots should be reused before any new slab is made.
+		unsigned int numSlabs = heap.GetNumSlabs();
+		for (unsigned int i = 0; i < numObjects / 2; i++)
+			thingArray.Push(heap.Allocate());
+		REQUIRE(heap.GetNumSlabs() <= numSlabs);
+
+		while (thingArray.Pop(&thing))
+			REQUIRE(heap.Deallocate(thing));
+
+		REQUIRE(Thing::numAlive == 0);
+		REQUIRE(heap.GetNumSlabs() == 1);
+
+		SlabObjectHeap<Thing, 4096> otherHeap;
+		thing = otherHeap.Allocate();
+		REQUIRE(!heap.Deallocate(thing));
+		REQUIRE(otherHeap.Deallocate(thing));
+	}
+
+	SECTION("Test with hash maps.")
+	{
+		HashMap<int, int, SlabObjectHeap<HashMapNode<int>>, SlabObjectHeap<HashMapKey<int>>> map;
+
+		for (int i = 0; i < 10000; i++)
+			REQUIRE(map.Insert(i, -i));
+
+		for (int i = 0; i < 10000; i += 2)
+			REQUIRE(map.Remove(i));
+
+		REQUIRE(map.GetNumPairs() == 5000);
+
+		for (int i = 0; i < 10000; i++)
+			REQUIRE(map.Find(i) == (i % 2 == 1));
+
+		map.Clear();
+		REQUIRE(map.GetNumPairs() == 0);
+
+		for (int i = 0; i < 100; i++)
+			REQUIRE(map.Insert(i, i));
+	}
+
+	SECTION("Test with hash sets.")
+	{
+		HashSet<int, SlabObjectHeap<HashTableNode>, SlabObjectHeap<HashMapKey<int>>> set;
+
+		for (int i = 0; i < 10000; i++)
+			REQUIRE(set.Insert(i));
+
+		for (int i = 0; i < 10000; i += 3)
+			REQUIRE(set.Remove(i));
+
+		for (int i = 0; i < 10000; i++)
+			REQUIRE(set.Find(i) == (i % 3 != 0));
+	}
+
+	SECTION("Test with red/black maps and sets.")
+	{
+		RBMap<int, int, SlabObjectHeap<RBMapNode<int>>, SlabObjectHeap<RBMapKey<int>>> map;
+		RBSet<int, SlabObjectHeap<RBTreeNode>, SlabObjectHeap<RBMapKey<int>>> set;
+
+		for (int i = 0; i < 5000; i++)
+		{
+			REQUIRE(map.Insert(i, -i));
+			REQUIRE(set.Insert(i));
+		}
+
+		for (int i = 0; i < 5000; i += 2)
+		{
+			REQUIRE(map.Remove(i));
+			REQUIRE(set.Remove(i));
+		}
+
+		REQUIRE(map.GetTree().IsBinaryTree());
+		REQUIRE(set.GetTree().IsBinaryTree());
+
+		for (int i = 0; i < 5000; i++)
+		{
+			int value = 0;
+			REQUIRE(map.Find(i, &value) == (i % 2 == 1));
+			if (i % 2 == 1)
+				REQUIRE(value == -i);
+			REQUIRE(set.Find(i) == (i % 2 == 1));
+		}
+
+		map.Clear();
+		REQUIRE(map.GetNumPairs() == 0);
+	}
+}
+
+TEST_CASE("Thread-Caching Object Heaps", "[ObjectHeap]")
+{
+	const int numThreads = 4;
+
+	SECTION("Test allocation and deallocation across threads.")
+	{
+		const int numObjects = 20000;
+		DArray<Piece*> thingArray[numThreads];
+		bool ok[numThreads];
+
+		// Each thread allocates its own objects, frees half of them, and hands the rest to its neighbor.
+		auto allocate = [&thingArray, &ok](int i)
+		{
+			ThreadCachingObjectHeap<Piece> heap;
+			ok[i] = true;
+			for (int j = 0; j < numObjects; j++)
+			{
+				Piece* thing = heap.Allocate();
+				ok[i] = ok[i] && thing && thing->value == 7;
+				thing->value = i * numObjects + j;
+				thingArray[i].Push(thing);
+			}
+
+			for (int j = 0; j < numObjects; j += 2)
+			{
+				ok[i] = ok[i] && thingArray[i][j]->value == i * numObjects + j;
+				heap.Deallocate(thingArray[i][j]);
+				thingArray[i][j] = nullptr;
+			}
+		};
+
+		auto deallocate = [&thingArray, &ok](int i)
+		{
+			ThreadCachingObjectHeap<Piece> heap;
+			int k = (i + 1) % numThreads;
+			for (int j = 1; j < numObjects; j += 2)
+			{
+				ok[i] = ok[i] && thingArray[k][j]->value == k * numObjects + j;
+				heap.Deallocate(thingArray[k][j]);
+			}
+		};
+
+		{
+			DArray<Thread*> threadArray;
+			for (int i = 0; i < numThreads; i++)
+			{
+				auto func = [&allocate, i]() { allocate(i); };
+				threadArray.Push(new LambdaThread<decltype(func)>(func));
+			}
+			for (Thread* thread : threadArray)
+				REQUIRE(thread->Start());
+			for (Thread* thread : threadArray)
+				delete thread;
+		}
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+
+		{
+			DArray<Thread*> threadArray;
+			for (int i = 0; i < numThreads; i++)
+			{
+				auto func = [&deallocate, i]() { deallocate(i); };
+				threadArray.Push(new LambdaThread<decltype(func)>(func));
+			}
+			for (Thread* thread : threadArray)
+				REQUIRE(thread->Start());
+			for (Thread* thread : threadArray)
+				delete thread;
+		}
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+	}
+
+	SECTION("Test freeing after a thread's cache is gone.")
+	{
+		auto func = []()
+		{
+			static thread_local PieceHolder holder;
+			ThreadCachingObjectHeap<Piece> heap;
+			holder.piece = heap.Allocate();
+		};
+
+		Thread* thread = new LambdaThread<decltype(func)>(func);
+		REQUIRE(thread->Start());
+		delete thread;
+
+		REQUIRE(PieceHolder::freedWithoutCache);
+
+		// The depot should still be fine for everyone else.
+		ThreadCachingObjectHeap<Piece> heap;
+		Piece* piece = heap.Allocate();
+		REQUIRE(piece != nullptr);
+		REQUIRE(heap.Deallocate(piece));
+	}
+
+	SECTION("Test with a hash map per thread.")
+	{
+		typedef HashMap<int, int, ThreadCachingObjectHeap<HashMapNode<int>>, ThreadCachingObjectHeap<HashMapKey<int>>> Map;
+		bool ok[numThreads];
+
+		auto populate = [&ok](int i)
+		{
+			Map map;
+			for (int j = 0; j < 10000; j++)
+				map.Insert(j, i + j);
+
+			for (int j = 0; j < 10000; j += 2)
+				map.Remove(j);
+
+			ok[i] = map.GetNumPairs() == 5000;
+			for (int j = 0; j < 10000; j++)
+			{
+				int value = 0;
+				bool found = map.Find(j, &value);
+				ok[i] = ok[i] && found == (j % 2 == 1) && (!found || value == i + j);
+			}
+		};
+
+		DArray<Thread*> threadArray;
+		for (int i = 0; i < numThreads; i++)
+		{
+			auto func = [&populate, i]() { populate(i); };
+			threadArray.Push(new LambdaThread<decltype(func)>(func));
+		}
+		for (Thread* thread : threadArray)
+			REQUIRE(thread->Start());
+		for (Thread* thread : threadArray)
+			delete thread;
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+	}
+}
\ No newline at end of file
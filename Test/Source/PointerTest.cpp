@@ -0,0 +1,149 @@
+#include "UltraUtilities/Memory/Pointer.hpp"
+#include "UltraUtilities/Containers/DArray.hpp"
+#include "UltraUtilities/Threading/Thread.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace UU;
+
+namespace
+{
+	class Base
+	{
+	public:
+		Base(int value) : value(value) { numAlive.FetchAdd(1); }
+		virtual ~Base() { numAlive.FetchSub(1); }
+
+		int value;
+
+		static Atomic<int> numAlive;
+	};
+
+	Atomic<int> Base::numAlive;
+
+	class Derived : public Base
+	{
+	public:
+		Derived(int value, int otherValue) : Base(value), otherValue(otherValue) {}
+
+		int otherValue;
+	};
+}
+
+TEST_CASE("Shared and Weak Pointers", "[pointer]")
+{
+	REQUIRE(Base::numAlive.Load() == 0);
+
+	SECTION("Test making, copying and releasing.")
+	{
+		SharedPtr<Base> sharedPtrA = SharedPtr<Base>::Make(3);
+		REQUIRE(Base::numAlive.Load() == 1);
+		REQUIRE(sharedPtrA->value == 3);
+		REQUIRE(sharedPtrA.GetRefCount() == 1);
+
+		{
+			SharedPtr<Base> sharedPtrB(sharedPtrA);
+			REQUIRE(sharedPtrA.GetRefCount() == 2);
+			REQUIRE(sharedPtrB.Get() == sharedPtrA.Get());
+
+			SharedPtr<Base> sharedPtrC;
+			sharedPtrC = sharedPtrB;
+			sharedPtrC = sharedPtrC;
+			REQUIRE(sharedPtrA.GetRefCount() == 3);
+
+			SharedPtr<Base> sharedPtrD(static_cast<SharedPtr<Base>&&>(sharedPtrC));
+			REQUIRE(sharedPtrC.Get() == nullptr);
+			REQUIRE(sharedPtrA.GetRefCount() == 3);
+		}
+
+		REQUIRE(sharedPtrA.GetRefCount() == 1);
+		REQUIRE(Base::numAlive.Load() == 1);
+
+		sharedPtrA = SharedPtr<Base>::Make(4);
+		REQUIRE(Base::numAlive.Load() == 1);
+		REQUIRE(sharedPtrA->value == 4);
+
+		sharedPtrA.Reset();
+		REQUIRE(sharedPtrA.Get() == nullptr);
+		REQUIRE(sharedPtrA.GetRefCount() == 0);
+		REQUIRE(Base::numAlive.Load() == 0);
+	}
+
+	SECTION("Test conversion to a base class.")
+	{
+		DArray<SharedPtr<Base>> baseArray;
+		SharedPtr<Derived> derivedPtr = SharedPtr<Derived>::Make(1, 2);
+		baseArray.Push(derivedPtr);
+		baseArray.Push(SharedPtr<Base>::Make(5));
+		REQUIRE(derivedPtr.GetRefCount() == 2);
+		REQUIRE(baseArray[0]->value == 1);
+		REQUIRE(baseArray[0].Get() == derivedPtr.Get());
+
+		derivedPtr.Reset();
+		REQUIRE(Base::numAlive.Load() == 2);
+		baseArray.SetSize(0);
+		REQUIRE(Base::numAlive.Load() == 0);
+	}
+
+	SECTION("Test weak pointers.")
+	{
+		WeakPtr<Base> weakPtr;
+		REQUIRE(weakPtr.IsExpired());
+		REQUIRE(weakPtr.Get().Get() == nullptr);
+
+		{
+			SharedPtr<Base> sharedPtr = SharedPtr<Base>::Make(7);
+			weakPtr = sharedPtr;
+			REQUIRE(!weakPtr.IsExpired());
+
+			SharedPtr<Base> otherSharedPtr = weakPtr.Get();
+			REQUIRE(otherSharedPtr.Get() == sharedPtr.Get());
+			REQUIRE(sharedPtr.GetRefCount() == 2);
+		}
+
+		// The object is gone, but the weak pointer can still safely tell us so.
+		REQUIRE(Base::numAlive.Load() == 0);
+		REQUIRE(weakPtr.IsExpired());
+		REQUIRE(weakPtr.Get().Get() == nullptr);
+	}
+
+	SECTION("Test sharing between threads.")
+	{
+		const int numThreads = 4;
+		const int numIterations = 20000;
+
+		SharedPtr<Base> sharedPtr = SharedPtr<Base>::Make(9);
+		WeakPtr<Base> weakPtr(sharedPtr);
+		bool ok[numThreads];
+
+		auto func = [&sharedPtr, &weakPtr, &ok](int i)
+		{
+			ok[i] = true;
+			for (int j = 0; j < numIterations; j++)
+			{
+				SharedPtr<Base> copyPtr(sharedPtr);
+				SharedPtr<Base> lockedPtr = weakPtr.Get();
+				WeakPtr<Base> otherWeakPtr(copyPtr);
+				ok[i] = ok[i] && copyPtr->value == 9 && lockedPtr.Get() == copyPtr.Get();
+			}
+		};
+
+		DArray<Thread*> threadArray;
+		for (int i = 0; i < numThreads; i++)
+		{
+			auto threadFunc = [&func, i]() { func(i); };
+			threadArray.Push(new LambdaThread<decltype(threadFunc)>(threadFunc));
+		}
+		for (Thread* thread : threadArray)
+			REQUIRE(thread->Start());
+		for (Thread* thread : threadArray)
+			delete thread;
+
+		for (int i = 0; i < numThreads; i++)
+			REQUIRE(ok[i]);
+
+		REQUIRE(sharedPtr.GetRefCount() == 1);
+		sharedPtr.Reset();
+		REQUIRE(weakPtr.IsExpired());
+		REQUIRE(Base::numAlive.Load() == 0);
+	}
+}
\ No newline at end of file